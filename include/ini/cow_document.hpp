@@ -0,0 +1,243 @@
+#pragma once
+
+#include <functional>
+#include <ini/internal/common.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace gal::ini
+{
+	/**
+	 * @brief A copy-on-write document, copying a document is O(1) and a modification only copies what it touches.
+	 * The groups are shared between the copies of a document, the first modification of a group in a copy copies that group (and, once per copy, the table of the groups),
+	 * so staging many candidate modifications costs memory proportional to the touched groups.
+	 * @tparam Char Character type of the data.
+	 * @note It can be flushed (flush_to_file/flush_to_user) and compared (diff) like any other ContextType.
+	 * @note Copies can be used by different threads, a single document must not be modified while it is read.
+	 */
+	template<typename Char>
+	class CowDocument
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+	private:
+		struct string_hasher
+		{
+			using is_transparent = int;
+
+			[[nodiscard]] auto operator()(const string_view_type string) const noexcept -> std::size_t { return std::hash<string_view_type>{}(string); }
+		};
+
+	public:
+		using key_type = string_type;
+		using mapped_type = std::unordered_map<string_type, string_type, string_hasher, std::equal_to<>>;
+		using size_type = std::size_t;
+
+	private:
+		struct group_node
+		{
+			// The table of the groups refers to it.
+			string_type name;
+			mapped_type values;
+		};
+
+		// name => group, shared by the copies of the document until one of them modifies it.
+		using table_type = std::unordered_map<string_view_type, std::shared_ptr<group_node>>;
+
+		std::shared_ptr<table_type> table_;
+
+		// The table owned by this document only.
+		auto mutable_table() -> table_type&
+		{
+			if (table_ == nullptr) { table_ = std::make_shared<table_type>(); }
+			// This document is the only owner, no one else can share it meanwhile.
+			else if (table_.use_count() != 1) { table_ = std::make_shared<table_type>(*table_); }
+			return *table_;
+		}
+
+		// The group owned by this document only (created if it does not exist).
+		auto mutable_group(const string_view_type group_name) -> mapped_type&
+		{
+			auto& table = mutable_table();
+
+			auto it = table.find(group_name);
+			if (it == table.end())
+			{
+				auto node = std::make_shared<group_node>(group_node{.name = string_type{group_name}, .values = {}});
+				it        = table.emplace(node->name, std::move(node)).first;
+			}
+			else if (it->second.use_count() != 1)
+			{
+				auto node = std::make_shared<group_node>(*it->second);
+				// the key refers to the name of the shared node
+				table.erase(it);
+				it = table.emplace(node->name, std::move(node)).first;
+			}
+
+			return it->second->values;
+		}
+
+	public:
+		// The proxy of a (group name, group) pair.
+		struct value_reference
+		{
+			const key_type&    first;
+			const mapped_type& second;
+
+			[[nodiscard]] auto operator->() const noexcept -> const value_reference* { return this; }
+		};
+
+		class const_iterator
+		{
+			friend CowDocument;
+
+			typename table_type::const_iterator it_;
+
+			explicit const_iterator(typename table_type::const_iterator it) noexcept
+				: it_{it} {}
+
+		public:
+			using value_type = value_reference;
+			using reference = value_reference;
+			using difference_type = std::ptrdiff_t;
+
+			const_iterator() noexcept = default;
+
+			[[nodiscard]] auto operator*() const noexcept -> reference { return {it_->second->name, it_->second->values}; }
+
+			[[nodiscard]] auto operator->() const noexcept -> reference { return **this; }
+
+			auto operator++() noexcept -> const_iterator&
+			{
+				++it_;
+				return *this;
+			}
+
+			auto operator++(int) noexcept -> const_iterator
+			{
+				auto copy = *this;
+				++it_;
+				return copy;
+			}
+
+			[[nodiscard]] auto operator==(const const_iterator& other) const noexcept -> bool = default;
+		};
+
+		using iterator = const_iterator;
+
+		CowDocument() = default;
+
+		/**
+		 * @brief Copy the data (deep copy, once).
+		 * @tparam ContextType Type of the data (any ContextType accepted by the extractor).
+		 * @param context The data.
+		 */
+		template<typename ContextType>
+			requires(!std::is_same_v<ContextType, CowDocument>)
+		explicit CowDocument(const ContextType& context)
+		{
+			for (const auto& [group_name, group]: context)
+			{
+				auto& values = mutable_group(string_view_type{group_name});
+				for (const auto& [key, value]: group) { values.emplace(string_view_type{key}, string_view_type{value}); }
+			}
+		}
+
+		// O(1), an explicit alias of the copy constructor.
+		[[nodiscard]] auto clone() const -> CowDocument { return *this; }
+
+		[[nodiscard]] auto size() const noexcept -> size_type { return table_ == nullptr ? 0 : table_->size(); }
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return size() == 0; }
+
+		[[nodiscard]] auto begin() const noexcept -> const_iterator { return table_ == nullptr ? const_iterator{} : const_iterator{table_->cbegin()}; }
+
+		[[nodiscard]] auto end() const noexcept -> const_iterator { return table_ == nullptr ? const_iterator{} : const_iterator{table_->cend()}; }
+
+		[[nodiscard]] auto find(const string_view_type group_name) const -> const_iterator
+		{
+			if (table_ == nullptr) { return end(); }
+			return const_iterator{table_->find(group_name)};
+		}
+
+		[[nodiscard]] auto contains(const string_view_type group_name) const -> bool { return table_ != nullptr && table_->contains(group_name); }
+
+		// The group, or nullptr if the group does not exist.
+		[[nodiscard]] auto group(const string_view_type group_name) const -> const mapped_type*
+		{
+			if (const auto it = find(group_name);
+				it != end()) { return &it->second; }
+			return nullptr;
+		}
+
+		[[nodiscard]] auto get(const string_view_type group_name, const string_view_type key) const -> std::optional<string_view_type>
+		{
+			if (const auto* values = group(group_name);
+				values != nullptr)
+			{
+				if (const auto it = values->find(key);
+					it != values->end()) { return it->second; }
+			}
+			return std::nullopt;
+		}
+
+		// Whether both documents still share the (unmodified) group.
+		[[nodiscard]] auto shares(const CowDocument& other, const string_view_type group_name) const -> bool
+		{
+			if (table_ == nullptr || other.table_ == nullptr) { return false; }
+
+			const auto it       = table_->find(group_name);
+			const auto other_it = other.table_->find(group_name);
+			return it != table_->end() && other_it != other.table_->end() && it->second == other_it->second;
+		}
+
+		// Create the group if it does not exist.
+		auto add(const string_view_type group_name) -> void
+		{
+			if (!contains(group_name)) { (void)mutable_group(group_name); }
+		}
+
+		// Insert or assign the value (the group is created if it does not exist).
+		auto set(const string_view_type group_name, const string_view_type key, const string_view_type value) -> void
+		{
+			auto& values = mutable_group(group_name);
+			if (const auto it = values.find(key);
+				it != values.end()) { it->second = value; }
+			else { values.emplace(key, value); }
+		}
+
+		auto erase(const string_view_type group_name) -> bool
+		{
+			if (!contains(group_name)) { return false; }
+			return mutable_table().erase(group_name) != 0;
+		}
+
+		auto erase(const string_view_type group_name, const string_view_type key) -> bool
+		{
+			// do not copy the group if there is nothing to erase
+			if (const auto* values = group(group_name);
+				values == nullptr || !values->contains(key)) { return false; }
+
+			auto& values = mutable_group(group_name);
+			values.erase(values.find(key));
+			return true;
+		}
+	};
+
+	namespace common
+	{
+		// The temporary views built by the flusher.
+		template<typename Char>
+		struct map_type<CowDocument<Char>>
+		{
+			template<typename NewKey, typename NewValue>
+			using type = std::unordered_map<NewKey, NewValue>;
+		};
+	}// namespace common
+}// namespace gal::ini
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <ini/lazy_document.hpp>
+#include <vector>
+
+namespace gal::ini
+{
+	enum class DiffKind
+	{
+		// The whole group was added (its key-value pairs are not listed).
+		GROUP_ADDED,
+		// The whole group was removed (its key-value pairs are not listed).
+		GROUP_REMOVED,
+		KEY_ADDED,
+		KEY_REMOVED,
+		VALUE_CHANGED,
+	};
+
+	template<typename Char>
+	struct diff_entry
+	{
+		DiffKind kind;
+
+		string_view_t<Char> group;
+		// empty for GROUP_ADDED/GROUP_REMOVED
+		string_view_t<Char> key;
+		// empty for GROUP_ADDED/GROUP_REMOVED/KEY_ADDED
+		string_view_t<Char> old_value;
+		// empty for GROUP_ADDED/GROUP_REMOVED/KEY_REMOVED
+		string_view_t<Char> new_value;
+
+		[[nodiscard]] constexpr auto operator==(const diff_entry& other) const noexcept -> bool = default;
+	};
+
+	// The entries refer to the compared data, it must outlive the entries.
+	template<typename Char>
+	using diff_result_type = std::vector<diff_entry<Char>>;
+
+	namespace diff_detail
+	{
+		template<typename Map, typename StringView>
+		[[nodiscard]] auto find(const Map& map, const StringView key)
+		{
+			if constexpr (requires { map.find(key); }) { return map.find(key); }
+			else { return map.find(typename Map::key_type{key}); }
+		}
+
+		// Compare the key-value pairs of two groups with the same name.
+		template<typename Char, typename OldGroup, typename NewGroup>
+		auto diff_group(
+				const string_view_t<Char> group_name,
+				const OldGroup&           old_group,
+				const NewGroup&           new_group,
+				diff_result_type<Char>&   out) -> void
+		{
+			for (const auto& [key, value]: old_group)
+			{
+				const string_view_t<Char> key_view{key};
+				const string_view_t<Char> value_view{value};
+
+				if (const auto it = diff_detail::find(new_group, key_view);
+					it == new_group.end()) { out.push_back({.kind = DiffKind::KEY_REMOVED, .group = group_name, .key = key_view, .old_value = value_view, .new_value = {}}); }
+				else if (const string_view_t<Char> new_value{it->second};
+					new_value != value_view) { out.push_back({.kind = DiffKind::VALUE_CHANGED, .group = group_name, .key = key_view, .old_value = value_view, .new_value = new_value}); }
+			}
+
+			for (const auto& [key, value]: new_group)
+			{
+				const string_view_t<Char> key_view{key};
+
+				if (diff_detail::find(old_group, key_view) == old_group.end()) { out.push_back({.kind = DiffKind::KEY_ADDED, .group = group_name, .key = key_view, .old_value = {}, .new_value = string_view_t<Char>{value}}); }
+			}
+		}
+	}// namespace diff_detail
+
+	/**
+	 * @brief Compare two extracted contexts.
+	 * If the groups cache the hash of their content (`content_hash()`), groups with the same hash are skipped, otherwise the key-value pairs are compared directly.
+	 * @tparam OldContextType Type of the old data (any ContextType accepted by the extractor).
+	 * @tparam NewContextType Type of the new data (must have the same character type).
+	 * @param old_context The old data.
+	 * @param new_context The new data.
+	 * @return The changes, groups are listed in the iteration order of the old data, then added groups.
+	 */
+	template<typename OldContextType, typename NewContextType>
+	[[nodiscard]] auto diff(const OldContextType& old_context, const NewContextType& new_context) -> diff_result_type<typename string_view_t<typename OldContextType::key_type>::value_type>
+	{
+		using char_type = typename string_view_t<typename OldContextType::key_type>::value_type;
+		static_assert(std::is_same_v<char_type, typename string_view_t<typename NewContextType::key_type>::value_type>, "Both contexts must have the same character type!");
+
+		diff_result_type<char_type> result{};
+
+		for (const auto& [name, old_group]: old_context)
+		{
+			const string_view_t<char_type> name_view{name};
+
+			const auto it = diff_detail::find(new_context, name_view);
+			if (it == new_context.end())
+			{
+				result.push_back({.kind = DiffKind::GROUP_REMOVED, .group = name_view, .key = {}, .old_value = {}, .new_value = {}});
+				continue;
+			}
+
+			const auto& new_group = it->second;
+			// Only a hash cached by the group is worth comparing, hashing the pairs here would be a full pass over both groups, which is no cheaper than comparing them.
+			if constexpr (requires {
+				{ old_group.content_hash() } -> std::convertible_to<std::uint64_t>;
+				{ new_group.content_hash() } -> std::convertible_to<std::uint64_t>;
+			})
+			{
+				if (old_group.size() == new_group.size() && old_group.content_hash() == new_group.content_hash()) { continue; }
+			}
+
+			diff_detail::diff_group<char_type>(name_view, old_group, new_group, result);
+		}
+
+		for (const auto& [name, new_group]: new_context)
+		{
+			const string_view_t<char_type> name_view{name};
+
+			if (diff_detail::find(old_context, name_view) == old_context.end()) { result.push_back({.kind = DiffKind::GROUP_ADDED, .group = name_view, .key = {}, .old_value = {}, .new_value = {}}); }
+		}
+
+		return result;
+	}
+
+	/**
+	 * @brief Compare two lazy documents.
+	 * Groups with the same raw hash are skipped without being extracted, only changed groups are extracted and compared.
+	 * @tparam Char Character type of the documents.
+	 * @param old_document The old document.
+	 * @param new_document The new document.
+	 * @return The changes, groups are listed in the declaration order of the old document, then added groups.
+	 */
+	template<typename Char>
+	[[nodiscard]] auto diff(const LazyDocument<Char>& old_document, const LazyDocument<Char>& new_document) -> diff_result_type<Char>
+	{
+		diff_result_type<Char> result{};
+
+		for (const auto name: old_document.names())
+		{
+			if (!new_document.contains(name))
+			{
+				result.push_back({.kind = DiffKind::GROUP_REMOVED, .group = name, .key = {}, .old_value = {}, .new_value = {}});
+				continue;
+			}
+
+			if (old_document.raw_hash(name) == new_document.raw_hash(name)) { continue; }
+
+			diff_detail::diff_group<Char>(name, *old_document.group(name), *new_document.group(name), result);
+		}
+
+		for (const auto name: new_document.names())
+		{
+			if (!old_document.contains(name)) { result.push_back({.kind = DiffKind::GROUP_ADDED, .group = name, .key = {}, .old_value = {}, .new_value = {}}); }
+		}
+
+		return result;
+	}
+}// namespace gal::ini
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <ini/internal/common.hpp>
+#include <string>
 
 namespace gal::ini
 {
@@ -14,6 +16,23 @@ namespace gal::ini
 		INTERNAL_ERROR,
 
 		SUCCESS,
+		// The file has not changed since it was last extracted (see `change_token`), nothing was extracted.
+		NOT_MODIFIED,
+		// Some values were rejected by the validator (see `Schema`), the rejected key-value pairs were not extracted.
+		INVALID_DATA,
+	};
+
+	// Identifies the content of a file at the time it was extracted.
+	// note: The metadata (inode, size, mtime) is compared first, the content hash is only compared if the metadata has changed (e.g. the file was touched or replaced with the same content).
+	// note: inode is always 0 on Windows.
+	struct change_token
+	{
+		std::uint64_t inode{0};
+		std::uint64_t size{0};
+		std::int64_t  mtime_ns{0};
+		std::uint64_t hash{0};
+
+		[[nodiscard]] constexpr auto operator==(const change_token& other) const noexcept -> bool = default;
 	};
 
 	template<typename Char>
@@ -58,6 +77,23 @@ namespace gal::ini
 			#endif
 	>;
 
+	template<typename Char>
+	using value_validate_type =
+	StackFunction<
+		#if not defined(GAL_INI_COMPILER_MSVC)
+		auto
+		// pass group name, key, value
+		(string_view_t<Char>,
+		string_view_t<Char>,
+		string_view_t<Char>)
+		// return why the value is rejected (empty => accepted)
+			-> std::string_view
+			#else
+		std::string_view
+		(string_view_t<Char>, string_view_t<Char>, string_view_t<Char>)
+			#endif
+	>;
+
 	namespace extractor_detail
 	{
 		// ==============================================
@@ -113,6 +149,175 @@ namespace gal::ini
 		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_buffer(
 				string_view_t<char32_t>     buffer,
 				group_append_type<char32_t> group_appender) -> ExtractResult;
+
+		// ====================================================
+		// Same as above, but each value is passed to the validator before it is appended, the rejected values are reported and discarded.
+		// ====================================================
+
+		// char
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file(
+				std::string_view          file_path,
+				group_append_type<char>   group_appender,
+				value_validate_type<char> value_validator) -> ExtractResult;
+
+		// char8_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file(
+				std::string_view             file_path,
+				group_append_type<char8_t>   group_appender,
+				value_validate_type<char8_t> value_validator) -> ExtractResult;
+
+		// char16_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file(
+				std::string_view              file_path,
+				group_append_type<char16_t>   group_appender,
+				value_validate_type<char16_t> value_validator) -> ExtractResult;
+
+		// char32_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file(
+				std::string_view              file_path,
+				group_append_type<char32_t>   group_appender,
+				value_validate_type<char32_t> value_validator) -> ExtractResult;
+
+		// char
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_buffer(
+				string_view_t<char>       buffer,
+				group_append_type<char>   group_appender,
+				value_validate_type<char> value_validator) -> ExtractResult;
+
+		// char8_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_buffer(
+				string_view_t<char8_t>       buffer,
+				group_append_type<char8_t>   group_appender,
+				value_validate_type<char8_t> value_validator) -> ExtractResult;
+
+		// char16_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_buffer(
+				string_view_t<char16_t>       buffer,
+				group_append_type<char16_t>   group_appender,
+				value_validate_type<char16_t> value_validator) -> ExtractResult;
+
+		// char32_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_buffer(
+				string_view_t<char32_t>       buffer,
+				group_append_type<char32_t>   group_appender,
+				value_validate_type<char32_t> value_validator) -> ExtractResult;
+
+		// ====================================================
+		// For extract from files only if they have changed, we support four character types and assume the encoding of the file based on the character type.
+		// The token is updated if the result is SUCCESS or NOT_MODIFIED.
+		// ====================================================
+
+		// char
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file_if_changed(
+				std::string_view        file_path,
+				change_token&           token,
+				group_append_type<char> group_appender) -> ExtractResult;
+
+		// char8_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file_if_changed(
+				std::string_view           file_path,
+				change_token&              token,
+				group_append_type<char8_t> group_appender) -> ExtractResult;
+
+		// char16_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file_if_changed(
+				std::string_view            file_path,
+				change_token&               token,
+				group_append_type<char16_t> group_appender) -> ExtractResult;
+
+		// char32_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract_from_file_if_changed(
+				std::string_view            file_path,
+				change_token&               token,
+				group_append_type<char32_t> group_appender) -> ExtractResult;
+
+		// Read the metadata (inode, size, mtime) of the file, the hash is left 0.
+		// Returns an empty token if the file does not exist.
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto read_change_token(std::string_view file_path) -> change_token;
+
+		// ====================================================
+		// Read the whole file without parsing it, the encoding of the file is assumed based on the character type (same as extract_from_file).
+		// ====================================================
+
+		// char
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto read_file(
+				std::string_view         file_path,
+				std::basic_string<char>& out) -> ExtractResult;
+
+		// char8_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto read_file(
+				std::string_view            file_path,
+				std::basic_string<char8_t>& out) -> ExtractResult;
+
+		// char16_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto read_file(
+				std::string_view             file_path,
+				std::basic_string<char16_t>& out) -> ExtractResult;
+
+		// char32_t
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto read_file(
+				std::string_view             file_path,
+				std::basic_string<char32_t>& out) -> ExtractResult;
+
+		/**
+		 * @brief Make the group appender that stores the extracted data into the context, and pass it to the extractor.
+		 * @tparam ContextType Type of the output data.
+		 * @tparam Extractor auto(group_append_type<Char>) -> Result
+		 * @param out Where the extracted data is stored.
+		 * @param extractor How to extract the data.
+		 * @return Result of the extractor.
+		 */
+		template<typename ContextType, typename Extractor>
+		auto extract_to_context(ContextType& out, Extractor extractor) -> decltype(auto)
+		{
+			using context_type = ContextType;
+
+			using key_type = typename context_type::key_type;
+			using group_type = typename context_type::mapped_type;
+
+			using group_key_type = typename group_type::key_type;
+			using group_mapped_type = typename group_type::mapped_type;
+
+			using char_type = typename string_view_t<key_type>::value_type;
+
+			// We need the following one temporary variable to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
+			typename context_type::iterator current_group_it = out.end();
+
+			// !!!MUST PLACE HERE!!!
+			// StackFunction keeps the address of the lambda and forwards the argument to the lambda when StackFunction::operator() has been called.
+			// This requires that the lambda "must" exist at this point (i.e. have a longer lifecycle than the StackFunction), which is fine for a single-level lambda (maybe?).
+			// However, if there is nesting, then the lambda will end its lifecycle early and the StackFunction will refer to an illegal address.
+			// Walking on the edge of UB!
+			auto kv_appender = [&current_group_it](const string_view_t<group_key_type> key, const string_view_t<group_mapped_type> value) -> std::pair<std::pair<string_view_t<group_key_type>, string_view_t<group_mapped_type>>, bool>
+			{
+				auto& group = current_group_it->second;
+
+				const auto [kv_it, kv_inserted] = group.emplace(
+						common::make_object_for<group_key_type>(group, key),
+						common::make_object_for<group_mapped_type>(group, value));
+				return {{kv_it->first, kv_it->second}, kv_inserted};
+			};
+
+			auto group_appender = [&out, &current_group_it, &kv_appender](string_view_t<key_type> group_name) -> group_append_result<char_type>
+			{
+				#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+				const auto workaround_emplace_result = out.emplace(common::make_object_for<key_type>(out, group_name), common::make_object_for<group_type>(out));
+				const auto group_it                  = workaround_emplace_result.first;
+				const auto group_inserted            = workaround_emplace_result.second;
+				#else
+				const auto [group_it, group_inserted] = out.emplace(common::make_object_for<key_type>(out, group_name), common::make_object_for<group_type>(out));
+				#endif
+
+				current_group_it = group_it;
+
+				return {
+						.name = group_it->first,
+						.kv_appender = kv_appender,
+						.inserted = group_inserted};
+			};
+
+			return extractor(group_append_type<char_type>{group_appender});
+		}
 	}// namespace extractor_detail
 
 	/**
@@ -142,50 +347,9 @@ namespace gal::ini
 	template<typename ContextType>
 	auto extract_from_file(const std::string_view file_path, ContextType& out) -> ExtractResult
 	{
-		using context_type = ContextType;
-
-		using key_type = typename context_type::key_type;
-		using group_type = typename context_type::mapped_type;
-
-		using group_key_type = typename group_type::key_type;
-		using group_mapped_type = typename group_type::mapped_type;
-
-		using char_type = typename string_view_t<key_type>::value_type;
-
-		// We need the following one temporary variable to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
-		auto current_group_it = out.end();
-
-		// !!!MUST PLACE HERE!!!
-		// StackFunction keeps the address of the lambda and forwards the argument to the lambda when StackFunction::operator() has been called.
-		// This requires that the lambda "must" exist at this point (i.e. have a longer lifecycle than the StackFunction), which is fine for a single-level lambda (maybe?).
-		// However, if there is nesting, then the lambda will end its lifecycle early and the StackFunction will refer to an illegal address.
-		// Walking on the edge of UB!
-		auto kv_appender = [&current_group_it](const string_view_t<group_key_type> key, const string_view_t<group_mapped_type> value) -> std::pair<std::pair<string_view_t<group_key_type>, string_view_t<group_mapped_type>>, bool>
-		{
-			const auto [kv_it, kv_inserted] = current_group_it->second.emplace(group_key_type{key}, group_mapped_type{value});
-			return {{kv_it->first, kv_it->second}, kv_inserted};
-		};
-
-		return extract_from_file<ContextType>(
-				file_path,
-				group_append_type<char_type>{
-						[&out, &current_group_it, &kv_appender](string_view_t<key_type> group_name) -> group_append_result<char_type>
-						{
-							#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
-							const auto workaround_emplace_result = out.emplace(key_type{group_name}, group_type{});
-							const auto group_it                  = workaround_emplace_result.first;
-							const auto group_inserted            = workaround_emplace_result.second;
-							#else
-							const auto [group_it, group_inserted] = out.emplace(key_type{group_name}, group_type{});
-							#endif
-
-							current_group_it = group_it;
-
-							return {
-									.name = group_it->first,
-									.kv_appender = kv_appender,
-									.inserted = group_inserted};
-						}});
+		return extractor_detail::extract_to_context(
+				out,
+				[file_path](const auto group_appender) -> ExtractResult { return extract_from_file<ContextType>(file_path, group_appender); });
 	}
 
 	template<typename ContextType>
@@ -193,7 +357,22 @@ namespace gal::ini
 	{
 		ContextType out{};
 		const auto  result = extract_from_file<ContextType>(file_path, out);
-		return {result, out};
+		return {result, std::move(out)};
+	}
+
+	/**
+	 * @brief Extract ini data from files.
+	 * @tparam ContextType Type of the output data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param allocator The allocator of the output data, all groups, keys and values are constructed with it (uses-allocator construction).
+	 * @return Extract result and the extracted data.
+	 */
+	template<typename ContextType>
+	auto extract_from_file(const std::string_view file_path, const typename ContextType::allocator_type& allocator) -> std::pair<ExtractResult, ContextType>
+	{
+		ContextType out(allocator);
+		const auto  result = extract_from_file<ContextType>(file_path, out);
+		return {result, std::move(out)};
 	}
 
 	/**
@@ -225,50 +404,9 @@ namespace gal::ini
 			string_view_t<typename string_view_t<typename ContextType::key_type>::value_type> buffer,
 			ContextType&                                                                      out) -> ExtractResult
 	{
-		using context_type = ContextType;
-
-		using key_type = typename context_type::key_type;
-		using group_type = typename context_type::mapped_type;
-
-		using group_key_type = typename group_type::key_type;
-		using group_mapped_type = typename group_type::mapped_type;
-
-		using char_type = typename string_view_t<key_type>::value_type;
-
-		// We need the following one temporary variable to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
-		typename context_type::iterator current_group_it = out.end();
-
-		// !!!MUST PLACE HERE!!!
-		// StackFunction keeps the address of the lambda and forwards the argument to the lambda when StackFunction::operator() has been called.
-		// This requires that the lambda "must" exist at this point (i.e. have a longer lifecycle than the StackFunction), which is fine for a single-level lambda (maybe?).
-		// However, if there is nesting, then the lambda will end its lifecycle early and the StackFunction will refer to an illegal address.
-		// Walking on the edge of UB!
-		auto kv_appender = [&current_group_it](const string_view_t<group_key_type> key, const string_view_t<group_mapped_type> value) -> std::pair<std::pair<string_view_t<group_key_type>, string_view_t<group_mapped_type>>, bool>
-		{
-			const auto [kv_it, kv_inserted] = current_group_it->second.emplace(group_key_type{key}, group_mapped_type{value});
-			return {{kv_it->first, kv_it->second}, kv_inserted};
-		};
-
-		return extract_from_buffer<ContextType>(
-				buffer,
-				group_append_type<char_type>{
-						[&out, &current_group_it, &kv_appender](string_view_t<key_type> group_name) -> group_append_result<char_type>
-						{
-							#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
-							const auto workaround_emplace_result = out.emplace(key_type{group_name}, group_type{});
-							const auto group_it                  = workaround_emplace_result.first;
-							const auto group_inserted            = workaround_emplace_result.second;
-							#else
-							const auto [group_it, group_inserted] = out.emplace(key_type{group_name}, group_type{});
-							#endif
-
-							current_group_it = group_it;
-
-							return {
-									.name = group_it->first,
-									.kv_appender = kv_appender,
-									.inserted = group_inserted};
-						}});
+		return extractor_detail::extract_to_context(
+				out,
+				[buffer](const auto group_appender) -> ExtractResult { return extract_from_buffer<ContextType>(buffer, group_appender); });
 	}
 
 	template<typename ContextType>
@@ -277,6 +415,74 @@ namespace gal::ini
 	{
 		ContextType out{};
 		const auto  result = extract_from_buffer<ContextType>(buffer, out);
-		return {result, out};
+		return {result, std::move(out)};
+	}
+
+	/**
+	 * @brief Extract ini data from buffer.
+	 * @tparam ContextType Type of the output data.
+	 * @param buffer The buffer.
+	 * @param allocator The allocator of the output data, all groups, keys and values are constructed with it (uses-allocator construction).
+	 * @return Extract result and the extracted data.
+	 */
+	template<typename ContextType>
+	auto extract_from_buffer(
+			string_view_t<typename string_view_t<typename ContextType::key_type>::value_type> buffer,
+			const typename ContextType::allocator_type&                                       allocator) -> std::pair<ExtractResult, ContextType>
+	{
+		ContextType out(allocator);
+		const auto  result = extract_from_buffer<ContextType>(buffer, out);
+		return {result, std::move(out)};
+	}
+
+	/**
+	 * @brief Extract ini data from files, but only if the file has changed since the token was made.
+	 * @tparam ContextType Type of the output data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param token The token returned by the last extraction (or a default constructed token).
+	 * @param group_appender How to add a new group (never called if the file has not changed).
+	 * @return Extract result (NOT_MODIFIED if the file has not changed) and the token for the next call.
+	 */
+	template<typename ContextType>
+	auto extract_if_changed(
+			const std::string_view                                                                file_path,
+			const change_token&                                                                   token,
+			group_append_type<typename string_view_t<typename ContextType::key_type>::value_type> group_appender) -> std::pair<ExtractResult, change_token>
+	{
+		auto       new_token = token;
+		const auto result    = extractor_detail::extract_from_file_if_changed(
+				file_path,
+				new_token,
+				group_appender);
+		return {result, new_token};
+	}
+
+	/**
+	 * @brief Extract ini data from files, but only if the file has changed since the token was made.
+	 * @tparam ContextType Type of the output data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param token The token returned by the last extraction (or a default constructed token).
+	 * @param out Where the extracted data is stored, it is replaced by the data of the changed file (untouched if the file has not changed or cannot be extracted).
+	 * @return Extract result (NOT_MODIFIED if the file has not changed) and the token for the next call.
+	 */
+	template<typename ContextType>
+	auto extract_if_changed(const std::string_view file_path, const change_token& token, ContextType& out) -> std::pair<ExtractResult, change_token>
+	{
+		// Extract into a fresh context (with the allocator of out), otherwise the edited values would be dropped (emplace does not overwrite) and the removed keys would stay.
+		auto fresh = [&out]() -> ContextType
+		{
+			if constexpr (requires { ContextType(out.get_allocator()); }) { return ContextType(out.get_allocator()); }
+			else { return ContextType{}; }
+		}();
+
+		auto result = extractor_detail::extract_to_context(
+				fresh,
+				[file_path, &token](const auto group_appender) -> std::pair<ExtractResult, change_token> { return extract_if_changed<ContextType>(file_path, token, group_appender); });
+		if (result.first == ExtractResult::SUCCESS)
+		{
+			using std::swap;
+			swap(out, fresh);
+		}
+		return result;
 	}
 }// namespace gal::ini
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <initializer_list>
 #include <ini/internal/common.hpp>
 // for std::basic_ostream
-#include <iosfwd>
+#include <ostream>
+#include <span>
+#include <string>
 
 namespace gal::ini
 {
@@ -18,6 +23,18 @@ namespace gal::ini
 		SUCCESS,
 	};
 
+	// How the flushed file reaches the disk, the file is written to a temporary file (in the same directory) and renamed over the target, so the target is never torn.
+	// note: A target with several hard links is the exception, it is rewritten in place (a rename would detach it from the other links), a crash during the write may tear it.
+	enum class FlushDurability
+	{
+		// No fsync, a power loss (not a crash of the process) may leave an empty or old file.
+		NONE,
+		// The data is synced before the rename.
+		DATA,
+		// The data is synced before the rename and the directory is synced after it (the rename itself is durable).
+		FULL,
+	};
+
 	// 1. std::basic_ostream
 	template<typename Char>
 	using ostream_type = std::basic_ostream<Char>;
@@ -59,8 +76,29 @@ namespace gal::ini
 		#else
 				= 0;
 		#endif
+
+		using fragments_type = std::span<const string_view_t<char_type>>;
+
+		// Write the fragments of a line at once (e.g. `key`, ` `, `=`, ` `, `value`, `\n`), the default writes them one by one.
+		// note: Override this to take a whole line with one virtual call instead of one call per fragment.
+		constexpr virtual auto write(const fragments_type fragments) -> UserOut&
+		{
+			for (const auto fragment: fragments) { *this << fragment; }
+			return *this;
+		}
+
+		// Called once before anything is written, size_hint is the size of the source (the output is usually about the same size).
+		constexpr virtual auto reserve(const std::size_t size_hint) -> void { (void)size_hint; }
+
+		// Called once after everything is written.
+		constexpr virtual auto flush() -> void {}
 	};
 
+	// The end of a line passed to the flush handles of UserOut, ('space' inline_comment_indication 'space' inline_comment) '\n'.
+	// note: The handle writes it right after the group head (or the key-value pair), so that the whole line is written with one virtual call (see UserOut::write).
+	template<typename Char>
+	using line_end_type = std::span<const string_view_t<Char>>;
+
 	// Determines if a key exists in the current group.
 	// note: This function is used to determine whether the comment and inline_comment of the key-value pair should be written to the file (for deleted key-value pairs, we discard the comment).
 	template<typename Char>
@@ -97,18 +135,20 @@ namespace gal::ini
 			#endif
 	>;
 
+	// note: Write line_end after the key-value pair (in the same UserOut::write), it contains the inline_comment (if it exists) and the newline.
 	template<typename Char>
 	using kv_flush_user_type =
 	StackFunction<
 		#if not defined(GAL_INI_COMPILER_MSVC)
 		auto
-		// pass key
-		(string_view_t<Char> key)
+		// pass key and the end of the line
+		(string_view_t<Char> key,
+		line_end_type<Char>  line_end)
 		// return nothing
 			-> void
 			#else
 		void
-		(string_view_t<Char> key)
+		(string_view_t<Char> key, line_end_type<Char> line_end)
 			#endif
 	>;
 
@@ -172,7 +212,7 @@ namespace gal::ini
 
 		// kv flush handle
 		kv_flush_user_type<Char> flush{
-				[](const auto&) -> void {}};
+				[](const auto&, const auto&) -> void {}};
 
 		// kv flush remaining handle
 		kv_flush_remaining_user_type<Char> flush_remaining{
@@ -218,18 +258,20 @@ namespace gal::ini
 			#endif
 	>;
 
+	// note: Write line_end after the group head (in the same UserOut::write), it contains the inline_comment (if it exists) and the newline.
 	template<typename Char>
 	using group_flush_user_type =
 	StackFunction<
 		#if not defined(GAL_INI_COMPILER_MSVC)
 		auto
-		// pass group name
-		(string_view_t<Char> group_name)
+		// pass group name and the end of the line
+		(string_view_t<Char> group_name,
+		line_end_type<Char>  line_end)
 		// return kv_handler
 			-> kv_user_handle<Char>
 			#else
 		kv_user_handle<Char>
-		(string_view_t<Char> group_name)
+		(string_view_t<Char> group_name, line_end_type<Char> line_end)
 			#endif
 	>;
 
@@ -299,7 +341,7 @@ namespace gal::ini
 
 		// group flush handle
 		group_flush_user_type<Char> flush{
-				[](const auto&) -> void {}};
+				[](const auto&, const auto&) -> void {}};
 
 		// group flush remaining handle
 		group_flush_remaining_user_type<Char> flush_remaining{
@@ -321,7 +363,25 @@ namespace gal::ini
 		// char
 		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto flush_to_file(
 				std::string_view           file_path,
-				group_ostream_handle<char> group_handler) -> FlushResult;
+				group_ostream_handle<char> group_handler,
+				FlushDurability            durability) -> FlushResult;
+
+		// char
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto flush_to_buffer(
+				std::string_view           source,
+				group_ostream_handle<char> group_handler,
+				std::string&               out) -> FlushResult;
+
+		// The entries (e.g. a rename or a removal) of the directory of the file reach the disk.
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto sync_directory(std::string_view file_path) -> bool;
+
+		/**
+		 * @brief Write the data (as is) to a new file next to the target and rename it over the target, the target is never torn and whoever still has the old file open (or mapped) keeps reading it.
+		 * @param file_path The path to the target.
+		 * @param data The content of the target.
+		 * @param durability How the file reaches the disk.
+		 */
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto replace_file(std::string_view file_path, std::string_view data, FlushDurability durability) -> FlushResult;
 
 		// ====================================================
 		// For flush to UserOut, we support four character types and assume the encoding of the file based on the character type.
@@ -346,6 +406,211 @@ namespace gal::ini
 		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto flush_to_user(
 				std::string_view            file_path,
 				group_user_handle<char32_t> group_handler) -> FlushResult;
+
+		// ====================================================
+		// The temporary views built while flushing, they only refer to the data of the context.
+		// ====================================================
+
+		template<typename ContextType>
+		using group_view_type = common::map_type_t<
+			ContextType,
+			string_view_t<typename ContextType::key_type>,
+			const typename ContextType::mapped_type*>;
+
+		template<typename ContextType>
+		using kv_view_type = common::map_type_t<
+			typename ContextType::mapped_type,
+			string_view_t<typename ContextType::mapped_type::key_type>,
+			string_view_t<typename ContextType::mapped_type::mapped_type>>;
+
+		// At most 'space' inline_comment_indication 'space' inline_comment '\n', see line_end_type.
+		constexpr std::size_t line_end_max_size = 5;
+
+		/**
+		 * @brief Write the fragments of a line and the end of the line to out with one virtual call.
+		 */
+		template<typename Char, std::size_t N>
+		auto write_line(UserOut<Char>& out, const std::array<string_view_t<Char>, N>& fragments, const line_end_type<Char> line_end) -> void
+		{
+			if (line_end.size() > line_end_max_size)
+			{
+				out.write(fragments);
+				out.write(line_end);
+				return;
+			}
+
+			std::array<string_view_t<Char>, N + line_end_max_size> line{};
+			std::ranges::copy(fragments, line.begin());
+			std::ranges::copy(line_end, line.begin() + N);
+			out.write({line.data(), N + line_end.size()});
+		}
+
+		/**
+		 * @brief Write the fragments (of a line) to out, with one sentry and no formatting (no width, no locale).
+		 * @note flush_to_file passes an ostream that appends to a buffer, so this is just a few appends.
+		 */
+		template<typename Char>
+		auto write_fragments(ostream_type<Char>& out, const std::initializer_list<string_view_t<Char>> fragments) -> void
+		{
+			const typename ostream_type<Char>::sentry sentry{out};
+			if (!sentry) { return; }
+
+			auto* buffer = out.rdbuf();
+			for (const auto fragment: fragments)
+			{
+				if (const auto size = static_cast<std::streamsize>(fragment.size());
+					buffer->sputn(fragment.data(), size) != size)
+				{
+					out.setstate(std::ios_base::badbit);
+					return;
+				}
+			}
+		}
+	}// namespace flusher_detail
+
+	// The allocator of the temporary views, they live only during the flush, so a (stack) buffer resource is enough for them.
+	template<typename ContextType>
+	using flush_view_allocator_type = typename flusher_detail::group_view_type<ContextType>::allocator_type;
+
+	namespace flusher_detail
+	{
+		/**
+		 * @brief Build the group handler that writes the data of the context (see `flush_to_file`) and pass it to the functor.
+		 * @note The handler refers to the lambdas of this function, it must not be used after the functor returns.
+		 */
+		template<typename ContextType, typename Functor>
+		auto with_ostream_handle(ContextType& in, const flush_view_allocator_type<ContextType>& view_allocator, Functor functor) -> FlushResult
+		{
+			using context_type = ContextType;
+
+			using key_type = typename context_type::key_type;
+			using group_type = typename context_type::mapped_type;
+
+			using group_key_type = typename group_type::key_type;
+
+			using char_type = typename string_view_t<key_type>::value_type;
+
+			using group_view_type = flusher_detail::group_view_type<context_type>;
+			using kv_view_type = flusher_detail::kv_view_type<context_type>;
+
+			// '[' group_name ']' (newline)
+			// no '\n' if newline is empty, see `group_flush_type`
+			constexpr static auto do_flush_group_head = [](ostream_type<char_type>& out, const string_view_t<char_type> group_name, const string_view_t<char_type> newline = {}) -> void
+			{
+				flusher_detail::write_fragments<char_type>(
+						out,
+						{
+								{&square_bracket<key_type>.first, 1},
+								group_name,
+								{&square_bracket<key_type>.second, 1},
+								newline});
+			};
+			// key 'space' '=' 'space' value (newline)
+			// no '\n' if newline is empty, see `kv_flush_type`
+			constexpr static auto do_flush_kv = [](ostream_type<char_type>& out, const string_view_t<char_type> key, const string_view_t<char_type> value, const string_view_t<char_type> newline = {}) -> void
+			{
+				flusher_detail::write_fragments<char_type>(
+						out,
+						{
+								key,
+								blank_separator<group_key_type>,
+								kv_separator<group_key_type>,
+								blank_separator<group_key_type>,
+								value,
+								newline});
+			};
+
+			// We need the following two temporary variables to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
+
+			// all group view
+			auto group_view = [&view_allocator](const auto& gs) -> group_view_type
+			{
+				group_view_type vs(view_allocator);
+				for (const auto& g: gs) { vs.emplace(g.first, &g.second); }
+				return vs;
+			}(in);
+
+			// current kvs view
+			kv_view_type kv_view(typename kv_view_type::allocator_type{view_allocator});
+
+			// !!!MUST PLACE HERE!!!
+			// StackFunction keeps the address of the lambda and forwards the argument to the lambda when StackFunction::operator() has been called.
+			// This requires that the lambda "must" exist at this point (i.e. have a longer lifecycle than the StackFunction), which is fine for a single-level lambda (maybe?).
+			// However, if there is nesting, then the lambda will end its lifecycle early and the StackFunction will refer to an illegal address.
+			// Walking on the edge of UB!
+			auto                                                   kv_contains =
+					[&kv_view](const string_view_t<group_key_type> key) -> bool { return kv_view.contains(key); };
+
+			auto                                        kv_flush =
+					[&kv_view](ostream_type<char_type>& out, const string_view_t<char_type> key) -> void
+			{
+				if (const auto kv_it = kv_view.find(key);
+					kv_it != kv_view.end())
+				{
+					do_flush_kv(out, kv_it->first, kv_it->second);
+					// remove this key
+					kv_view.erase(kv_it);
+				}
+
+				// else, do nothing
+			};
+
+			auto                                        kv_flush_remaining =
+					[&kv_view](ostream_type<char_type>& out) -> void
+			{
+				// note: newlines
+				for (const auto& kv: kv_view) { do_flush_kv(out, kv.first, kv.second, line_separator<string_view_t<char_type>>); }
+				// clear
+				kv_view.clear();
+			};
+
+			return functor(
+					group_ostream_handle<char_type>{
+							.contains =
+							group_contains_type<char_type>{
+									[&group_view](string_view_t<key_type> group_name) -> bool { return group_view.contains(group_name); }},
+							.flush =
+							group_flush_ostream_type<char_type>{
+									[&group_view, &kv_view, &kv_contains, &kv_flush, &kv_flush_remaining](ostream_type<char_type>& out, const string_view_t<char_type> group_name) -> kv_ostream_handle<char_type>
+									{
+										if (const auto group_it = group_view.find(group_name);
+											group_it != group_view.end())
+										{
+											// flush head
+											do_flush_group_head(out, group_name);
+
+											// set current kvs view
+											for (const auto& kv: *group_it->second) { kv_view.emplace(kv.first, kv.second); }
+
+											// remove this group from view
+											group_view.erase(group_name);
+
+											return {
+													.name = group_name,
+													.contains = kv_contains,
+													.flush = kv_flush,
+													.flush_remaining = kv_flush_remaining};
+										}
+
+										return {};
+									}},
+							.flush_remaining =
+							group_flush_remaining_ostream_type<char_type>{
+									[&group_view](ostream_type<char_type>& out) -> void
+									{
+										for (const auto& group: group_view)
+										{
+											// flush head
+											do_flush_group_head(out, group.first, line_separator<key_type>);
+
+											// kvs
+											for (const auto& kv: *group.second) { do_flush_kv(out, kv.first, kv.second, line_separator<group_key_type>); }
+										}
+
+										// clear
+										group_view.clear();
+									}}});
+		}
 	}// namespace flusher_detail
 
 	/**
@@ -353,16 +618,19 @@ namespace gal::ini
 	 * @tparam ContextType Type of the input data.
 	 * @param file_path The (absolute) path to the file.
 	 * @param group_handler Group handler.
+	 * @param durability How the file reaches the disk.
 	 * @return Flush result.
 	 */
 	template<typename ContextType>
 	auto flush_to_file(
 			const std::string_view                                                                   file_path,
-			group_ostream_handle<typename string_view_t<typename ContextType::key_type>::value_type> group_handler) -> FlushResult
+			group_ostream_handle<typename string_view_t<typename ContextType::key_type>::value_type> group_handler,
+			const FlushDurability                                                                    durability = FlushDurability::FULL) -> FlushResult
 	{
 		return flusher_detail::flush_to_file(
 				file_path,
-				group_handler);
+				group_handler,
+				durability);
 	}
 
 	template<typename ContextType>
@@ -375,151 +643,105 @@ namespace gal::ini
 				group_handler);
 	}
 
+	/**
+	 * @brief Flush ini data to files.
+	 * @tparam ContextType Type of the input data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param in Where the extracted data is stored.
+	 * @param view_allocator The allocator of the temporary views.
+	 * @param durability How the file reaches the disk.
+	 * @return Flush result.
+	 */
+	template<typename ContextType>
+	auto flush_to_file(
+			const std::string_view                        file_path,
+			ContextType&                                  in,
+			const flush_view_allocator_type<ContextType>& view_allocator,
+			const FlushDurability                         durability = FlushDurability::FULL) -> FlushResult
+	{
+		return flusher_detail::with_ostream_handle(
+				in,
+				view_allocator,
+				[file_path, durability](const auto& group_handler) -> FlushResult { return flush_to_file<ContextType>(file_path, group_handler, durability); });
+	}
+
 	/**
 	 * @brief Flush ini data from files.
 	 * @tparam ContextType Type of the input data.
 	 * @param file_path The (absolute) path to the file.
 	 * @param in Where the extracted data is stored.
+	 * @param durability How the file reaches the disk.
 	 * @return Extract result.
 	 */
 	template<typename ContextType>
-	auto flush_to_file(const std::string_view file_path, ContextType& in) -> FlushResult
+	auto flush_to_file(const std::string_view file_path, ContextType& in, const FlushDurability durability = FlushDurability::FULL) -> FlushResult
 	{
-		using context_type = ContextType;
-
-		using key_type = typename context_type::key_type;
-		using group_type = typename context_type::mapped_type;
-
-		using group_key_type = typename group_type::key_type;
-		using group_mapped_type = typename group_type::mapped_type;
-
-		using char_type = typename string_view_t<key_type>::value_type;
-
-		using group_view_type = common::map_type_t<context_type, string_view_t<key_type>, const group_type*>;
-		using kv_view_type = common::map_type_t<group_type, string_view_t<group_key_type>, string_view_t<group_mapped_type>>;
-
-		constexpr static auto do_flush_group_head = [](ostream_type<char_type>& out, const string_view_t<char_type> group_name) -> void
-		{
-			// '[' group_name ']'
-			// no '\n', see `group_flush_type`
-			out
-					<< square_bracket<key_type>.first
-					<< group_name
-					<< square_bracket<key_type>.second;
-		};
-		constexpr static auto do_flush_kv = [](ostream_type<char_type>& out, const string_view_t<char_type> key, const string_view_t<char_type> value) -> void
-		{
-			// key 'space' '=' 'space' value
-			// no '\n', see `kv_flush_type`
-			out
-					<< key
-					<< blank_separator<group_key_type> << kv_separator<group_key_type> << blank_separator<group_key_type> << value;
-		};
-
-		// We need the following two temporary variables to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
-
-		// all group view
-		auto group_view = [](const auto& gs) -> group_view_type
-		{
-			group_view_type vs{};
-			for (const auto& g: gs) { vs.emplace(g.first, &g.second); }
-			return vs;
-		}(in);
-
-		// current kvs view
-		kv_view_type kv_view{};
-
-		// !!!MUST PLACE HERE!!!
-		// StackFunction keeps the address of the lambda and forwards the argument to the lambda when StackFunction::operator() has been called.
-		// This requires that the lambda "must" exist at this point (i.e. have a longer lifecycle than the StackFunction), which is fine for a single-level lambda (maybe?).
-		// However, if there is nesting, then the lambda will end its lifecycle early and the StackFunction will refer to an illegal address.
-		// Walking on the edge of UB!
-		auto                                                   kv_contains =
-				[&kv_view](const string_view_t<group_key_type> key) -> bool { return kv_view.contains(key); };
-
-		auto                                        kv_flush =
-				[&kv_view](ostream_type<char_type>& out, const string_view_t<char_type> key) -> void
-		{
-			if (const auto kv_it = kv_view.find(key);
-				kv_it != kv_view.end())
-			{
-				do_flush_kv(out, kv_it->first, kv_it->second);
-				// remove this key
-				kv_view.erase(kv_it);
-			}
-
-			// else, do nothing
-		};
-
-		auto                                        kv_flush_remaining =
-				[&kv_view](ostream_type<char_type>& out) -> void
-		{
-			for (const auto& kv: kv_view)
-			{
-				do_flush_kv(out, kv.first, kv.second);
-				// note: newlines
-				out << line_separator<string_view_t<char_type>>;
-			}
-			// clear
-			kv_view.clear();
-		};
-
-		return flush_to_file<ContextType>(
-				file_path,
-				group_ostream_handle<char_type>{
-						.contains =
-						group_contains_type<char_type>{
-								[&group_view](string_view_t<key_type> group_name) -> bool { return group_view.contains(group_name); }},
-						.flush =
-						group_flush_ostream_type<char_type>{
-								[&group_view, &kv_view, &kv_contains, &kv_flush, &kv_flush_remaining](ostream_type<char_type>& out, const string_view_t<char_type> group_name) -> kv_ostream_handle<char_type>
-								{
-									if (const auto group_it = group_view.find(group_name);
-										group_it != group_view.end())
-									{
-										// flush head
-										do_flush_group_head(out, group_name);
-
-										// set current kvs view
-										for (const auto& kv: *group_it->second) { kv_view.emplace(kv.first, kv.second); }
-
-										// remove this group from view
-										group_view.erase(group_name);
-
-										return {
-												.name = group_name,
-												.contains = kv_contains,
-												.flush = kv_flush,
-												.flush_remaining = kv_flush_remaining};
-									}
+		return flush_to_file<ContextType>(file_path, in, flush_view_allocator_type<ContextType>{}, durability);
+	}
 
-									return {};
-								}},
-						.flush_remaining =
-						group_flush_remaining_ostream_type<char_type>{
-								[&group_view](ostream_type<char_type>& out) -> void
-								{
-									for (const auto& group: group_view)
-									{
-										// flush head
-										do_flush_group_head(out, group.first);
-										out << line_separator<key_type>;
+	/**
+	 * @brief Flush ini data to a buffer, nothing is read from or written to files.
+	 * @tparam ContextType Type of the input data.
+	 * @param source The source (e.g. the content of the file, without BOM), the data is written in the order of the source (empty => in the order of the context).
+	 * @param group_handler Group handler.
+	 * @param out Where the data is appended.
+	 * @return Flush result.
+	 */
+	template<typename ContextType>
+	auto flush_to_buffer(
+			const std::string_view                                                                   source,
+			group_ostream_handle<typename string_view_t<typename ContextType::key_type>::value_type> group_handler,
+			std::string&                                                                             out) -> FlushResult
+	{
+		return flusher_detail::flush_to_buffer(
+				source,
+				group_handler,
+				out);
+	}
 
-										// kvs
-										for (const auto& kv: *group.second)
-										{
-											do_flush_kv(out, kv.first, kv.second);
-											out << line_separator<group_key_type>;
-										}
-									}
+	/**
+	 * @brief Flush ini data to a buffer (e.g. for a dry run or a diff), the output is the same as `flush_to_file` would write.
+	 * @tparam ContextType Type of the input data.
+	 * @param source The source (e.g. the content of the file, without BOM), the data is written in the order of the source (empty => in the order of the context).
+	 * @param in Where the extracted data is stored.
+	 * @param out Where the data is appended.
+	 * @param view_allocator The allocator of the temporary views.
+	 * @return Flush result.
+	 */
+	template<typename ContextType>
+	auto flush_to_buffer(
+			const std::string_view                        source,
+			ContextType&                                  in,
+			std::string&                                  out,
+			const flush_view_allocator_type<ContextType>& view_allocator) -> FlushResult
+	{
+		return flusher_detail::with_ostream_handle(
+				in,
+				view_allocator,
+				[source, &out](const auto& group_handler) -> FlushResult { return flush_to_buffer<ContextType>(source, group_handler, out); });
+	}
 
-									// clear
-									group_view.clear();
-								}}});
+	template<typename ContextType>
+	auto flush_to_buffer(const std::string_view source, ContextType& in, std::string& out) -> FlushResult
+	{
+		return flush_to_buffer<ContextType>(source, in, out, flush_view_allocator_type<ContextType>{});
 	}
 
+	/**
+	 * @brief Flush ini data to UserOut.
+	 * @tparam ContextType Type of the input data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param in Where the extracted data is stored.
+	 * @param user Where the data is written.
+	 * @param view_allocator The allocator of the temporary views.
+	 * @return Flush result.
+	 */
 	template<typename ContextType>
-	auto flush_to_user(const std::string_view file_path, ContextType& in, UserOut<typename string_view_t<typename ContextType::key_type>::value_type>& user) -> FlushResult
+	auto flush_to_user(
+			const std::string_view                                                         file_path,
+			ContextType&                                                                   in,
+			UserOut<typename string_view_t<typename ContextType::key_type>::value_type>& user,
+			const flush_view_allocator_type<ContextType>&                                  view_allocator) -> FlushResult
 	{
 		using context_type = ContextType;
 
@@ -527,43 +749,52 @@ namespace gal::ini
 		using group_type = typename context_type::mapped_type;
 
 		using group_key_type = typename group_type::key_type;
-		using group_mapped_type = typename group_type::mapped_type;
 
 		using char_type = typename string_view_t<key_type>::value_type;
 
-		using group_view_type = common::map_type_t<context_type, string_view_t<key_type>, const group_type*>;
-		using kv_view_type = common::map_type_t<group_type, string_view_t<group_key_type>, string_view_t<group_mapped_type>>;
+		using group_view_type = flusher_detail::group_view_type<context_type>;
+		using kv_view_type = flusher_detail::kv_view_type<context_type>;
 
-		constexpr static auto do_flush_group_head = [](UserOut<char_type>& out, const string_view_t<char_type> group_name) -> void
+		// The end of the lines written by flush_remaining.
+		constexpr static string_view_t<char_type> newline[]{line_separator<string_view_t<char_type>>};
+
+		// '[' group_name ']' line_end
+		constexpr static auto do_flush_group_head = [](UserOut<char_type>& out, const string_view_t<char_type> group_name, const line_end_type<char_type> line_end) -> void
 		{
-			// '[' group_name ']'
-			// no '\n', see `group_flush_type`
-			out
-					<< square_bracket<key_type>.first
-					<< group_name
-					<< square_bracket<key_type>.second;
+			flusher_detail::write_line<char_type>(
+					out,
+					std::array<string_view_t<char_type>, 3>{
+							{{&square_bracket<key_type>.first, 1},
+							 group_name,
+							 {&square_bracket<key_type>.second, 1}}},
+					line_end);
 		};
-		constexpr static auto do_flush_kv = [](UserOut<char_type>& out, const string_view_t<char_type> key, const string_view_t<char_type> value) -> void
+		// key 'space' '=' 'space' value line_end
+		constexpr static auto do_flush_kv = [](UserOut<char_type>& out, const string_view_t<char_type> key, const string_view_t<char_type> value, const line_end_type<char_type> line_end) -> void
 		{
-			// key 'space' '=' 'space' value
-			// no '\n', see `kv_flush_type`
-			out
-					<< key
-					<< blank_separator<group_key_type> << kv_separator<group_key_type> << blank_separator<group_key_type> << value;
+			flusher_detail::write_line<char_type>(
+					out,
+					std::array<string_view_t<char_type>, 5>{
+							{key,
+							 blank_separator<group_key_type>,
+							 kv_separator<group_key_type>,
+							 blank_separator<group_key_type>,
+							 value}},
+					line_end);
 		};
 
 		// We need the following two temporary variables to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
 
 		// all group view
-		auto group_view = [](const auto& gs) -> group_view_type
+		auto group_view = [&view_allocator](const auto& gs) -> group_view_type
 		{
-			group_view_type vs{};
+			group_view_type vs(view_allocator);
 			for (const auto& g: gs) { vs.emplace(g.first, &g.second); }
 			return vs;
 		}(in);
 
 		// current kvs view
-		kv_view_type kv_view{};
+		kv_view_type kv_view(typename kv_view_type::allocator_type{view_allocator});
 
 		// !!!MUST PLACE HERE!!!
 		// StackFunction keeps the address of the lambda and forwards the argument to the lambda when StackFunction::operator() has been called.
@@ -574,12 +805,12 @@ namespace gal::ini
 				[&kv_view](const string_view_t<group_key_type> key) -> bool { return kv_view.contains(key); };
 
 		auto                                                     kv_flush =
-				[&user, &kv_view](const string_view_t<char_type> key) -> void
+				[&user, &kv_view](const string_view_t<char_type> key, const line_end_type<char_type> line_end) -> void
 		{
 			if (const auto kv_it = kv_view.find(key);
 				kv_it != kv_view.end())
 			{
-				do_flush_kv(user, kv_it->first, kv_it->second);
+				do_flush_kv(user, kv_it->first, kv_it->second, line_end);
 				// remove this key
 				kv_view.erase(kv_it);
 			}
@@ -590,12 +821,8 @@ namespace gal::ini
 		auto kv_flush_remaining =
 				[&user, &kv_view]() -> void
 		{
-			for (const auto& kv: kv_view)
-			{
-				do_flush_kv(user, kv.first, kv.second);
-				// note: newlines
-				user << line_separator<string_view_t<char_type>>;
-			}
+			// note: newlines
+			for (const auto& kv: kv_view) { do_flush_kv(user, kv.first, kv.second, newline); }
 			// clear
 			kv_view.clear();
 		};
@@ -609,13 +836,13 @@ namespace gal::ini
 								[&group_view](string_view_t<key_type> group_name) -> bool { return group_view.contains(group_name); }},
 						.flush =
 						group_flush_user_type<char_type>{
-								[&user, &group_view, &kv_view, &kv_contains, &kv_flush, &kv_flush_remaining](const string_view_t<char_type> group_name) -> kv_user_handle<char_type>
+								[&user, &group_view, &kv_view, &kv_contains, &kv_flush, &kv_flush_remaining](const string_view_t<char_type> group_name, const line_end_type<char_type> line_end) -> kv_user_handle<char_type>
 								{
 									if (const auto group_it = group_view.find(group_name);
 										group_it != group_view.end())
 									{
 										// flush head
-										do_flush_group_head(user, group_name);
+										do_flush_group_head(user, group_name, line_end);
 
 										// set current kvs view
 										for (const auto& kv: *group_it->second) { kv_view.emplace(kv.first, kv.second); }
@@ -639,19 +866,20 @@ namespace gal::ini
 									for (const auto& group: group_view)
 									{
 										// flush head
-										do_flush_group_head(user, group.first);
-										user << line_separator<key_type>;
+										do_flush_group_head(user, group.first, newline);
 
 										// kvs
-										for (const auto& kv: *group.second)
-										{
-											do_flush_kv(user, kv.first, kv.second);
-											user << line_separator<group_key_type>;
-										}
+										for (const auto& kv: *group.second) { do_flush_kv(user, kv.first, kv.second, newline); }
 									}
 
 									// clear
 									group_view.clear();
 								}}});
 	}
+
+	template<typename ContextType>
+	auto flush_to_user(const std::string_view file_path, ContextType& in, UserOut<typename string_view_t<typename ContextType::key_type>::value_type>& user) -> FlushResult
+	{
+		return flush_to_user<ContextType>(file_path, in, user, flush_view_allocator_type<ContextType>{});
+	}
 }// namespace gal::ini
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ini/extractor.hpp>
+#include <ini/internal/common.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gal::ini
+{
+	/**
+	 * @brief The hierarchy of the groups (`[server.http.limits]` => server -> http -> limits), the names are split on a delimiter and each path component is interned once.
+	 * Enumerating a subtree (or a prefix query) only visits the nodes of the subtree, the flat ContextType is not involved at all.
+	 * @tparam Char Character type of the group names.
+	 * @note The tree does not refer to the data, it can be built from any ContextType (see `GroupTree::build`) or while extracting (see `extract_from_file`).
+	 */
+	template<typename Char>
+	class GroupTree
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+		using node_id = std::uint32_t;
+
+		constexpr static node_id root = 0;
+
+	private:
+		struct node_type
+		{
+			// interned
+			string_view_type component;
+			// full name of the group, empty => not a group (only a path to the groups below it)
+			string_view_type name;
+			bool             is_group;
+
+			node_id              parent;
+			std::vector<node_id> children;
+		};
+
+		char_type delimiter_;
+
+		// stable addresses
+		std::deque<string_type>                             strings_;
+		std::unordered_map<string_view_type, std::uint32_t> components_;
+
+		std::vector<node_type> nodes_;
+		// (parent, component) => child
+		std::unordered_map<std::uint64_t, node_id> edges_;
+
+		[[nodiscard]] auto intern(const string_view_type string) -> std::pair<string_view_type, std::uint32_t>
+		{
+			if (const auto it = components_.find(string);
+				it != components_.end()) { return {it->first, it->second}; }
+
+			const string_view_type interned = strings_.emplace_back(string);
+			const auto             id       = static_cast<std::uint32_t>(components_.size());
+			components_.emplace(interned, id);
+			return {interned, id};
+		}
+
+		[[nodiscard]] constexpr static auto edge_of(const node_id parent, const std::uint32_t component) noexcept -> std::uint64_t { return (static_cast<std::uint64_t>(parent) << 32) | component; }
+
+		// Call the functor for each component of the name.
+		template<typename Functor>
+		auto split(string_view_type name, Functor functor) const -> void
+		{
+			while (true)
+			{
+				const auto position = name.find(delimiter_);
+				if (!functor(name.substr(0, position))) { return; }
+				if (position == string_view_type::npos) { return; }
+				name.remove_prefix(position + 1);
+			}
+		}
+
+	public:
+		explicit GroupTree(const char_type delimiter = static_cast<char_type>('.'))
+			: delimiter_{delimiter},
+			nodes_{{.component = {}, .name = {}, .is_group = false, .parent = root, .children = {}}} {}
+
+		// The nodes refer to the strings interned by the tree itself, a copy would refer to the strings of the original.
+		// note: A move keeps the strings where they are (the deque takes over the storage of the other one).
+		GroupTree(const GroupTree&)                    = delete;
+		GroupTree(GroupTree&&)                         = default;
+		auto operator=(const GroupTree&) -> GroupTree& = delete;
+		auto operator=(GroupTree&&) -> GroupTree&      = default;
+
+		~GroupTree() noexcept = default;
+
+		/**
+		 * @brief Build the tree of the groups of the data.
+		 * @tparam ContextType Type of the data (any ContextType accepted by the extractor).
+		 * @param context The data.
+		 * @param delimiter Separator of the path components.
+		 * @return The tree.
+		 */
+		template<typename ContextType>
+		[[nodiscard]] static auto build(const ContextType& context, const char_type delimiter = static_cast<char_type>('.')) -> GroupTree
+		{
+			GroupTree tree{delimiter};
+			for (const auto& [group_name, group]: context) { (void)tree.insert(string_view_type{group_name}); }
+			return tree;
+		}
+
+		[[nodiscard]] auto delimiter() const noexcept -> char_type { return delimiter_; }
+
+		/**
+		 * @brief Add a group (and the path to it), nothing happens if the group exists.
+		 * @param group_name Name of the group.
+		 * @return The node of the group.
+		 */
+		auto insert(const string_view_type group_name) -> node_id
+		{
+			node_id current = root;
+			split(
+					group_name,
+					[this, &current](const string_view_type component) -> bool
+					{
+						const auto [interned, component_id] = intern(component);
+						const auto edge                     = edge_of(current, component_id);
+
+						if (const auto it = edges_.find(edge);
+							it != edges_.end())
+						{
+							current = it->second;
+							return true;
+						}
+
+						const auto child = static_cast<node_id>(nodes_.size());
+						nodes_.push_back({.component = interned, .name = {}, .is_group = false, .parent = current, .children = {}});
+						nodes_[current].children.push_back(child);
+						edges_.emplace(edge, child);
+
+						current = child;
+						return true;
+					});
+
+			if (auto& node = nodes_[current];
+				!node.is_group)
+			{
+				node.is_group = true;
+				node.name     = strings_.emplace_back(group_name);
+			}
+			return current;
+		}
+
+		/**
+		 * @brief Find the node of the path.
+		 * @param path The path (a group name or a prefix of it, e.g. `server.http`), empty => root.
+		 * @return The node, or nullopt if nothing is under the path.
+		 */
+		[[nodiscard]] auto find(const string_view_type path) const -> std::optional<node_id>
+		{
+			if (path.empty()) { return root; }
+
+			std::optional<node_id> current{root};
+			split(
+					path,
+					[this, &current](const string_view_type component) -> bool
+					{
+						const auto interned = components_.find(component);
+						if (interned == components_.end())
+						{
+							current.reset();
+							return false;
+						}
+
+						const auto it = edges_.find(edge_of(*current, interned->second));
+						if (it == edges_.end())
+						{
+							current.reset();
+							return false;
+						}
+
+						current = it->second;
+						return true;
+					});
+			return current;
+		}
+
+		[[nodiscard]] auto contains(const string_view_type group_name) const -> bool
+		{
+			const auto node = find(group_name);
+			return node.has_value() && nodes_[*node].is_group;
+		}
+
+		// The last path component of the node.
+		[[nodiscard]] auto component(const node_id node) const noexcept -> string_view_type { return nodes_[node].component; }
+
+		// The full name of the group, empty if the node is not a group.
+		[[nodiscard]] auto name(const node_id node) const noexcept -> string_view_type { return nodes_[node].name; }
+
+		[[nodiscard]] auto is_group(const node_id node) const noexcept -> bool { return nodes_[node].is_group; }
+
+		[[nodiscard]] auto parent(const node_id node) const noexcept -> node_id { return nodes_[node].parent; }
+
+		[[nodiscard]] auto children(const node_id node) const noexcept -> std::span<const node_id> { return nodes_[node].children; }
+
+		/**
+		 * @brief Visit the groups of the subtree (including the node itself), parents before children.
+		 * @tparam Functor auto(string_view_type group_name) -> void
+		 * @param node The root of the subtree.
+		 * @param functor The visitor.
+		 */
+		template<typename Functor>
+		auto for_each_group(const node_id node, Functor functor) const -> void
+		{
+			std::vector<node_id> stack{node};
+			while (!stack.empty())
+			{
+				const auto current = stack.back();
+				stack.pop_back();
+
+				if (nodes_[current].is_group) { functor(nodes_[current].name); }
+
+				const auto& children = nodes_[current].children;
+				stack.insert(stack.end(), children.rbegin(), children.rend());
+			}
+		}
+
+		/**
+		 * @brief The groups under the path (component-wise, `server.http` matches `server.http.limits` but not `server.https`).
+		 * @param path The path, empty => all groups.
+		 * @return The group names, parents before children.
+		 */
+		[[nodiscard]] auto subtree(const string_view_type path) const -> std::vector<string_view_type>
+		{
+			std::vector<string_view_type> result{};
+			if (const auto node = find(path);
+				node.has_value()) { for_each_group(*node, [&result](const string_view_type group_name) { result.push_back(group_name); }); }
+			return result;
+		}
+	};
+
+	/**
+	 * @brief Extract ini data from files, and add each group to the tree while it is extracted.
+	 * @tparam ContextType Type of the output data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param out Where the extracted data is stored.
+	 * @param tree The tree of the groups.
+	 * @return Extract result.
+	 */
+	template<typename ContextType>
+	auto extract_from_file(
+			const std::string_view                                                         file_path,
+			ContextType&                                                                   out,
+			GroupTree<typename string_view_t<typename ContextType::key_type>::value_type>& tree) -> ExtractResult
+	{
+		using char_type = typename string_view_t<typename ContextType::key_type>::value_type;
+
+		return extractor_detail::extract_to_context(
+				out,
+				[file_path, &tree](group_append_type<char_type> group_appender) -> ExtractResult
+				{
+					// !!!MUST PLACE HERE!!!
+					// see extractor_detail::extract_to_context
+					auto tree_appender = [&group_appender, &tree](const string_view_t<char_type> group_name) -> group_append_result<char_type>
+					{
+						auto result = group_appender(group_name);
+						(void)tree.insert(result.name);
+						return result;
+					};
+
+					return extractor_detail::extract_from_file(file_path, group_append_type<char_type>{tree_appender});
+				});
+	}
+
+	/**
+	 * @brief Extract ini data from buffer, and add each group to the tree while it is extracted.
+	 * @tparam ContextType Type of the output data.
+	 * @param buffer The buffer.
+	 * @param out Where the extracted data is stored.
+	 * @param tree The tree of the groups.
+	 * @return Extract result.
+	 */
+	template<typename ContextType>
+	auto extract_from_buffer(
+			string_view_t<typename string_view_t<typename ContextType::key_type>::value_type> buffer,
+			ContextType&                                                                      out,
+			GroupTree<typename string_view_t<typename ContextType::key_type>::value_type>&    tree) -> ExtractResult
+	{
+		using char_type = typename string_view_t<typename ContextType::key_type>::value_type;
+
+		return extractor_detail::extract_to_context(
+				out,
+				[buffer, &tree](group_append_type<char_type> group_appender) -> ExtractResult
+				{
+					// !!!MUST PLACE HERE!!!
+					// see extractor_detail::extract_to_context
+					auto tree_appender = [&group_appender, &tree](const string_view_t<char_type> group_name) -> group_append_result<char_type>
+					{
+						auto result = group_appender(group_name);
+						(void)tree.insert(result.name);
+						return result;
+					};
+
+					return extractor_detail::extract_from_buffer(buffer, group_append_type<char_type>{tree_appender});
+				});
+	}
+}// namespace gal::ini
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <ini/internal/convert.hpp>
+#include <ini/lazy_document.hpp>
+#include <ini/watcher.hpp>
+#include <optional>
+#include <string>
+
+namespace gal::ini
+{
+	namespace handle_detail
+	{
+		template<typename Map, typename StringView>
+		[[nodiscard]] auto find(const Map& map, const StringView key)
+		{
+			if constexpr (requires { map.find(key); }) { return map.find(key); }
+			else { return map.find(typename Map::key_type{key}); }
+		}
+	}// namespace handle_detail
+
+	/**
+	 * @brief A (group, key) that is looked up once and read many times.
+	 * The value is looked up and converted on first use and cached in the handle together with the generation of its source,
+	 * a read is a generation compare as long as the source has not changed (edited/reloaded), otherwise the value is looked up again.
+	 * @tparam T Type of the value (see common::from_string).
+	 * @tparam Char Character type of the group name and the key.
+	 * @note A handle is not thread-safe, each thread should own its handles (e.g. thread_local).
+	 */
+	template<typename T, typename Char = char>
+	class handle
+	{
+	public:
+		using value_type = T;
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+	private:
+		string_type group_;
+		string_type key_;
+
+		// The source and its generation of the cached value.
+		const void*   source_;
+		std::uint64_t generation_;
+
+		// nullopt => not found or cannot be converted
+		std::optional<value_type> value_;
+
+		auto cache(const void* source, const std::uint64_t generation, const string_view_type* value) -> void
+		{
+			source_     = source;
+			generation_ = generation;
+			value_      = value == nullptr ? std::nullopt : common::from_string<value_type, char_type>(*value);
+		}
+
+		auto resolve(const LazyDocument<char_type>& document) -> void
+		{
+			if (const auto* group = document.group(group_);
+				group != nullptr)
+			{
+				if (const auto it = group->find(key_);
+					it != group->end())
+				{
+					cache(&document, document.generation(), &it->second);
+					return;
+				}
+			}
+
+			cache(&document, document.generation(), nullptr);
+		}
+
+		template<typename ContextType>
+		auto resolve(const Watcher<ContextType>& watcher) -> void
+		{
+			// The snapshot is published before the generation is changed, it is at least as new as the generation.
+			const auto generation = watcher.generation();
+			const auto snapshot   = watcher.snapshot();
+
+			if (const auto group = handle_detail::find(*snapshot, string_view_type{group_});
+				group != snapshot->end())
+			{
+				if (const auto it = handle_detail::find(group->second, string_view_type{key_});
+					it != group->second.end())
+				{
+					const string_view_type value{it->second};
+					cache(&watcher, generation, &value);
+					return;
+				}
+			}
+
+			cache(&watcher, generation, nullptr);
+		}
+
+	public:
+		handle(const string_view_type group_name, const string_view_type key)
+			: group_{group_name},
+			key_{key},
+			source_{nullptr},
+			generation_{0},
+			value_{std::nullopt} {}
+
+		[[nodiscard]] auto group_name() const noexcept -> string_view_type { return group_; }
+
+		[[nodiscard]] auto key() const noexcept -> string_view_type { return key_; }
+
+		/**
+		 * @brief Get the value from the document, it is looked up again only if the document has changed (or is another document).
+		 * @param document The document.
+		 * @return The value, or nullopt if the key does not exist or the value cannot be converted.
+		 */
+		[[nodiscard]] auto get(const LazyDocument<char_type>& document) -> const std::optional<value_type>&
+		{
+			if (source_ != &document || generation_ != document.generation()) [[unlikely]] { resolve(document); }
+			return value_;
+		}
+
+		/**
+		 * @brief Get the value from the latest snapshot of the watcher, it is looked up again only after a reload.
+		 * @param watcher The watcher.
+		 * @return The value, or nullopt if the key does not exist or the value cannot be converted.
+		 */
+		template<typename ContextType>
+		[[nodiscard]] auto get(const Watcher<ContextType>& watcher) -> const std::optional<value_type>&
+		{
+			if (source_ != &watcher || generation_ != watcher.generation()) [[unlikely]] { resolve(watcher); }
+			return value_;
+		}
+
+		template<typename Source>
+		[[nodiscard]] auto value_or(const Source& source, value_type default_value) -> value_type
+		{
+			if (const auto& value = get(source);
+				value.has_value()) { return *value; }
+			return default_value;
+		}
+	};
+}// namespace gal::ini
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdint>
+#include <ini/extractor.hpp>
+#include <span>
+
+namespace gal::ini
+{
+	enum class IndexResult
+	{
+		// The source file or the index file was not found.
+		FILE_NOT_FOUND,
+		// The source file or the index file cannot be opened.
+		PERMISSION_DENIED,
+		// An internal OS error, such as failure to map or write the file.
+		INTERNAL_ERROR,
+		// The index file is not an index file (or was written by an incompatible version).
+		INVALID_INDEX,
+		// The source file has changed since the index file was built.
+		OUTDATED_INDEX,
+
+		SUCCESS,
+	};
+
+	enum class IndexValidation
+	{
+		// Compare the metadata (inode, size, mtime) of the source file with the metadata recorded in the index file.
+		// The content hash is still compared if the recorded metadata cannot be trusted (the source was modified right before the index was built).
+		METADATA,
+		// Always compare the content hash of the source file (reads the whole file).
+		CONTENT,
+	};
+
+	namespace index_detail
+	{
+		// The index file is laid out as follows (native byte order, every section is 8-byte aligned):
+		// [index_header]
+		// [std::uint32_t * bucket_count] => open addressing table (linear probing), index of entry + 1, 0 means empty
+		// [index_entry * entry_count]
+		// [index_range * range_count]
+		// Group names are not stored, they are compared with the source directly.
+
+		constexpr std::uint64_t index_magic = 0x5844'4e49'494e'4947;// "GINIINDX"
+		constexpr std::uint32_t index_version = 1;
+
+		struct index_header
+		{
+			std::uint64_t magic;
+			std::uint32_t version;
+			std::uint32_t bucket_count;
+
+			change_token source_token;
+
+			std::uint64_t entry_count;
+			std::uint64_t range_count;
+		};
+
+		struct index_entry
+		{
+			std::uint64_t name_hash;
+			std::uint64_t name_offset;
+			std::uint64_t name_size;
+			std::uint64_t first_range;
+			std::uint64_t range_count;
+		};
+
+		struct index_range
+		{
+			std::uint64_t begin;
+			std::uint64_t end;
+		};
+
+		static_assert(sizeof(index_header) % 8 == 0);
+		static_assert(sizeof(index_entry) % 8 == 0);
+		static_assert(sizeof(index_range) % 8 == 0);
+
+		// read-only memory mapping of a whole file
+		struct mapped_file
+		{
+			const char* data{nullptr};
+			std::size_t size{0};
+
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			void* file_handle{nullptr};
+			void* mapping_handle{nullptr};
+			#endif
+		};
+	}// namespace index_detail
+
+	/**
+	 * @brief Build the index of the source file, the index file is replaced atomically (write to a temporary file and rename).
+	 * @param source_path The (absolute) path to the source file (encoded in UTF-8).
+	 * @param index_path The (absolute) path to the index file.
+	 * @return Build result.
+	 */
+	[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto build_index(std::string_view source_path, std::string_view index_path) -> IndexResult;
+
+	/**
+	 * @brief A source file and its index file mapped into memory, any group can be extracted without parsing the rest of the source file.
+	 * Lookups are constant-time (hash table), only the byte range(s) of the requested group are parsed.
+	 */
+	class IndexedFile
+	{
+	public:
+		using char_type = char;
+		using string_view_type = string_view_t<char_type>;
+		using range_type = index_detail::index_range;
+
+	private:
+		index_detail::mapped_file source_;
+		index_detail::mapped_file index_;
+		// BOM
+		std::size_t source_offset_;
+
+		// views of index_
+		const index_detail::index_header* header_;
+		const std::uint32_t*              buckets_;
+		const index_detail::index_entry*  entries_;
+		const index_detail::index_range*  ranges_;
+
+		// The entry of the group, or nullptr if the group does not exist (or the entry is corrupted).
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto find(string_view_type group_name) const noexcept -> const index_detail::index_entry*;
+
+	public:
+		IndexedFile() noexcept
+			: source_{},
+			index_{},
+			source_offset_{0},
+			header_{nullptr},
+			buckets_{nullptr},
+			entries_{nullptr},
+			ranges_{nullptr} {}
+
+		IndexedFile(const IndexedFile&) = delete;
+		auto operator=(const IndexedFile&) -> IndexedFile& = delete;
+
+		GAL_INI_SYMBOL_EXPORT IndexedFile(IndexedFile&& other) noexcept;
+		GAL_INI_SYMBOL_EXPORT auto operator=(IndexedFile&& other) noexcept -> IndexedFile&;
+
+		GAL_INI_SYMBOL_EXPORT ~IndexedFile() noexcept;
+
+		/**
+		 * @brief Map the source file and its index file.
+		 * @param source_path The (absolute) path to the source file.
+		 * @param index_path The (absolute) path to the index file (see build_index).
+		 * @param validation How to check that the index file matches the source file.
+		 * @return Open result and the file (empty if the result is not SUCCESS).
+		 */
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT static auto open(
+				std::string_view source_path,
+				std::string_view index_path,
+				IndexValidation  validation = IndexValidation::METADATA) -> std::pair<IndexResult, IndexedFile>;
+
+		// The source (without BOM).
+		[[nodiscard]] auto source() const noexcept -> string_view_type { return string_view_type{source_.data, source_.size}.substr(source_offset_); }
+
+		// The number of (unique) groups.
+		[[nodiscard]] auto size() const noexcept -> std::size_t { return header_ ? static_cast<std::size_t>(header_->entry_count) : 0; }
+
+		[[nodiscard]] auto contains(const string_view_type group_name) const noexcept -> bool { return find(group_name) != nullptr; }
+
+		// The range(s) of the group in the source, empty if the group does not exist.
+		[[nodiscard]] auto ranges(const string_view_type group_name) const noexcept -> std::span<const range_type>
+		{
+			if (const auto* entry = find(group_name)) { return {ranges_ + entry->first_range, static_cast<std::size_t>(entry->range_count)}; }
+			return {};
+		}
+
+		/**
+		 * @brief Extract only the requested group.
+		 * @param group_name Name of the group.
+		 * @param group_appender How to add a new group (called once for each declaration of the group, never called if the group does not exist).
+		 * @return Extract result (SUCCESS even if the group does not exist).
+		 */
+		[[nodiscard]] auto extract_group(const string_view_type group_name, group_append_type<char_type> group_appender) const -> ExtractResult
+		{
+			for (const auto [begin, end]: ranges(group_name))
+			{
+				if (const auto result = extractor_detail::extract_from_buffer(
+							source().substr(static_cast<std::size_t>(begin), static_cast<std::size_t>(end - begin)),
+							group_appender);
+					result != ExtractResult::SUCCESS) { return result; }
+			}
+
+			return ExtractResult::SUCCESS;
+		}
+
+		/**
+		 * @brief Extract only the requested group.
+		 * @tparam ContextType Type of the output data.
+		 * @param group_name Name of the group.
+		 * @param out Where the extracted data is stored.
+		 * @return Extract result (SUCCESS even if the group does not exist).
+		 */
+		template<typename ContextType>
+		[[nodiscard]] auto extract_group(const string_view_type group_name, ContextType& out) const -> ExtractResult
+		{
+			return extractor_detail::extract_to_context(
+					out,
+					[this, group_name](const auto group_appender) -> ExtractResult { return extract_group(group_name, group_appender); });
+		}
+	};
+}// namespace gal::ini
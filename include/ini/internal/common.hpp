@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string_view>
 #include <type_traits>
 
@@ -382,6 +386,57 @@ namespace gal::ini
 
 		template<typename T, typename... Required>
 		using map_type_t = typename map_type<T>::template type<Required...>;
+
+		// Construct an object that will be stored in the container with the container's allocator (uses-allocator construction),
+		// so that an allocator-aware context (e.g. std::pmr) allocates all its nodes and strings from the same memory resource.
+		template<typename T, typename Container, typename... Args>
+		[[nodiscard]] constexpr auto make_object_for(const Container& container, Args&&... args) -> T
+		{
+			if constexpr (requires { container.get_allocator(); }) { return std::make_obj_using_allocator<T>(container.get_allocator(), std::forward<Args>(args)...); }
+			else { return T(std::forward<Args>(args)...); }
+		}
+
+		// The generation of a source (e.g. a document or a watcher) that caches can be keyed on, unique across all sources (so a source recreated at the same address never repeats one), 0 is never used.
+		[[nodiscard]] inline auto next_generation() noexcept -> std::uint64_t
+		{
+			static std::atomic<std::uint64_t> generation{0};
+			return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+
+		// A fast (non-cryptographic) 64-bit hash of the bytes, consumes 8 bytes at a time and mixes the result with the splitmix64 finalizer.
+		[[nodiscard]] inline auto hash_bytes(const void* data, const std::size_t size, const std::uint64_t seed = 0x9e37'79b9'7f4a'7c15) noexcept -> std::uint64_t
+		{
+			constexpr std::uint64_t multiplier = 0xff51'afd7'ed55'8ccd;
+
+			const auto* bytes = static_cast<const unsigned char*>(data);
+			auto        hash  = seed ^ (size * multiplier);
+
+			std::size_t i = 0;
+			for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+			{
+				std::uint64_t word;
+				std::memcpy(&word, bytes + i, sizeof(std::uint64_t));
+
+				hash = (hash ^ word) * multiplier;
+				hash ^= hash >> 32;
+			}
+
+			if (i != size)
+			{
+				std::uint64_t word = 0;
+				std::memcpy(&word, bytes + i, size - i);
+
+				hash = (hash ^ word) * multiplier;
+				hash ^= hash >> 32;
+			}
+
+			hash ^= hash >> 30;
+			hash *= 0xbf58'476d'1ce4'e5b9;
+			hash ^= hash >> 27;
+			hash *= 0x94d0'49bb'1331'11eb;
+			hash ^= hash >> 31;
+			return hash;
+		}
 	}// namespace common
 
 	template<typename>
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <ini/internal/common.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace gal::ini::common
+{
+	namespace detail
+	{
+		// Only ASCII is accepted, other characters cannot be part of a number (or a boolean) anyway.
+		template<typename Char>
+		[[nodiscard]] auto narrow(const string_view_t<Char> string) -> std::optional<std::string>
+		{
+			std::string result{};
+			result.reserve(string.size());
+			for (const auto c: string)
+			{
+				if (static_cast<std::make_unsigned_t<Char>>(c) >= 0x80) { return std::nullopt; }
+				result.push_back(static_cast<char>(c));
+			}
+			return result;
+		}
+
+		template<typename T>
+		[[nodiscard]] auto parse_arithmetic(const std::string_view string) -> std::optional<T>
+		{
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				if (string == "true" || string == "on" || string == "yes" || string == "1") { return true; }
+				if (string == "false" || string == "off" || string == "no" || string == "0") { return false; }
+				return std::nullopt;
+			}
+			else
+			{
+				T    value{};
+				auto begin = string.data();
+				// std::from_chars does not accept a leading '+'
+				if (!string.empty() && string.front() == '+')
+				{
+					++begin;
+					// "+-5" or "++5" (std::strtod would accept the second sign)
+					if (begin != string.data() + string.size() && (*begin == '-' || *begin == '+')) { return std::nullopt; }
+				}
+
+				#if defined(__cpp_lib_to_chars)
+				constexpr bool from_chars_supported = true;
+				#else
+				constexpr bool from_chars_supported = std::is_integral_v<T>;
+				#endif
+
+				if constexpr (from_chars_supported)
+				{
+					if (const auto [end, error] = std::from_chars(begin, string.data() + string.size(), value);
+						error != std::errc{} || end != string.data() + string.size()) { return std::nullopt; }
+					return value;
+				}
+				else
+				{
+					// null-terminated
+					const std::string copy{begin, string.data() + string.size()};
+					char*             end = nullptr;
+					if constexpr (std::is_same_v<T, float>) { value = std::strtof(copy.c_str(), &end); }
+					else if constexpr (std::is_same_v<T, double>) { value = std::strtod(copy.c_str(), &end); }
+					else { value = std::strtold(copy.c_str(), &end); }
+
+					if (copy.empty() || end != copy.c_str() + copy.size()) { return std::nullopt; }
+					return value;
+				}
+			}
+		}
+	}// namespace detail
+
+	/**
+	 * @brief Convert a (trimmed) value to T.
+	 * @tparam T std::basic_string<Char> (copied), bool (true/false/on/off/yes/no/1/0), an integral or a floating point type (the whole value must be a number).
+	 * @tparam Char Character type of the value.
+	 * @param string The value.
+	 * @return The converted value, or nullopt if the value cannot be converted.
+	 */
+	template<typename T, typename Char>
+	[[nodiscard]] auto from_string(const string_view_t<Char> string) -> std::optional<T>
+	{
+		if constexpr (std::is_same_v<T, std::basic_string<Char>>) { return T{string}; }
+		else if constexpr (std::is_arithmetic_v<T>)
+		{
+			if constexpr (std::is_same_v<Char, char>) { return detail::parse_arithmetic<T>(string); }
+			else
+			{
+				if (const auto narrowed = detail::narrow<Char>(string);
+					narrowed.has_value()) { return detail::parse_arithmetic<T>(*narrowed); }
+				return std::nullopt;
+			}
+		}
+		else { []<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported value type!"); }(); }
+	}
+}// namespace gal::ini::common
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <ini/internal/common.hpp>
+
+namespace gal::ini::common
+{
+	/**
+	 * @brief Find all group headers in the source without tokenizing the key-value pairs.
+	 * @tparam Char Character type of the source.
+	 * @tparam Callback auto(string_view_t<Char> group_name, std::size_t begin, std::size_t end) -> void
+	 * @param source The whole source.
+	 * @param callback Called for each (well-formed) group header in declaration order,
+	 * [begin, end) is the range of the group in the source, from the beginning of the header line to the beginning of the next header line (or the end of the source).
+	 * @note Only lines beginning with '[' (after blanks) are considered, just like the parser, a line whose header is malformed ends the previous group but does not begin a new one.
+	 */
+	template<typename Char, typename Callback>
+	constexpr auto scan_groups(const string_view_t<Char> source, Callback callback) -> void
+	{
+		constexpr auto newline = static_cast<Char>('\n');
+		constexpr auto space   = static_cast<Char>(' ');
+		constexpr auto tab     = static_cast<Char>('\t');
+
+		constexpr auto bracket_open  = square_bracket<Char>.first;
+		constexpr auto bracket_close = square_bracket<Char>.second;
+
+		constexpr auto npos = string_view_t<Char>::npos;
+
+		string_view_t<Char> current_name{};
+		std::size_t         current_begin = npos;
+
+		const auto end_current = [&](const std::size_t end) -> void
+		{
+			if (current_begin != npos) { callback(current_name, current_begin, end); }
+			current_begin = npos;
+		};
+
+		for (std::size_t line_begin = 0; line_begin < source.size();)
+		{
+			// memchr for char
+			const auto line_end  = source.find(newline, line_begin);
+			const auto next_line = line_end == npos ? source.size() : line_end + 1;
+
+			auto i = line_begin;
+			while (i < next_line && (source[i] == space || source[i] == tab)) { ++i; }
+
+			if (i < next_line && source[i] == bracket_open)
+			{
+				end_current(line_begin);
+
+				++i;
+				while (i < next_line && (source[i] == space || source[i] == tab)) { ++i; }
+
+				const auto line = source.substr(i, (line_end == npos ? source.size() : line_end) - i);
+				if (const auto close = line.find(bracket_close);
+					close != npos && close != 0)
+				{
+					current_name  = line.substr(0, close);
+					current_begin = line_begin;
+				}
+			}
+
+			line_begin = next_line;
+		}
+
+		end_current(source.size());
+	}
+}// namespace gal::ini::common
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ini/internal/common.hpp>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gal::ini
+{
+	enum class InterpolationError
+	{
+		// `${group:key}` refers to a key that does not exist (`${:key}` refers to the group whose name is empty).
+		UNRESOLVED_REFERENCE,
+		// `${NAME}` refers to an environment variable that does not exist.
+		UNRESOLVED_ENVIRONMENT,
+		// `${` without `}`.
+		MALFORMED,
+		// The value (indirectly) refers to itself.
+		CYCLE,
+		// The value (indirectly) refers to a value in a cycle, it is not expanded.
+		DEPENDS_ON_CYCLE,
+	};
+
+	template<typename Char>
+	struct interpolation_error
+	{
+		InterpolationError kind;
+
+		// The value containing the error.
+		string_view_t<Char> group;
+		string_view_t<Char> key;
+		// The offset of the `${` in the (unexpanded) value.
+		std::size_t offset;
+
+		// CYCLE only, the (group, key) of the values in the cycle, beginning and ending with this value.
+		// The other values in the cycle are not reported again, the values referring to them are reported as DEPENDS_ON_CYCLE.
+		std::vector<std::pair<string_view_t<Char>, string_view_t<Char>>> cycle;
+	};
+
+	// The errors refer to the group names and keys of the data, it must outlive the errors.
+	template<typename Char>
+	using interpolation_result_type = std::vector<interpolation_error<Char>>;
+
+	namespace interpolation_detail
+	{
+		template<typename Map, typename StringView>
+		[[nodiscard]] auto find(Map& map, const StringView key)
+		{
+			if constexpr (requires { map.find(key); }) { return map.find(key); }
+			else { return map.find(typename Map::key_type{key}); }
+		}
+
+		// std::getenv, only ASCII names and values are supported for the character types other than char.
+		template<typename Char>
+		struct environment
+		{
+			[[nodiscard]] auto operator()(const string_view_t<Char> name) const -> std::optional<std::basic_string<Char>>
+			{
+				std::string narrow_name{};
+				narrow_name.reserve(name.size());
+				for (const auto c: name) { narrow_name.push_back(static_cast<char>(c)); }
+
+				// NOLINTNEXTLINE(concurrency-mt-unsafe)
+				const char* value = std::getenv(narrow_name.c_str());
+				if (value == nullptr) { return std::nullopt; }
+
+				std::basic_string<Char> result{};
+				for (; *value != '\0'; ++value) { result.push_back(static_cast<Char>(*value)); }
+				return result;
+			}
+		};
+
+		template<typename Char>
+		struct reference
+		{
+			// [begin, end) of `${...}` in the value
+			std::size_t begin;
+			std::size_t end;
+
+			// `${NAME}` (no colon)
+			bool                environment;
+			string_view_t<Char> group;
+			// the key, or the name of the environment variable
+			string_view_t<Char> key;
+		};
+	}// namespace interpolation_detail
+
+	/**
+	 * @brief Expand the `${group:key}` and `${NAME}` (environment variable) references in the values of the data.
+	 * The references between the values form a dependency graph, the values are expanded in topological order so that each value is expanded exactly once.
+	 * Values without `${` are not touched at all.
+	 * @tparam ContextType Type of the data (any ContextType accepted by the extractor).
+	 * @tparam Environment auto(string_view_t<Char> name) -> std::optional<std::basic_string<Char>>
+	 * @param context The data, expanded in place.
+	 * @param environment Look up the environment variables (std::getenv by default).
+	 * @return The errors, empty if all references are resolved. An unresolved/malformed reference is kept verbatim, the values in a cycle (and the values referring to them) are not expanded.
+	 */
+	template<typename ContextType, typename Environment = interpolation_detail::environment<typename string_view_t<typename ContextType::key_type>::value_type>>
+	auto interpolate(ContextType& context, Environment environment = {}) -> interpolation_result_type<typename string_view_t<typename ContextType::key_type>::value_type>
+	{
+		using char_type = typename string_view_t<typename ContextType::key_type>::value_type;
+		using string_view_type = string_view_t<char_type>;
+		using string_type = std::basic_string<char_type>;
+		using value_type = typename ContextType::mapped_type::mapped_type;
+		using reference_type = interpolation_detail::reference<char_type>;
+
+		constexpr auto dollar        = static_cast<char_type>('$');
+		constexpr auto brace_open    = static_cast<char_type>('{');
+		constexpr auto brace_close   = static_cast<char_type>('}');
+		constexpr auto colon         = static_cast<char_type>(':');
+		constexpr char_type opener[] = {dollar, brace_open};
+
+		struct node
+		{
+			string_view_type group;
+			string_view_type key;
+			value_type*      value;
+
+			std::vector<reference_type> references;
+			// the nodes this node refers to
+			std::vector<std::size_t> dependencies;
+		};
+
+		interpolation_result_type<char_type> errors{};
+
+		// 1. the values containing `${`
+		std::vector<node>                                                                 nodes{};
+		std::unordered_map<string_view_type, std::unordered_map<string_view_type, std::size_t>> node_index{};
+		for (auto& [group_name, group]: context)
+		{
+			for (auto& [key, value]: group)
+			{
+				const string_view_type value_view{value};
+				if (value_view.find(string_view_type{opener, 2}) == string_view_type::npos) { continue; }
+
+				node n{.group = string_view_type{group_name}, .key = string_view_type{key}, .value = &value, .references = {}, .dependencies = {}};
+				for (auto begin = value_view.find(string_view_type{opener, 2}); begin != string_view_type::npos; begin = value_view.find(string_view_type{opener, 2}, begin))
+				{
+					const auto close = value_view.find(brace_close, begin + 2);
+					if (close == string_view_type::npos)
+					{
+						errors.push_back({.kind = InterpolationError::MALFORMED, .group = n.group, .key = n.key, .offset = begin, .cycle = {}});
+						break;
+					}
+
+					const auto name = value_view.substr(begin + 2, close - begin - 2);
+					if (const auto separator = name.find(colon);
+						separator != string_view_type::npos) { n.references.push_back({.begin = begin, .end = close + 1, .environment = false, .group = name.substr(0, separator), .key = name.substr(separator + 1)}); }
+					else { n.references.push_back({.begin = begin, .end = close + 1, .environment = true, .group = {}, .key = name}); }
+
+					begin = close + 1;
+				}
+
+				node_index[n.group][n.key] = nodes.size();
+				nodes.push_back(std::move(n));
+			}
+		}
+
+		if (nodes.empty()) { return errors; }
+
+		for (auto& n: nodes)
+		{
+			for (const auto& reference: n.references)
+			{
+				if (reference.environment) { continue; }
+
+				if (const auto group = node_index.find(reference.group);
+					group != node_index.end())
+				{
+					if (const auto it = group->second.find(reference.key);
+						it != group->second.end()) { n.dependencies.push_back(it->second); }
+				}
+			}
+		}
+
+		// 2. topological order (dependencies first), iterative DFS
+		enum class color : std::uint8_t
+		{
+			WHITE,
+			GRAY,
+			BLACK,
+		};
+
+		std::vector<color>       colors(nodes.size(), color::WHITE);
+		std::vector<bool>        in_cycle(nodes.size(), false);
+		std::vector<std::size_t> order{};
+		order.reserve(nodes.size());
+
+		// (node, next dependency)
+		std::vector<std::pair<std::size_t, std::size_t>> stack{};
+		for (std::size_t root = 0; root < nodes.size(); ++root)
+		{
+			if (colors[root] != color::WHITE) { continue; }
+
+			colors[root] = color::GRAY;
+			stack.emplace_back(root, 0);
+			while (!stack.empty())
+			{
+				auto& [current, next] = stack.back();
+				if (next == nodes[current].dependencies.size())
+				{
+					colors[current] = color::BLACK;
+					order.push_back(current);
+					stack.pop_back();
+					continue;
+				}
+
+				const auto dependency = nodes[current].dependencies[next++];
+				if (colors[dependency] == color::WHITE)
+				{
+					colors[dependency] = color::GRAY;
+					stack.emplace_back(dependency, 0);
+				}
+				else if (colors[dependency] == color::GRAY)
+				{
+					// the cycle is the part of the stack beginning with the dependency, closed by the reference of the current node
+					const auto& last  = nodes[current];
+					const auto  first = std::ranges::find(stack, dependency, [](const auto& frame) { return frame.first; });
+
+					interpolation_error<char_type> error{.kind = InterpolationError::CYCLE, .group = last.group, .key = last.key, .offset = 0, .cycle = {}};
+					error.cycle.emplace_back(last.group, last.key);
+					for (auto it = first; it != stack.end(); ++it)
+					{
+						in_cycle[it->first] = true;
+						error.cycle.emplace_back(nodes[it->first].group, nodes[it->first].key);
+					}
+
+					if (const auto reference = std::ranges::find_if(last.references, [&](const reference_type& r) { return !r.environment && r.group == nodes[dependency].group && r.key == nodes[dependency].key; });
+						reference != last.references.end()) { error.offset = reference->begin; }
+
+					errors.push_back(std::move(error));
+				}
+			}
+		}
+
+		// 3. expand, the dependencies have been expanded before
+		// in a cycle, or refers to a value that is not expanded
+		std::vector<bool> blocked{in_cycle};
+		for (const auto index: order)
+		{
+			auto& n = nodes[index];
+			if (in_cycle[index]) { continue; }
+
+			if (const auto dependency = std::ranges::find_if(n.dependencies, [&](const std::size_t d) { return blocked[d]; });
+				dependency != n.dependencies.end())
+			{
+				blocked[index] = true;
+
+				interpolation_error<char_type> error{.kind = InterpolationError::DEPENDS_ON_CYCLE, .group = n.group, .key = n.key, .offset = 0, .cycle = {}};
+				if (const auto reference = std::ranges::find_if(n.references, [&](const reference_type& r) { return !r.environment && r.group == nodes[*dependency].group && r.key == nodes[*dependency].key; });
+					reference != n.references.end()) { error.offset = reference->begin; }
+
+				errors.push_back(std::move(error));
+				continue;
+			}
+
+			const string_view_type value_view{*n.value};
+
+			string_type expanded{};
+			expanded.reserve(value_view.size());
+
+			std::size_t cursor = 0;
+			for (const auto& reference: n.references)
+			{
+				expanded.append(value_view.substr(cursor, reference.begin - cursor));
+				cursor = reference.end;
+
+				if (reference.environment)
+				{
+					if (const auto variable = environment(reference.key);
+						variable.has_value()) { expanded.append(*variable); }
+					else
+					{
+						errors.push_back({.kind = InterpolationError::UNRESOLVED_ENVIRONMENT, .group = n.group, .key = n.key, .offset = reference.begin, .cycle = {}});
+						expanded.append(value_view.substr(reference.begin, reference.end - reference.begin));
+					}
+					continue;
+				}
+
+				if (const auto group = interpolation_detail::find(context, reference.group);
+					group != context.end())
+				{
+					if (const auto it = interpolation_detail::find(group->second, reference.key);
+						it != group->second.end())
+					{
+						expanded.append(string_view_type{it->second});
+						continue;
+					}
+				}
+
+				errors.push_back({.kind = InterpolationError::UNRESOLVED_REFERENCE, .group = n.group, .key = n.key, .offset = reference.begin, .cycle = {}});
+				expanded.append(value_view.substr(reference.begin, reference.end - reference.begin));
+			}
+			expanded.append(value_view.substr(cursor));
+
+			n.value->assign(expanded.data(), expanded.size());
+		}
+
+		return errors;
+	}
+}// namespace gal::ini
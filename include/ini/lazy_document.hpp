@@ -0,0 +1,468 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <ini/extractor.hpp>
+#include <ini/internal/group_scanner.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace gal::ini
+{
+	/**
+	 * @brief A document that only knows where its groups are until they are accessed.
+	 * The constructor only scans the group headers (cost is proportional to the number of lines, no key-value pair is tokenized),
+	 * the key-value pairs of a group are extracted on first access and cached (thread-safe).
+	 * @tparam Char Character type of the source.
+	 * @note All names, keys and values are views of the source owned by the document.
+	 */
+	template<typename Char>
+	class LazyDocument
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+		// [begin, end) of the source
+		struct source_range
+		{
+			std::size_t begin;
+			std::size_t end;
+		};
+
+		// Replace [begin, end) of the source with the replacement.
+		struct text_edit
+		{
+			std::size_t      begin;
+			std::size_t      end;
+			string_view_type replacement;
+		};
+
+		class Group
+		{
+			friend LazyDocument;
+
+		public:
+			using value_type = std::pair<string_view_type, string_view_type>;
+			using const_iterator = typename std::vector<value_type>::const_iterator;
+
+		private:
+			string_view_type name_;
+			// declaration order
+			std::vector<value_type>                           values_;
+			std::unordered_map<string_view_type, std::size_t> index_;
+
+		public:
+			[[nodiscard]] auto name() const noexcept -> string_view_type { return name_; }
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t { return values_.size(); }
+
+			[[nodiscard]] auto empty() const noexcept -> bool { return values_.empty(); }
+
+			[[nodiscard]] auto begin() const noexcept -> const_iterator { return values_.begin(); }
+
+			[[nodiscard]] auto end() const noexcept -> const_iterator { return values_.end(); }
+
+			[[nodiscard]] auto find(const string_view_type key) const -> const_iterator
+			{
+				if (const auto it = index_.find(key);
+					it != index_.end()) { return values_.begin() + static_cast<typename std::vector<value_type>::difference_type>(it->second); }
+				return values_.end();
+			}
+
+			[[nodiscard]] auto contains(const string_view_type key) const -> bool { return index_.contains(key); }
+		};
+
+	private:
+		struct group_slot
+		{
+			string_view_type name;
+			// A group can be declared more than once, subsequent elements are appended to the previously declared group.
+			std::vector<source_range> ranges;
+
+			std::once_flag    once;
+			std::atomic<bool> materialized{false};
+			Group             group;
+
+			// 0 => not computed yet
+			std::atomic<std::uint64_t> raw_hash{0};
+		};
+
+		// A part of the source, the segments cover the whole source in order.
+		struct segment
+		{
+			// empty => the text does not belong to any group (before the first group, or after a malformed group header)
+			string_view_type name;
+			source_range     range;
+		};
+
+		// The views refer to the source, it must not move with the document.
+		std::unique_ptr<string_type> source_;
+		std::vector<segment>         segments_;
+		std::uint64_t                generation_;
+
+		std::unique_ptr<group_slot[]>                     slots_;
+		std::vector<string_view_type>                     names_;
+		std::unordered_map<string_view_type, std::size_t> index_;
+
+		auto materialize(group_slot& slot) const -> void
+		{
+			Group& group = slot.group;
+			group.name_  = slot.name;
+
+			// !!!MUST PLACE HERE!!!
+			// see extractor_detail::extract_to_context
+			auto kv_appender = [&group](const string_view_type key, const string_view_type value) -> std::pair<std::pair<string_view_type, string_view_type>, bool>
+			{
+				if (const auto [it, inserted] = group.index_.emplace(key, group.values_.size());
+					!inserted) { return {group.values_[it->second], false}; }
+
+				return {group.values_.emplace_back(key, value), true};
+			};
+
+			bool first_range = true;
+			auto group_appender = [&group, &kv_appender, &first_range](const string_view_type) -> group_append_result<char_type>
+			{
+				const auto inserted = std::exchange(first_range, false);
+				return {
+						.name = group.name_,
+						.kv_appender = kv_appender,
+						.inserted = inserted};
+			};
+
+			for (const auto [begin, end]: slot.ranges)
+			{
+				// The slice contains exactly one group, and the parser never fails.
+				(void)extractor_detail::extract_from_buffer(
+						string_view_type{*source_}.substr(begin, end - begin),
+						group_append_type<char_type>{group_appender});
+			}
+
+			slot.materialized.store(true, std::memory_order_release);
+		}
+
+		// Split [begin, end) of the source into segments, begin and end must be the beginning of a line (or the end of the source).
+		static auto scan_segments(const string_view_type source, const std::size_t begin, const std::size_t end, std::vector<segment>& out) -> void
+		{
+			std::size_t cursor = begin;
+			common::scan_groups<char_type>(
+					source.substr(begin, end - begin),
+					[begin, &cursor, &out](const string_view_type name, const std::size_t group_begin, const std::size_t group_end) -> void
+					{
+						if (begin + group_begin != cursor) { out.push_back({.name = {}, .range = {cursor, begin + group_begin}}); }
+						out.push_back({.name = name, .range = {begin + group_begin, begin + group_end}});
+						cursor = begin + group_end;
+					});
+			if (cursor != end) { out.push_back({.name = {}, .range = {cursor, end}}); }
+		}
+
+		// Build the (empty) slots of the groups from the segments.
+		auto index_segments() -> void
+		{
+			names_.clear();
+			index_.clear();
+			for (const auto& [name, range]: segments_)
+			{
+				if (name.empty()) { continue; }
+				if (index_.emplace(name, names_.size()).second) { names_.push_back(name); }
+			}
+
+			// group_slot is neither copyable nor movable (std::once_flag)
+			slots_ = std::make_unique<group_slot[]>(names_.size());
+			for (const auto& [name, range]: segments_)
+			{
+				if (name.empty()) { continue; }
+
+				auto& slot = slots_[index_.find(name)->second];
+				if (slot.ranges.empty()) { slot.name = name; }
+				slot.ranges.push_back(range);
+			}
+		}
+
+		auto scan() -> void
+		{
+			segments_.clear();
+			scan_segments(*source_, 0, source_->size(), segments_);
+			index_segments();
+		}
+
+	public:
+		/**
+		 * @brief Scan the group headers of the source.
+		 * @param source The source, owned by the document.
+		 */
+		explicit LazyDocument(string_type source)
+			: source_{std::make_unique<string_type>(std::move(source))},
+			generation_{common::next_generation()}
+		{
+			scan();
+		}
+
+		/**
+		 * @brief Read the file and scan the group headers of it.
+		 * @param file_path The (absolute) path to the file.
+		 * @return Extract result and the document (empty if the file cannot be read).
+		 */
+		[[nodiscard]] static auto from_file(const std::string_view file_path) -> std::pair<ExtractResult, LazyDocument>
+		{
+			string_type source{};
+			const auto  result = extractor_detail::read_file(file_path, source);
+			return {result, LazyDocument{std::move(source)}};
+		}
+
+		[[nodiscard]] auto source() const noexcept -> string_view_type { return *source_; }
+
+		// Changes with each apply_edits, unique across all documents.
+		[[nodiscard]] auto generation() const noexcept -> std::uint64_t { return generation_; }
+
+		// The number of (unique) groups.
+		[[nodiscard]] auto size() const noexcept -> std::size_t { return names_.size(); }
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return names_.empty(); }
+
+		// The names of all groups in declaration order.
+		[[nodiscard]] auto names() const noexcept -> std::span<const string_view_type> { return names_; }
+
+		[[nodiscard]] auto contains(const string_view_type group_name) const -> bool { return index_.contains(group_name); }
+
+		// The range(s) of the group in the source, empty if the group does not exist.
+		[[nodiscard]] auto ranges(const string_view_type group_name) const -> std::span<const source_range>
+		{
+			if (const auto it = index_.find(group_name);
+				it != index_.end()) { return slots_[it->second].ranges; }
+			return {};
+		}
+
+		// Whether the key-value pairs of the group have been extracted.
+		[[nodiscard]] auto materialized(const string_view_type group_name) const -> bool
+		{
+			if (const auto it = index_.find(group_name);
+				it != index_.end()) { return slots_[it->second].materialized.load(std::memory_order_acquire); }
+			return false;
+		}
+
+		/**
+		 * @brief Hash of the raw bytes of the group in the source (computed on first call and cached, the group is not extracted).
+		 * @param group_name Name of the group.
+		 * @return The hash, 0 if the group does not exist.
+		 * @note Groups with equal raw hashes have the same key-value pairs, but groups with different raw hashes may still have the same key-value pairs (e.g. only a comment has changed).
+		 */
+		[[nodiscard]] auto raw_hash(const string_view_type group_name) const -> std::uint64_t
+		{
+			const auto it = index_.find(group_name);
+			if (it == index_.end()) { return 0; }
+
+			auto& slot = slots_[it->second];
+			if (const auto hash = slot.raw_hash.load(std::memory_order_relaxed);
+				hash != 0) { return hash; }
+
+			// Racing threads compute the same value.
+			std::uint64_t hash = 0;
+			for (const auto [begin, end]: slot.ranges) { hash = common::hash_bytes(source_->data() + begin, (end - begin) * sizeof(char_type), hash); }
+			// 0 is reserved
+			hash |= 1;
+
+			slot.raw_hash.store(hash, std::memory_order_relaxed);
+			return hash;
+		}
+
+		/**
+		 * @brief Apply text edits to the source and update the document in place.
+		 * Only the groups touched by the edits are scanned again (and extracted again on next access),
+		 * the ranges of the other groups are shifted and their extracted key-value pairs are kept.
+		 * The result is the same as constructing a new document from the edited source.
+		 * @param edits The edits, the offsets refer to the current source and the edits must not overlap (any order).
+		 * @return Whether the edits were applied (false if they overlap or are out of range, the document is unchanged).
+		 * @note Not thread-safe, all views, ranges and groups obtained from the document before are invalidated.
+		 */
+		auto apply_edits(const std::span<const text_edit> edits) -> bool
+		{
+			constexpr auto newline = static_cast<char_type>('\n');
+
+			// edits at the same offset (insertions) are applied in the given order
+			std::vector<text_edit> sorted{edits.begin(), edits.end()};
+			std::ranges::stable_sort(sorted, {}, &text_edit::begin);
+
+			const string_view_type old_source{*source_};
+			for (std::size_t i = 0; i < sorted.size(); ++i)
+			{
+				if (sorted[i].begin > sorted[i].end || sorted[i].end > old_source.size()) { return false; }
+				if (i != 0 && sorted[i].begin < sorted[i - 1].end) { return false; }
+			}
+			if (sorted.empty()) { return true; }
+
+			// shifts[i] => the size difference caused by the first i edits
+			std::vector<std::ptrdiff_t> shifts(sorted.size() + 1, 0);
+			for (std::size_t i = 0; i < sorted.size(); ++i)
+			{
+				shifts[i + 1] = shifts[i] + static_cast<std::ptrdiff_t>(sorted[i].replacement.size()) - static_cast<std::ptrdiff_t>(sorted[i].end - sorted[i].begin);
+			}
+			const auto shifted = [](const std::size_t offset, const std::ptrdiff_t shift) -> std::size_t { return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset) + shift); };
+
+			auto source = std::make_unique<string_type>();
+			source->reserve(shifted(old_source.size(), shifts.back()));
+			{
+				std::size_t cursor = 0;
+				for (const auto& [begin, end, replacement]: sorted)
+				{
+					source->append(old_source.substr(cursor, begin - cursor));
+					source->append(replacement);
+					cursor = end;
+				}
+				source->append(old_source.substr(cursor));
+			}
+
+			// The segments touched by the edits, they begin and end at a header line that is not edited.
+			struct window
+			{
+				std::size_t first_segment;
+				std::size_t last_segment;
+				std::size_t first_edit;
+				std::size_t last_edit;
+			};
+
+			std::vector<window> windows{};
+			if (!segments_.empty())
+			{
+				// the last segment contains the end of the source
+				const auto segment_at = [this](const std::size_t offset) -> std::size_t
+				{
+					const auto it = std::ranges::upper_bound(segments_, offset, {}, [](const segment& s) -> std::size_t { return s.range.begin; });
+					return static_cast<std::size_t>(it - segments_.begin()) - 1;
+				};
+
+				for (std::size_t i = 0; i < sorted.size(); ++i)
+				{
+					auto       first = segment_at(sorted[i].begin);
+					const auto last  = segment_at(sorted[i].end);
+
+					// If the header line is edited, the text may belong to the previous group now.
+					if (first != 0 && sorted[i].begin <= old_source.find(newline, segments_[first].range.begin)) { --first; }
+
+					if (!windows.empty() && first <= windows.back().last_segment)
+					{
+						windows.back().last_segment = std::ranges::max(windows.back().last_segment, last);
+						windows.back().last_edit    = i;
+					}
+					else { windows.push_back({.first_segment = first, .last_segment = last, .first_edit = i, .last_edit = i}); }
+				}
+			}
+
+			// A view outside the edits, it is shifted by the size difference caused by the edits before it.
+			const auto relocate = [&sorted, &shifts, &shifted, &old_source, new_data = source->data()](const string_view_type view) -> string_view_type
+			{
+				if (view.data() < old_source.data() || view.data() > old_source.data() + old_source.size()) { return view; }
+
+				const auto offset = static_cast<std::size_t>(view.data() - old_source.data());
+				const auto it     = std::ranges::upper_bound(sorted, offset, {}, &text_edit::begin);
+				return {new_data + shifted(offset, shifts[static_cast<std::size_t>(it - sorted.begin())]), view.size()};
+			};
+
+			// The names of the groups whose ranges have changed (views of the old or the new source).
+			std::unordered_set<string_view_type> affected{};
+
+			std::vector<segment> segments{};
+			segments.reserve(segments_.size());
+
+			std::size_t next_segment = 0;
+			const auto  keep_until   = [&](const std::size_t until, const std::ptrdiff_t shift) -> void
+			{
+				for (; next_segment < until; ++next_segment)
+				{
+					const auto& [name, range] = segments_[next_segment];
+					segments.push_back({.name = relocate(name), .range = {shifted(range.begin, shift), shifted(range.end, shift)}});
+				}
+			};
+
+			for (const auto& [first_segment, last_segment, first_edit, last_edit]: windows)
+			{
+				keep_until(first_segment, shifts[first_edit]);
+
+				for (auto i = first_segment; i <= last_segment; ++i)
+				{
+					if (!segments_[i].name.empty()) { affected.insert(segments_[i].name); }
+				}
+
+				const auto first_new = segments.size();
+				scan_segments(
+						*source,
+						shifted(segments_[first_segment].range.begin, shifts[first_edit]),
+						shifted(segments_[last_segment].range.end, shifts[last_edit + 1]),
+						segments);
+				for (auto i = first_new; i < segments.size(); ++i)
+				{
+					if (!segments[i].name.empty()) { affected.insert(segments[i].name); }
+				}
+
+				next_segment = last_segment + 1;
+			}
+			keep_until(segments_.size(), shifts.back());
+
+			// empty source => no segment
+			if (segments_.empty()) { scan_segments(*source, 0, source->size(), segments); }
+
+			// The old source must outlive the old slots (and the affected names).
+			const auto old_source_holder = std::exchange(source_, std::move(source));
+			const auto old_slots         = std::exchange(slots_, nullptr);
+			const auto old_index         = std::exchange(index_, {});
+
+			segments_   = std::move(segments);
+			generation_ = common::next_generation();
+			index_segments();
+
+			// The groups that are not affected keep their state.
+			for (std::size_t i = 0; i < names_.size(); ++i)
+			{
+				if (affected.contains(names_[i])) { continue; }
+
+				const auto it = old_index.find(names_[i]);
+				if (it == old_index.end()) { continue; }
+
+				auto& old_slot = old_slots[it->second];
+				auto& slot     = slots_[i];
+
+				slot.raw_hash.store(old_slot.raw_hash.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				if (!old_slot.materialized.load(std::memory_order_acquire)) { continue; }
+
+				Group& group = slot.group;
+				group        = std::move(old_slot.group);
+				group.name_  = slot.name;
+				group.index_.clear();
+				for (std::size_t k = 0; k < group.values_.size(); ++k)
+				{
+					auto& [key, value] = group.values_[k];
+					key                = relocate(key);
+					value              = relocate(value);
+					group.index_.emplace(key, k);
+				}
+
+				std::call_once(slot.once, [&slot] { slot.materialized.store(true, std::memory_order_release); });
+			}
+
+			return true;
+		}
+
+		/**
+		 * @brief Get the group, its key-value pairs are extracted on first access (thread-safe).
+		 * @param group_name Name of the group.
+		 * @return The group, or nullptr if the group does not exist.
+		 */
+		[[nodiscard]] auto group(const string_view_type group_name) const -> const Group*
+		{
+			const auto it = index_.find(group_name);
+			if (it == index_.end()) { return nullptr; }
+
+			auto& slot = slots_[it->second];
+			std::call_once(slot.once, [this, &slot] { materialize(slot); });
+			return &slot.group;
+		}
+	};
+}// namespace gal::ini
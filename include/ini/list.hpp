@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <ini/internal/common.hpp>
+#include <ini/internal/convert.hpp>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define GAL_INI_LIST_SSE2
+	#include <emmintrin.h>
+#endif
+
+namespace gal::ini
+{
+	enum class ListResult
+	{
+		SUCCESS,
+		// An element cannot be converted (or is empty).
+		INVALID_ELEMENT,
+		// The output is too small, the remaining elements are not converted.
+		OUTPUT_TOO_SMALL,
+	};
+
+	struct list_result
+	{
+		ListResult result;
+		// The number of the converted elements, which is also the index of the element that failed (if any).
+		std::size_t size;
+
+		[[nodiscard]] constexpr auto operator==(const list_result& other) const noexcept -> bool = default;
+	};
+
+	namespace list_detail
+	{
+		template<typename Char>
+		[[nodiscard]] constexpr auto is_blank(const Char c) noexcept -> bool { return c == static_cast<Char>(' ') || c == static_cast<Char>('\t'); }
+
+		template<typename Char>
+		[[nodiscard]] constexpr auto trim(string_view_t<Char> string) noexcept -> string_view_t<Char>
+		{
+			while (!string.empty() && is_blank(string.front())) { string.remove_prefix(1); }
+			while (!string.empty() && is_blank(string.back())) { string.remove_suffix(1); }
+			return string;
+		}
+
+		/**
+		 * @brief Find the first delimiter in [begin, end), 16 bytes at a time if SSE2 is available.
+		 * @return The delimiter, or end.
+		 */
+		template<typename Char>
+		[[nodiscard]] auto find_delimiter(const Char* begin, const Char* end, const Char delimiter) noexcept -> const Char*
+		{
+			#if defined(GAL_INI_LIST_SSE2)
+			if constexpr (sizeof(Char) == 1 || sizeof(Char) == 2 || sizeof(Char) == 4)
+			{
+				constexpr auto lanes = 16 / sizeof(Char);
+
+				__m128i pattern;
+				if constexpr (sizeof(Char) == 1) { pattern = _mm_set1_epi8(static_cast<char>(delimiter)); }
+				else if constexpr (sizeof(Char) == 2) { pattern = _mm_set1_epi16(static_cast<short>(delimiter)); }
+				else { pattern = _mm_set1_epi32(static_cast<int>(delimiter)); }
+
+				for (; static_cast<std::size_t>(end - begin) >= lanes; begin += lanes)
+				{
+					const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+					__m128i equal;
+					if constexpr (sizeof(Char) == 1) { equal = _mm_cmpeq_epi8(block, pattern); }
+					else if constexpr (sizeof(Char) == 2) { equal = _mm_cmpeq_epi16(block, pattern); }
+					else { equal = _mm_cmpeq_epi32(block, pattern); }
+
+					// one bit per byte
+					if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(equal));
+						mask != 0) { return begin + std::countr_zero(mask) / sizeof(Char); }
+				}
+			}
+			#endif
+
+			return std::find(begin, end, delimiter);
+		}
+
+		// Call the functor for each (trimmed) element, until it returns false.
+		template<typename Char, typename Functor>
+		auto for_each_element(const string_view_t<Char> value, const Char delimiter, Functor functor) -> void
+		{
+			if (trim<Char>(value).empty()) { return; }
+
+			const auto* current = value.data();
+			const auto* end     = value.data() + value.size();
+			while (true)
+			{
+				const auto* next = find_delimiter(current, end, delimiter);
+				if (!functor(trim<Char>({current, static_cast<std::size_t>(next - current)}))) { return; }
+				if (next == end) { return; }
+				current = next + 1;
+			}
+		}
+
+		template<typename T, typename Char>
+		[[nodiscard]] auto convert(const string_view_t<Char> element) -> std::optional<T>
+		{
+			if constexpr (std::is_same_v<T, string_view_t<Char>>) { return element; }
+			else
+			{
+				if (element.empty()) { return std::nullopt; }
+				return common::from_string<T, Char>(element);
+			}
+		}
+	}// namespace list_detail
+
+	/**
+	 * @brief The number of elements of the list (the number of delimiters + 1, 0 if the value is blank).
+	 * @tparam Char Character type of the value.
+	 * @param value The value.
+	 * @param delimiter Separator of the elements.
+	 * @return The number of elements.
+	 */
+	template<typename Char>
+	[[nodiscard]] auto list_size(const std::basic_string_view<Char> value, const std::type_identity_t<Char> delimiter = static_cast<Char>(',')) -> std::size_t
+	{
+		std::size_t size = 0;
+		list_detail::for_each_element<Char>(
+				value,
+				delimiter,
+				[&size](const auto) -> bool
+				{
+					size += 1;
+					return true;
+				});
+		return size;
+	}
+
+	/**
+	 * @brief Split the value on the delimiter, trim each element and convert it, in one pass over the value.
+	 * @tparam T string_view_t<Char> (a view of the value), bool, an integral or a floating point type (see common::from_string).
+	 * @tparam Char Character type of the value.
+	 * @param value The value.
+	 * @param out Where the converted elements are stored (see `list_size`).
+	 * @param delimiter Separator of the elements.
+	 * @return The result and the number of the converted elements.
+	 */
+	template<typename T, typename Char>
+	auto split_list(const std::basic_string_view<Char> value, const std::span<T> out, const std::type_identity_t<Char> delimiter = static_cast<Char>(',')) -> list_result
+	{
+		list_result result{.result = ListResult::SUCCESS, .size = 0};
+		list_detail::for_each_element<Char>(
+				value,
+				delimiter,
+				[&result, out](const string_view_t<Char> element) -> bool
+				{
+					if (result.size == out.size())
+					{
+						result.result = ListResult::OUTPUT_TOO_SMALL;
+						return false;
+					}
+
+					const auto converted = list_detail::convert<T, Char>(element);
+					if (!converted.has_value())
+					{
+						result.result = ListResult::INVALID_ELEMENT;
+						return false;
+					}
+
+					out[result.size] = *converted;
+					result.size += 1;
+					return true;
+				});
+		return result;
+	}
+
+	/**
+	 * @brief Split the value on the delimiter, trim each element and convert it, in one pass over the value.
+	 * @tparam T string_view_t<Char> (a view of the value), bool, an integral or a floating point type (see common::from_string).
+	 * @tparam Allocator Allocator of the output (e.g. std::pmr::polymorphic_allocator for an arena).
+	 * @tparam Char Character type of the value.
+	 * @param value The value.
+	 * @param out Where the converted elements are appended.
+	 * @param delimiter Separator of the elements.
+	 * @return The result and the number of the converted (appended) elements.
+	 */
+	template<typename T, typename Allocator, typename Char>
+	auto split_list(const std::basic_string_view<Char> value, std::vector<T, Allocator>& out, const std::type_identity_t<Char> delimiter = static_cast<Char>(',')) -> list_result
+	{
+		list_result result{.result = ListResult::SUCCESS, .size = 0};
+		list_detail::for_each_element<Char>(
+				value,
+				delimiter,
+				[&result, &out](const string_view_t<Char> element) -> bool
+				{
+					const auto converted = list_detail::convert<T, Char>(element);
+					if (!converted.has_value())
+					{
+						result.result = ListResult::INVALID_ELEMENT;
+						return false;
+					}
+
+					out.push_back(*converted);
+					result.size += 1;
+					return true;
+				});
+		return result;
+	}
+}// namespace gal::ini
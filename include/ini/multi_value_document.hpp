@@ -0,0 +1,158 @@
+#pragma once
+
+#include <functional>
+#include <ini/extractor.hpp>
+#include <ini/internal/common.hpp>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gal::ini
+{
+	namespace multi_value_detail
+	{
+		// `key[]` => `key`
+		template<typename Char>
+		[[nodiscard]] constexpr auto normalize_key(const string_view_t<Char> key) noexcept -> string_view_t<Char>
+		{
+			constexpr Char suffix[] = {static_cast<Char>('['), static_cast<Char>(']')};
+			if (key.size() > 2 && key.ends_with(string_view_t<Char>{suffix, 2})) { return key.substr(0, key.size() - 2); }
+			return key;
+		}
+	}// namespace multi_value_detail
+
+	/**
+	 * @brief A document where a repeated key (`server = a`, `server = b`, or `server[] = a`) appends to the values of the key instead of being discarded.
+	 * The values of a key are stored contiguously, and consecutive values of the same key are appended without looking up (hashing) the key again.
+	 * @tparam Char Character type of the data.
+	 * @note `key[]` and `key` are the same key.
+	 */
+	template<typename Char>
+	class MultiValueDocument
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+		using values_type = std::vector<string_type>;
+
+	private:
+		struct string_hasher
+		{
+			using is_transparent = int;
+
+			[[nodiscard]] auto operator()(const string_view_type string) const noexcept -> std::size_t { return std::hash<string_view_type>{}(string); }
+		};
+
+	public:
+		using group_type = std::unordered_map<string_type, values_type, string_hasher, std::equal_to<>>;
+		using context_type = std::unordered_map<string_type, group_type, string_hasher, std::equal_to<>>;
+
+	private:
+		context_type groups_;
+
+		template<typename Extractor>
+		auto extract(Extractor extractor) -> ExtractResult
+		{
+			// We need the following temporary variables to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
+			group_type* current_group = nullptr;
+			// the key of the last value, its values are appended directly
+			string_view_type last_key{};
+			values_type*     last_values = nullptr;
+
+			// !!!MUST PLACE HERE!!!
+			// see extractor_detail::extract_to_context
+			auto kv_appender = [&current_group, &last_key, &last_values](const string_view_type key, const string_view_type value) -> std::pair<std::pair<string_view_type, string_view_type>, bool>
+			{
+				const auto normalized_key = multi_value_detail::normalize_key<char_type>(key);
+
+				if (last_values == nullptr || normalized_key != last_key)
+				{
+					auto it = current_group->find(normalized_key);
+					if (it == current_group->end()) { it = current_group->emplace(normalized_key, values_type{}).first; }
+
+					last_key    = it->first;
+					last_values = &it->second;
+				}
+
+				last_values->emplace_back(value);
+				// never a duplicate
+				return {{last_key, last_values->back()}, true};
+			};
+
+			auto group_appender = [this, &current_group, &last_values, &kv_appender](const string_view_type group_name) -> group_append_result<char_type>
+			{
+				#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+				const auto workaround_emplace_result = groups_.try_emplace(string_type{group_name});
+				const auto group_it                  = workaround_emplace_result.first;
+				const auto group_inserted            = workaround_emplace_result.second;
+				#else
+				const auto [group_it, group_inserted] = groups_.try_emplace(string_type{group_name});
+				#endif
+
+				current_group = &group_it->second;
+				last_values   = nullptr;
+
+				return {
+						.name = group_it->first,
+						.kv_appender = kv_appender,
+						.inserted = group_inserted};
+			};
+
+			return extractor(group_append_type<char_type>{group_appender});
+		}
+
+	public:
+		MultiValueDocument() = default;
+
+		/**
+		 * @brief Extract ini data from files (appended to the existing data).
+		 * @param file_path The (absolute) path to the file.
+		 * @return Extract result.
+		 */
+		auto extract_from_file(const std::string_view file_path) -> ExtractResult
+		{
+			return extract([file_path](const auto group_appender) -> ExtractResult { return extractor_detail::extract_from_file(file_path, group_appender); });
+		}
+
+		/**
+		 * @brief Extract ini data from buffer (appended to the existing data).
+		 * @param buffer The buffer.
+		 * @return Extract result.
+		 */
+		auto extract_from_buffer(const string_view_type buffer) -> ExtractResult
+		{
+			return extract([buffer](const auto group_appender) -> ExtractResult { return extractor_detail::extract_from_buffer(buffer, group_appender); });
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t { return groups_.size(); }
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return groups_.empty(); }
+
+		[[nodiscard]] auto begin() const noexcept -> typename context_type::const_iterator { return groups_.begin(); }
+
+		[[nodiscard]] auto end() const noexcept -> typename context_type::const_iterator { return groups_.end(); }
+
+		[[nodiscard]] auto contains(const string_view_type group_name) const -> bool { return groups_.contains(group_name); }
+
+		/**
+		 * @brief Get the values of the key, in the order they appear.
+		 * @param group_name Name of the group.
+		 * @param key The key (`key[]` is the same as `key`).
+		 * @return The values, empty if the key does not exist.
+		 */
+		[[nodiscard]] auto get(const string_view_type group_name, const string_view_type key) const -> std::span<const string_type>
+		{
+			if (const auto group = groups_.find(group_name);
+				group != groups_.end())
+			{
+				if (const auto it = group->second.find(multi_value_detail::normalize_key<char_type>(key));
+					it != group->second.end()) { return it->second; }
+			}
+			return {};
+		}
+	};
+}// namespace gal::ini
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <ini/internal/common.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace gal::ini
+{
+	/**
+	 * @brief The lines of a value continued on the next lines, as extracted (a backslash at the end of a line, or an indented next line).
+	 * The segments are views of the extracted value (e.g. of the source of a LazyDocument), nothing is copied until `join` is called.
+	 * @tparam Char Character type of the value.
+	 * @note The value must outlive the MultilineValue.
+	 */
+	template<typename Char>
+	class MultilineValue
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+		struct segment
+		{
+			// The line without the backslash, the newline and the indentation.
+			string_view_type text;
+			// Whether the segment is joined to the previous one with a newline (indented continuation) or directly (backslash continuation).
+			bool newline_before;
+		};
+
+	private:
+		constexpr static auto newline         = static_cast<char_type>('\n');
+		constexpr static auto carriage_return = static_cast<char_type>('\r');
+		constexpr static auto backslash       = static_cast<char_type>('\\');
+		constexpr static auto space           = static_cast<char_type>(' ');
+		constexpr static auto tab             = static_cast<char_type>('\t');
+
+		std::vector<segment> segments_;
+
+	public:
+		/**
+		 * @brief Split the value into its lines.
+		 * @param value The value (as extracted).
+		 */
+		explicit MultilineValue(string_view_type value)
+		{
+			bool newline_before = false;
+			while (true)
+			{
+				const auto line_end = value.find(newline);
+				if (line_end == string_view_type::npos)
+				{
+					segments_.push_back({.text = value, .newline_before = newline_before});
+					return;
+				}
+
+				auto line = value.substr(0, line_end);
+				if (!line.empty() && line.back() == carriage_return) { line.remove_suffix(1); }
+
+				// the continuation of the next line
+				const bool backslash_continuation = !line.empty() && line.back() == backslash;
+				if (backslash_continuation) { line.remove_suffix(1); }
+
+				segments_.push_back({.text = line, .newline_before = newline_before});
+				newline_before = !backslash_continuation;
+
+				value.remove_prefix(line_end + 1);
+				while (!value.empty() && (value.front() == space || value.front() == tab)) { value.remove_prefix(1); }
+			}
+		}
+
+		[[nodiscard]] auto segments() const noexcept -> std::span<const segment> { return segments_; }
+
+		[[nodiscard]] auto is_multiline() const noexcept -> bool { return segments_.size() > 1; }
+
+		// The size of the joined value.
+		[[nodiscard]] auto size() const noexcept -> std::size_t
+		{
+			std::size_t size = 0;
+			for (const auto& [text, newline_before]: segments_) { size += text.size() + (newline_before ? 1 : 0); }
+			return size;
+		}
+
+		// Append the joined value.
+		auto join_to(string_type& out) const -> void
+		{
+			out.reserve(out.size() + size());
+			for (const auto& [text, newline_before]: segments_)
+			{
+				if (newline_before) { out.push_back(newline); }
+				out.append(text);
+			}
+		}
+
+		[[nodiscard]] auto join() const -> string_type
+		{
+			string_type result{};
+			join_to(result);
+			return result;
+		}
+	};
+}// namespace gal::ini
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <ini/internal/common.hpp>
+#include <optional>
+#include <vector>
+
+namespace gal::ini
+{
+	namespace overlay_detail
+	{
+		template<typename Map, typename StringView>
+		[[nodiscard]] auto find(const Map& map, const StringView key)
+		{
+			if constexpr (requires { map.find(key); }) { return map.find(key); }
+			else { return map.find(typename Map::key_type{key}); }
+		}
+
+		template<typename Char>
+		[[nodiscard]] auto hash_key(const string_view_t<Char> group_name, const string_view_t<Char> key) noexcept -> std::uint64_t
+		{
+			return common::hash_bytes(key.data(), key.size() * sizeof(Char), common::hash_bytes(group_name.data(), group_name.size() * sizeof(Char)));
+		}
+
+		/**
+		 * @brief A Bloom filter of (group, key) hashes, a miss means the key is definitely not in the layer.
+		 * ~10 bits per key and 4 probes => ~1% false positives.
+		 */
+		class bloom_filter
+		{
+			constexpr static std::size_t bits_per_key = 10;
+			constexpr static std::size_t probes       = 4;
+
+			std::vector<std::uint64_t> bits_;
+			// bits_.size() * 64 - 1 (power of 2)
+			std::uint64_t mask_;
+
+		public:
+			bloom_filter() noexcept
+				: mask_{0} {}
+
+			explicit bloom_filter(const std::size_t keys)
+				: bits_(std::bit_ceil(std::max<std::size_t>(keys * bits_per_key, 64)) / 64, 0),
+				mask_{static_cast<std::uint64_t>(bits_.size() * 64 - 1)} {}
+
+			auto insert(const std::uint64_t hash) noexcept -> void
+			{
+				// double hashing
+				const auto step = (hash >> 32) | 1;
+				for (std::size_t i = 0; i < probes; ++i)
+				{
+					const auto bit = (hash + i * step) & mask_;
+					bits_[bit / 64] |= std::uint64_t{1} << (bit % 64);
+				}
+			}
+
+			[[nodiscard]] auto may_contain(const std::uint64_t hash) const noexcept -> bool
+			{
+				if (bits_.empty()) { return false; }
+
+				const auto step = (hash >> 32) | 1;
+				for (std::size_t i = 0; i < probes; ++i)
+				{
+					if (const auto bit = (hash + i * step) & mask_;
+						(bits_[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) { return false; }
+				}
+				return true;
+			}
+		};
+	}// namespace overlay_detail
+
+	/**
+	 * @brief A read-only view of several layers of data (e.g. defaults => file => overrides), the upper layers override the lower layers.
+	 * The layers are held by reference (nothing is copied or merged), a lookup probes the layers from the top down,
+	 * and the Bloom filter of each layer lets a miss skip the layer without looking into it.
+	 * @tparam ContextType Type of the layers (any ContextType accepted by the extractor).
+	 * @note The layers must outlive the overlay, `refresh` must be called after a layer is modified.
+	 */
+	template<typename ContextType>
+	class Overlay
+	{
+	public:
+		using context_type = ContextType;
+		using char_type = typename string_view_t<typename context_type::key_type>::value_type;
+		using string_view_type = string_view_t<char_type>;
+
+		// An effective key-value pair.
+		struct entry
+		{
+			string_view_type group;
+			string_view_type key;
+			string_view_type value;
+			// The layer the value comes from (0 => the bottom layer).
+			std::size_t layer;
+		};
+
+	private:
+		struct layer_type
+		{
+			const context_type*         context;
+			overlay_detail::bloom_filter filter;
+		};
+
+		std::vector<layer_type> layers_;
+
+		[[nodiscard]] static auto build_filter(const context_type& context) -> overlay_detail::bloom_filter
+		{
+			std::size_t keys = 0;
+			for (const auto& [group_name, group]: context) { keys += group.size(); }
+
+			overlay_detail::bloom_filter filter{keys};
+			for (const auto& [group_name, group]: context)
+			{
+				for (const auto& [key, value]: group) { filter.insert(overlay_detail::hash_key<char_type>(string_view_type{group_name}, string_view_type{key})); }
+			}
+			return filter;
+		}
+
+		[[nodiscard]] static auto probe(const context_type& context, const string_view_type group_name, const string_view_type key) -> std::optional<string_view_type>
+		{
+			if (const auto group = overlay_detail::find(context, group_name);
+				group != context.end())
+			{
+				if (const auto it = overlay_detail::find(group->second, key);
+					it != group->second.end()) { return string_view_type{it->second}; }
+			}
+			return std::nullopt;
+		}
+
+		// Whether a layer above the layer contains the key.
+		[[nodiscard]] auto shadowed(const std::size_t layer, const string_view_type group_name, const string_view_type key, const std::uint64_t hash) const -> bool
+		{
+			for (auto i = layer + 1; i < layers_.size(); ++i)
+			{
+				if (layers_[i].filter.may_contain(hash) && probe(*layers_[i].context, group_name, key).has_value()) { return true; }
+			}
+			return false;
+		}
+
+	public:
+		/**
+		 * @brief The effective key-value pairs, computed lazily while iterating.
+		 * The layers are visited from the top down, a key-value pair is skipped if an upper layer contains the key.
+		 */
+		class const_iterator
+		{
+			friend Overlay;
+
+			using group_iterator = typename context_type::const_iterator;
+			using kv_iterator = typename context_type::mapped_type::const_iterator;
+
+			const Overlay* overlay_;
+			// layers_.size() => end
+			std::size_t layer_;
+
+			group_iterator group_;
+			kv_iterator    kv_;
+
+			const_iterator(const Overlay* overlay, const std::size_t layer) noexcept
+				: overlay_{overlay},
+				layer_{layer},
+				group_{},
+				kv_{} {}
+
+			// a default-constructed iterator is an end iterator
+			[[nodiscard]] auto at_end() const noexcept -> bool { return overlay_ == nullptr || layer_ == overlay_->layers_.size(); }
+
+			[[nodiscard]] auto context() const noexcept -> const context_type& { return *overlay_->layers_[layer_].context; }
+
+			// Move to the first group (of this layer or the next layers down) that is not empty.
+			auto settle_group() -> void
+			{
+				while (true)
+				{
+					for (; group_ != context().end(); ++group_)
+					{
+						if (!group_->second.empty())
+						{
+							kv_ = group_->second.begin();
+							return;
+						}
+					}
+
+					if (layer_ == 0)
+					{
+						layer_ = overlay_->layers_.size();
+						return;
+					}
+
+					--layer_;
+					group_ = context().begin();
+				}
+			}
+
+			// Move to the next key-value pair, including this one.
+			auto settle() -> void
+			{
+				while (!at_end())
+				{
+					if (kv_ == group_->second.end())
+					{
+						++group_;
+						settle_group();
+						continue;
+					}
+
+					const string_view_type group_name{group_->first};
+					const string_view_type key{kv_->first};
+					if (!overlay_->shadowed(layer_, group_name, key, overlay_detail::hash_key<char_type>(group_name, key))) { return; }
+
+					++kv_;
+				}
+			}
+
+		public:
+			using value_type = entry;
+			using reference = entry;
+			using difference_type = std::ptrdiff_t;
+
+			const_iterator() noexcept
+				: overlay_{nullptr},
+				layer_{0},
+				group_{},
+				kv_{} {}
+
+			[[nodiscard]] auto operator*() const -> reference { return {.group = string_view_type{group_->first}, .key = string_view_type{kv_->first}, .value = string_view_type{kv_->second}, .layer = layer_}; }
+
+			auto operator++() -> const_iterator&
+			{
+				++kv_;
+				settle();
+				return *this;
+			}
+
+			auto operator++(int) -> const_iterator
+			{
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			[[nodiscard]] auto operator==(const const_iterator& other) const noexcept -> bool
+			{
+				if (at_end() || other.at_end()) { return at_end() == other.at_end(); }
+				return layer_ == other.layer_ && group_ == other.group_ && kv_ == other.kv_;
+			}
+		};
+
+		Overlay() = default;
+
+		/**
+		 * @brief Add a layer on top of the existing layers.
+		 * @param context The layer, it must outlive the overlay.
+		 * @return The index of the layer.
+		 */
+		auto push(const context_type& context) -> std::size_t
+		{
+			layers_.push_back({.context = &context, .filter = build_filter(context)});
+			return layers_.size() - 1;
+		}
+
+		// Rebuild the filter of the layer after it has been modified.
+		auto refresh(const std::size_t layer) -> void { layers_[layer].filter = build_filter(*layers_[layer].context); }
+
+		[[nodiscard]] auto layers() const noexcept -> std::size_t { return layers_.size(); }
+
+		/**
+		 * @brief Find the effective value of the key.
+		 * @param group_name Name of the group.
+		 * @param key The key.
+		 * @return The value of the uppermost layer that contains the key, or nullopt.
+		 */
+		[[nodiscard]] auto find(const string_view_type group_name, const string_view_type key) const -> std::optional<string_view_type>
+		{
+			const auto hash = overlay_detail::hash_key<char_type>(group_name, key);
+			for (auto i = layers_.size(); i != 0; --i)
+			{
+				const auto& layer = layers_[i - 1];
+				if (!layer.filter.may_contain(hash)) { continue; }
+
+				if (auto value = probe(*layer.context, group_name, key);
+					value.has_value()) { return value; }
+			}
+			return std::nullopt;
+		}
+
+		// The uppermost layer that contains the key, or nullopt.
+		[[nodiscard]] auto layer_of(const string_view_type group_name, const string_view_type key) const -> std::optional<std::size_t>
+		{
+			const auto hash = overlay_detail::hash_key<char_type>(group_name, key);
+			for (auto i = layers_.size(); i != 0; --i)
+			{
+				if (layers_[i - 1].filter.may_contain(hash) && probe(*layers_[i - 1].context, group_name, key).has_value()) { return i - 1; }
+			}
+			return std::nullopt;
+		}
+
+		[[nodiscard]] auto contains(const string_view_type group_name, const string_view_type key) const -> bool { return layer_of(group_name, key).has_value(); }
+
+		[[nodiscard]] auto begin() const -> const_iterator
+		{
+			if (layers_.empty()) { return end(); }
+
+			const_iterator it{this, layers_.size() - 1};
+			it.group_ = layers_.back().context->begin();
+			it.settle_group();
+			it.settle();
+			return it;
+		}
+
+		[[nodiscard]] auto end() const noexcept -> const_iterator { return const_iterator{this, layers_.size()}; }
+	};
+}// namespace gal::ini
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <cstdint>
+#include <ini/flusher.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gal::ini
+{
+	enum class SkeletonLine : std::uint8_t
+	{
+		BLANK,
+		COMMENT,
+		GROUP,
+		VARIABLE,
+	};
+
+	// [begin, begin + size) of the source
+	struct source_range
+	{
+		std::size_t begin{0};
+		std::size_t size{0};
+
+		[[nodiscard]] constexpr auto end() const noexcept -> std::size_t { return begin + size; }
+
+		[[nodiscard]] constexpr auto operator==(const source_range& other) const noexcept -> bool = default;
+	};
+
+	/**
+	 * @brief A line of the source as seen by the parser, only the offsets are stored (the lines that cannot be parsed are not listed).
+	 */
+	struct skeleton_line
+	{
+		SkeletonLine kind;
+		// COMMENT => indication of the comment, GROUP/VARIABLE => indication of the inline comment (0 if none)
+		char indication;
+
+		// The whole line (all the lines of a multi-line value), including the newline. empty for BLANK.
+		source_range line;
+		// COMMENT => the comment, GROUP => the group name, VARIABLE => the key
+		source_range name;
+		// VARIABLE => the value (for an empty value, where the value would be)
+		source_range value;
+		// GROUP/VARIABLE => the inline comment
+		source_range inline_comment;
+
+		[[nodiscard]] constexpr auto operator==(const skeleton_line& other) const noexcept -> bool = default;
+	};
+
+	using skeleton_type = std::vector<skeleton_line>;
+
+	// Replace [begin, end) of the source with the replacement (insert if begin == end, erase if the replacement is empty).
+	struct patch_edit
+	{
+		std::size_t begin;
+		std::size_t end;
+		std::string replacement;
+
+		[[nodiscard]] auto operator==(const patch_edit& other) const noexcept -> bool = default;
+	};
+
+	// sorted by offset, never overlap
+	using patch_type = std::vector<patch_edit>;
+
+	namespace patch_detail
+	{
+		// ====================================================
+		// For patch files, we only support char (UTF-8), just like flush_to_file.
+		// ====================================================
+
+		// Scan the source (without BOM) with the parser.
+		GAL_INI_SYMBOL_EXPORT auto scan(std::string_view source, skeleton_type& out) -> void;
+
+		// Compute the edits of the source.
+		using make_patch_type =
+		StackFunction<
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			auto
+			// pass source, skeleton of the source, edits
+			(std::string_view source,
+			const skeleton_type& skeleton,
+			patch_type&          out)
+			// return nothing
+				-> void
+				#else
+			void
+			(std::string_view source, const skeleton_type& skeleton, patch_type& out)
+				#endif
+		>;
+
+		/**
+		 * @brief Apply the edits to the file in place, see `ini::patch_file`.
+		 * @param file_path The (absolute) path to the file.
+		 * @param make_patch Compute the edits.
+		 * @return Patch result.
+		 */
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto patch_file(std::string_view file_path, make_patch_type make_patch) -> FlushResult;
+
+		template<typename ContextType>
+		auto do_make_patch(const std::string_view source, const skeleton_type& skeleton, const ContextType& in, patch_type& out) -> void
+		{
+			using context_type = ContextType;
+
+			using key_type = typename context_type::key_type;
+			using group_type = typename context_type::mapped_type;
+
+			using group_key_type = typename group_type::key_type;
+
+			static_assert(std::is_same_v<typename string_view_t<key_type>::value_type, char>, "Only char is supported!");
+
+			using group_view_type = flusher_detail::group_view_type<context_type>;
+			using kv_view_type = flusher_detail::kv_view_type<context_type>;
+
+			constexpr auto npos = std::string_view::npos;
+
+			const auto append_kv = [](std::string& target, const std::string_view key, const std::string_view value) -> void
+			{
+				// key 'space' '=' 'space' value '\n'
+				target
+						.append(key)
+						.append(blank_separator<group_key_type>)
+						.append(kv_separator<group_key_type>)
+						.append(blank_separator<group_key_type>)
+						.append(value)
+						.append(line_separator<group_key_type>);
+			};
+
+			// all group view
+			group_view_type group_view{};
+			for (const auto& group: in) { group_view.emplace(group.first, &group.second); }
+
+			// current kvs view
+			kv_view_type kv_view{};
+
+			bool        in_group   = false;
+			bool        group_kept = false;
+			std::size_t group_begin = 0;
+			// where the new key-value pairs of the current group are inserted
+			std::size_t insert_position = 0;
+			// the beginning of the comments directly above the current line, they belong to the line
+			std::size_t comment_begin = npos;
+
+			// Appending to a source that does not end with a newline needs one first.
+			const auto newline_at = [source](const std::size_t position) -> std::string
+			{
+				if (position == source.size() && !source.empty() && source.back() != '\n') { return std::string{line_separator<key_type>}; }
+				return {};
+			};
+
+			const auto end_group = [&](const std::size_t end) -> void
+			{
+				if (!in_group) { return; }
+
+				if (group_kept)
+				{
+					// the new key-value pairs
+					if (!kv_view.empty())
+					{
+						patch_edit edit{.begin = insert_position, .end = insert_position, .replacement = newline_at(insert_position)};
+						for (const auto& kv: kv_view) { append_kv(edit.replacement, kv.first, kv.second); }
+						out.push_back(std::move(edit));
+
+						kv_view.clear();
+					}
+				}
+				// the whole group (and the comments above it)
+				else { out.push_back({.begin = group_begin, .end = end, .replacement = {}}); }
+			};
+
+			for (const auto& line: skeleton)
+			{
+				const auto begin = comment_begin == npos ? line.line.begin : comment_begin;
+
+				switch (line.kind)
+				{
+					case SkeletonLine::BLANK:
+					{
+						comment_begin = npos;
+						break;
+					}
+					case SkeletonLine::COMMENT:
+					{
+						if (comment_begin == npos) { comment_begin = line.line.begin; }
+						break;
+					}
+					case SkeletonLine::GROUP:
+					{
+						end_group(begin);
+
+						in_group        = true;
+						group_begin     = begin;
+						insert_position = line.line.end();
+
+						// A group declared twice is removed (just like flush_to_file), its key-value pairs are added to the first declaration.
+						if (const auto group_it = group_view.find(source.substr(line.name.begin, line.name.size));
+							group_it != group_view.end())
+						{
+							group_kept = true;
+
+							for (const auto& kv: *group_it->second) { kv_view.emplace(kv.first, kv.second); }
+							group_view.erase(group_it);
+						}
+						else { group_kept = false; }
+
+						comment_begin = npos;
+						break;
+					}
+					case SkeletonLine::VARIABLE:
+					{
+						if (in_group && group_kept)
+						{
+							if (const auto kv_it = kv_view.find(source.substr(line.name.begin, line.name.size));
+								kv_it != kv_view.end())
+							{
+								if (const std::string_view value = kv_it->second;
+									value != source.substr(line.value.begin, line.value.size))
+								{
+									patch_edit edit{.begin = line.value.begin, .end = line.value.end(), .replacement = {}};
+
+									// key = ; inline_comment
+									if (line.value.size == 0 && line.value.begin != 0 && source[line.value.begin - 1] == kv_separator<group_key_type>[0]) { edit.replacement.append(blank_separator<group_key_type>); }
+									edit.replacement.append(value);
+									if (line.value.size == 0 && line.indication != 0 && line.value.begin < source.size() && source[line.value.begin] == line.indication) { edit.replacement.append(blank_separator<group_key_type>); }
+
+									out.push_back(std::move(edit));
+								}
+
+								kv_view.erase(kv_it);
+							}
+							// removed (or declared twice), with the comments above it
+							else { out.push_back({.begin = begin, .end = line.line.end(), .replacement = {}}); }
+
+							insert_position = line.line.end();
+						}
+
+						comment_begin = npos;
+						break;
+					}
+				}
+			}
+
+			end_group(source.size());
+
+			// the new groups
+			if (!group_view.empty())
+			{
+				patch_edit edit{.begin = source.size(), .end = source.size(), .replacement = newline_at(source.size())};
+				for (const auto& group: group_view)
+				{
+					// '[' group_name ']' '\n'
+					edit.replacement.push_back(square_bracket<key_type>.first);
+					edit.replacement.append(group.first);
+					edit.replacement.push_back(square_bracket<key_type>.second);
+					edit.replacement.append(line_separator<key_type>);
+
+					for (const auto& kv: *group.second) { append_kv(edit.replacement, kv.first, kv.second); }
+				}
+				out.push_back(std::move(edit));
+			}
+		}
+	}// namespace patch_detail
+
+	/**
+	 * @brief Roll back a patch interrupted by a crash (if any), the file is restored to its content before the patch.
+	 * @param file_path The (absolute) path to the file.
+	 * @return Recover result (SUCCESS if there is nothing to recover).
+	 * @note `patch_file` recovers the file before patching it, call this before reading a file that may have been patched when the process crashed.
+	 */
+	[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto recover_patch(std::string_view file_path) -> FlushResult;
+
+	/**
+	 * @brief Compute the edits that make the source match the data (the same data as flush_to_file would write), the formatting and comments of the unchanged lines are kept.
+	 * @tparam ContextType Type of the input data.
+	 * @param source The source (without BOM).
+	 * @param in Where the extracted data is stored.
+	 * @return The edits, sorted by offset.
+	 */
+	template<typename ContextType>
+	[[nodiscard]] auto make_patch(const std::string_view source, const ContextType& in) -> patch_type
+	{
+		skeleton_type skeleton{};
+		patch_detail::scan(source, skeleton);
+
+		patch_type edits{};
+		patch_detail::do_make_patch(source, skeleton, in, edits);
+		return edits;
+	}
+
+	/**
+	 * @brief Patch ini data to files, only the changed bytes are written.
+	 * If every edit keeps its size (e.g. `port = 8080` => `port = 9090`) the edits are written in place, otherwise the file is rewritten from the first edit to its end.
+	 * The replaced bytes are saved to a journal (`file_path.journal`) before the file is touched, so a crash in the middle of a patch is rolled back (see `recover_patch`).
+	 * @tparam ContextType Type of the input data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param in Where the extracted data is stored.
+	 * @return Patch result.
+	 */
+	template<typename ContextType>
+	auto patch_file(const std::string_view file_path, const ContextType& in) -> FlushResult
+	{
+		// !!!MUST PLACE HERE!!!
+		// see flush_to_file
+		auto make_patch = [&in](const std::string_view source, const skeleton_type& skeleton, patch_type& out) -> void { patch_detail::do_make_patch(source, skeleton, in, out); };
+
+		return patch_detail::patch_file(file_path, patch_detail::make_patch_type{make_patch});
+	}
+}// namespace gal::ini
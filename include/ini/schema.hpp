@@ -0,0 +1,425 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <ini/extractor.hpp>
+#include <ini/internal/common.hpp>
+#include <ini/internal/convert.hpp>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace gal::ini
+{
+	enum class SchemaType
+	{
+		// Any value.
+		STRING,
+		// std::int64_t
+		INTEGER,
+		// double
+		FLOAT,
+		// true/on/yes/1 or false/off/no/0
+		BOOLEAN,
+	};
+
+	enum class SchemaViolation
+	{
+		// The group is declared by the schema, but the key is not (closed groups only).
+		UNKNOWN_KEY,
+		// The value cannot be converted to the declared type.
+		TYPE_MISMATCH,
+		// The value is not within [min, max].
+		OUT_OF_RANGE,
+		// The value is not one of the allowed values.
+		NOT_ALLOWED,
+		// A required key does not exist.
+		MISSING,
+	};
+
+	template<typename Char>
+	struct schema_violation
+	{
+		SchemaViolation kind;
+
+		std::basic_string<Char> group;
+		std::basic_string<Char> key;
+		// Empty for MISSING.
+		std::basic_string<Char> value;
+
+		[[nodiscard]] constexpr auto operator==(const schema_violation& other) const noexcept -> bool = default;
+	};
+
+	template<typename Char>
+	using schema_result_type = std::vector<schema_violation<Char>>;
+
+	// An inclusive bound of INTEGER/FLOAT, an integral bound is kept exactly (INTEGER values are compared as std::int64_t, not as double).
+	struct schema_bound
+	{
+		bool         integral;
+		std::int64_t integer;
+		double       floating;
+
+		template<typename T>
+			requires(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+		// implicit => {.min = 1, .max = 65535}
+		constexpr schema_bound(const T value) noexcept
+			: integral{std::is_integral_v<T>},
+			integer{std::is_integral_v<T> ? static_cast<std::int64_t>(value) : 0},
+			floating{static_cast<double>(value)} {}
+	};
+
+	namespace schema_detail
+	{
+		[[nodiscard]] constexpr auto reason_of(const SchemaViolation violation) noexcept -> std::string_view
+		{
+			switch (violation)
+			{
+				case SchemaViolation::UNKNOWN_KEY: { return "unknown key"; }
+				case SchemaViolation::TYPE_MISMATCH: { return "the value is not of the declared type"; }
+				case SchemaViolation::OUT_OF_RANGE: { return "the value is out of range"; }
+				case SchemaViolation::NOT_ALLOWED: { return "the value is not one of the allowed values"; }
+				case SchemaViolation::MISSING: { return "missing required key"; }
+				default: { GAL_INI_UNREACHABLE(); }
+			}
+		}
+	}// namespace schema_detail
+
+	/**
+	 * @brief The expected keys of the data, compiled into hash tables when they are defined, so that validating a value is a lookup plus a conversion.
+	 * The schema is passed to `extract_from_file`/`extract_from_buffer`, each value is validated while it is parsed and a rejected value is never stored.
+	 * @tparam Char Character type of the data.
+	 * @note The groups not declared by the schema are not validated.
+	 * @note Define all the keys before extracting, the schema is only read (and can be shared between threads) while extracting.
+	 */
+	template<typename Char>
+	class Schema
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+		// The definition of a key.
+		struct rule_type
+		{
+			SchemaType type = SchemaType::STRING;
+			bool       required = false;
+
+			// INTEGER/FLOAT only, inclusive.
+			std::optional<schema_bound> min = std::nullopt;
+			std::optional<schema_bound> max = std::nullopt;
+
+			// Empty => any value (of the type), the type and the range are still checked.
+			std::vector<string_type> allowed = {};
+		};
+
+	private:
+		struct string_hasher
+		{
+			using is_transparent = int;
+
+			[[nodiscard]] auto operator()(const string_view_type string) const noexcept -> std::size_t { return std::hash<string_view_type>{}(string); }
+		};
+
+		template<typename T>
+		using table_type = std::unordered_map<string_type, T, string_hasher, std::equal_to<>>;
+
+		struct compiled_rule
+		{
+			SchemaType type;
+			// FLOAT
+			double min;
+			double max;
+			// min or max is set (NaN is within no bound)
+			bool bounded;
+			// INTEGER
+			std::int64_t integer_min;
+			std::int64_t integer_max;
+
+			std::unordered_set<string_type, string_hasher, std::equal_to<>> allowed;
+
+			// index of required_, npos => optional
+			std::size_t required_index;
+		};
+
+		struct group_rules
+		{
+			table_type<compiled_rule> keys;
+			// reject the keys not declared
+			bool closed;
+		};
+
+		table_type<group_rules> groups_;
+		// (group name, key)
+		std::vector<std::pair<string_type, string_type>> required_;
+
+		[[nodiscard]] auto find_rule(const string_view_type group_name, const string_view_type key) const -> std::pair<const group_rules*, const compiled_rule*>
+		{
+			const auto group = groups_.find(group_name);
+			if (group == groups_.end()) { return {nullptr, nullptr}; }
+
+			const auto rule = group->second.keys.find(key);
+			if (rule == group->second.keys.end()) { return {&group->second, nullptr}; }
+			return {&group->second, &rule->second};
+		}
+
+		// The nearest integer within the bound (a floating point bound of an INTEGER key).
+		[[nodiscard]] static auto integer_of(const schema_bound& bound, const bool is_min) noexcept -> std::int64_t
+		{
+			if (bound.integral) { return bound.integer; }
+
+			// 2^63
+			constexpr auto limit = 9223372036854775808.0;
+
+			const auto value = is_min ? std::ceil(bound.floating) : std::floor(bound.floating);
+			if (value >= limit) { return std::numeric_limits<std::int64_t>::max(); }
+			if (value < -limit) { return std::numeric_limits<std::int64_t>::min(); }
+			return static_cast<std::int64_t>(value);
+		}
+
+		[[nodiscard]] static auto check(const compiled_rule& rule, const string_view_type value) -> std::optional<SchemaViolation>
+		{
+			switch (rule.type)
+			{
+				case SchemaType::STRING: { break; }
+				case SchemaType::INTEGER:
+				{
+					const auto v = common::from_string<std::int64_t, char_type>(value);
+					if (!v.has_value()) { return SchemaViolation::TYPE_MISMATCH; }
+					if (*v < rule.integer_min || *v > rule.integer_max) { return SchemaViolation::OUT_OF_RANGE; }
+					break;
+				}
+				case SchemaType::FLOAT:
+				{
+					const auto v = common::from_string<double, char_type>(value);
+					if (!v.has_value()) { return SchemaViolation::TYPE_MISMATCH; }
+					// every comparison with NaN is false
+					if (rule.bounded && std::isnan(*v)) { return SchemaViolation::OUT_OF_RANGE; }
+					if (*v < rule.min || *v > rule.max) { return SchemaViolation::OUT_OF_RANGE; }
+					break;
+				}
+				case SchemaType::BOOLEAN:
+				{
+					if (!common::from_string<bool, char_type>(value).has_value()) { return SchemaViolation::TYPE_MISMATCH; }
+					break;
+				}
+				default: { GAL_INI_UNREACHABLE(); }
+			}
+
+			// the membership is a hash lookup, checked after the type (an allowed value must still be of the type)
+			if (!rule.allowed.empty() && !rule.allowed.contains(value)) { return SchemaViolation::NOT_ALLOWED; }
+
+			return std::nullopt;
+		}
+
+		[[nodiscard]] auto do_validate(const string_view_type group_name, const string_view_type key, const string_view_type value) const -> std::pair<std::optional<SchemaViolation>, const compiled_rule*>
+		{
+			const auto [group, rule] = find_rule(group_name, key);
+			if (group == nullptr) { return {std::nullopt, nullptr}; }
+			if (rule == nullptr)
+			{
+				if (group->closed) { return {SchemaViolation::UNKNOWN_KEY, nullptr}; }
+				return {std::nullopt, nullptr};
+			}
+			return {check(*rule, value), rule};
+		}
+
+	public:
+		/**
+		 * @brief Declare the group.
+		 * @param group_name Name of the group.
+		 * @param closed Whether the keys not declared are rejected.
+		 * @return *this
+		 */
+		auto group(const string_view_type group_name, const bool closed = false) -> Schema&
+		{
+			if (const auto it = groups_.find(group_name);
+				it != groups_.end()) { it->second.closed = closed; }
+			else { groups_.emplace(string_type{group_name}, group_rules{.keys = {}, .closed = closed}); }
+			return *this;
+		}
+
+		/**
+		 * @brief Declare the key (and its group), a key declared again replaces the previous definition.
+		 * @param group_name Name of the group.
+		 * @param key The key.
+		 * @param rule The definition of the key.
+		 * @return *this
+		 */
+		auto define(const string_view_type group_name, const string_view_type key, const rule_type& rule) -> Schema&
+		{
+			auto group = groups_.find(group_name);
+			if (group == groups_.end()) { group = groups_.emplace(string_type{group_name}, group_rules{.keys = {}, .closed = false}).first; }
+
+			compiled_rule compiled{
+					.type = rule.type,
+					.min = rule.min.has_value() ? rule.min->floating : -std::numeric_limits<double>::infinity(),
+					.max = rule.max.has_value() ? rule.max->floating : std::numeric_limits<double>::infinity(),
+					.bounded = rule.min.has_value() || rule.max.has_value(),
+					.integer_min = rule.min.has_value() ? integer_of(*rule.min, true) : std::numeric_limits<std::int64_t>::min(),
+					.integer_max = rule.max.has_value() ? integer_of(*rule.max, false) : std::numeric_limits<std::int64_t>::max(),
+					.allowed = {rule.allowed.begin(), rule.allowed.end()},
+					.required_index = static_cast<std::size_t>(-1)};
+
+			auto& keys = group->second.keys;
+			if (const auto it = keys.find(key);
+				it != keys.end())
+			{
+				// keep the slot of the required key
+				compiled.required_index = it->second.required_index;
+				it->second              = std::move(compiled);
+			}
+			else { keys.emplace(string_type{key}, std::move(compiled)); }
+
+			auto& target = keys.find(key)->second;
+			if (rule.required && target.required_index == static_cast<std::size_t>(-1))
+			{
+				target.required_index = required_.size();
+				required_.emplace_back(string_type{group_name}, string_type{key});
+			}
+			else if (!rule.required && target.required_index != static_cast<std::size_t>(-1))
+			{
+				// the slot is kept, but never reported
+				required_[target.required_index].first.clear();
+				target.required_index = static_cast<std::size_t>(-1);
+			}
+
+			return *this;
+		}
+
+		/**
+		 * @brief Validate a key-value pair.
+		 * @param group_name Name of the group.
+		 * @param key The key.
+		 * @param value The value.
+		 * @return The violation, or nullopt if the value is accepted.
+		 */
+		[[nodiscard]] auto validate(const string_view_type group_name, const string_view_type key, const string_view_type value) const -> std::optional<SchemaViolation> { return do_validate(group_name, key, value).first; }
+
+		/**
+		 * @brief Make the value validator passed to the extractor.
+		 * @param seen Marks the required keys that have been extracted (resized by the validator).
+		 * @param violations Where the violations are stored.
+		 * @return auto(string_view_t<Char>, string_view_t<Char>, string_view_t<Char>) -> std::string_view
+		 * @note The result must outlive the value_validate_type made from it (see extractor_detail::extract_to_context).
+		 */
+		[[nodiscard]] auto make_validator(std::vector<bool>& seen, schema_result_type<char_type>& violations) const
+		{
+			seen.assign(required_.size(), false);
+
+			return [this, &seen, &violations](const string_view_type group_name, const string_view_type key, const string_view_type value) -> std::string_view
+			{
+				#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+				const auto workaround_validate_result = do_validate(group_name, key, value);
+				const auto violation                  = workaround_validate_result.first;
+				const auto rule                       = workaround_validate_result.second;
+				#else
+				const auto [violation, rule] = do_validate(group_name, key, value);
+				#endif
+
+				// the key exists, even if its value is rejected
+				if (rule != nullptr && rule->required_index != static_cast<std::size_t>(-1)) { seen[rule->required_index] = true; }
+
+				if (!violation.has_value()) { return {}; }
+
+				violations.push_back({.kind = *violation, .group = string_type{group_name}, .key = string_type{key}, .value = string_type{value}});
+				return schema_detail::reason_of(*violation);
+			};
+		}
+
+		/**
+		 * @brief Report the required keys that have not been extracted.
+		 * @param seen The marks made by the validator.
+		 * @param violations Where the violations are stored.
+		 */
+		auto report_missing(const std::vector<bool>& seen, schema_result_type<char_type>& violations) const -> void
+		{
+			for (std::size_t i = 0; i < required_.size(); ++i)
+			{
+				// required_[i].first is empty => no longer required
+				if (const auto& [group_name, key] = required_[i];
+					!seen[i] && !group_name.empty()) { violations.push_back({.kind = SchemaViolation::MISSING, .group = group_name, .key = key, .value = {}}); }
+			}
+		}
+	};
+
+	namespace schema_detail
+	{
+		template<typename ContextType, typename Extractor>
+		auto extract_validated(
+				ContextType&                                                                             out,
+				const Schema<typename string_view_t<typename ContextType::key_type>::value_type>&        schema,
+				schema_result_type<typename string_view_t<typename ContextType::key_type>::value_type>& violations,
+				Extractor                                                                                extractor) -> ExtractResult
+		{
+			using char_type = typename string_view_t<typename ContextType::key_type>::value_type;
+
+			std::vector<bool> seen{};
+			// !!!MUST PLACE HERE!!!
+			// see extractor_detail::extract_to_context
+			const auto validator = schema.make_validator(seen, violations);
+
+			const auto result = extractor_detail::extract_to_context(
+					out,
+					[&extractor, &validator](const auto group_appender) -> ExtractResult { return extractor(group_appender, value_validate_type<char_type>{validator}); });
+			if (result != ExtractResult::SUCCESS && result != ExtractResult::INVALID_DATA) { return result; }
+
+			const auto violated = violations.size();
+			schema.report_missing(seen, violations);
+			return violations.size() != violated ? ExtractResult::INVALID_DATA : result;
+		}
+	}// namespace schema_detail
+
+	/**
+	 * @brief Extract ini data from files, each value is validated while it is parsed.
+	 * @tparam ContextType Type of the output data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param out Where the extracted data is stored (the rejected key-value pairs are not stored).
+	 * @param schema The expected keys.
+	 * @param violations Where the violations are stored.
+	 * @return Extract result, INVALID_DATA if there is any violation.
+	 */
+	template<typename ContextType>
+	auto extract_from_file(
+			const std::string_view                                                                   file_path,
+			ContextType&                                                                             out,
+			const Schema<typename string_view_t<typename ContextType::key_type>::value_type>&        schema,
+			schema_result_type<typename string_view_t<typename ContextType::key_type>::value_type>& violations) -> ExtractResult
+	{
+		return schema_detail::extract_validated(
+				out,
+				schema,
+				violations,
+				[file_path](const auto group_appender, const auto value_validator) -> ExtractResult { return extractor_detail::extract_from_file(file_path, group_appender, value_validator); });
+	}
+
+	/**
+	 * @brief Extract ini data from buffer, each value is validated while it is parsed.
+	 * @tparam ContextType Type of the output data.
+	 * @param buffer The buffer.
+	 * @param out Where the extracted data is stored (the rejected key-value pairs are not stored).
+	 * @param schema The expected keys.
+	 * @param violations Where the violations are stored.
+	 * @return Extract result, INVALID_DATA if there is any violation.
+	 */
+	template<typename ContextType>
+	auto extract_from_buffer(
+			string_view_t<typename string_view_t<typename ContextType::key_type>::value_type>        buffer,
+			ContextType&                                                                             out,
+			const Schema<typename string_view_t<typename ContextType::key_type>::value_type>&        schema,
+			schema_result_type<typename string_view_t<typename ContextType::key_type>::value_type>& violations) -> ExtractResult
+	{
+		return schema_detail::extract_validated(
+				out,
+				schema,
+				violations,
+				[buffer](const auto group_appender, const auto value_validator) -> ExtractResult { return extractor_detail::extract_from_buffer(buffer, group_appender, value_validator); });
+	}
+}// namespace gal::ini
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <ini/extractor.hpp>
+#include <ini/flusher.hpp>
+#include <ini/patch.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace gal::ini
+{
+	namespace session_detail
+	{
+		// ====================================================
+		// For sessions, we only support char (UTF-8), just like flush_to_file.
+		// ====================================================
+
+		// Extract the source (without BOM) and record its skeleton with the same parse.
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto extract(
+				std::string_view        file_path,
+				std::string_view        source,
+				group_append_type<char> group_appender,
+				skeleton_type&          skeleton) -> ExtractResult;
+
+		// Flush to the file by replaying the skeleton of the source (the parser is not invoked), the data written to the file is stored in `written`.
+		// The skeleton of the data written is recorded in `written_skeleton` while it is written, the returned bool is false if it could not be recorded (it must be scanned then).
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto flush(
+				std::string_view           file_path,
+				std::string_view           source,
+				const skeleton_type&       skeleton,
+				group_ostream_handle<char> group_handler,
+				FlushDurability            durability,
+				std::string&               written,
+				skeleton_type&             written_skeleton) -> std::pair<FlushResult, bool>;
+	}// namespace session_detail
+
+	/**
+	 * @brief The source of a file and the skeleton of its lines, kept from the extraction (see `extract_session`),
+	 * so that flushing to the same file neither reads nor parses it again (extract => modify => flush parses the file once).
+	 * If the file has been modified since, it is read again (and only parsed if its content has changed).
+	 * @note Only char (UTF-8) is supported, just like flush_to_file.
+	 */
+	class Session
+	{
+	public:
+		using char_type = char;
+
+	private:
+		std::string   file_path_;
+		std::string   source_;
+		skeleton_type skeleton_;
+		// The skeleton of the source has been recorded (otherwise the source is scanned on the next flush).
+		bool         scanned_;
+		change_token token_;
+
+		[[nodiscard]] auto metadata_unchanged(const change_token& token) const noexcept -> bool
+		{
+			// mtime_ns == 0 => racy (see extract_if_changed)
+			return token_.mtime_ns != 0 &&
+			       token.inode == token_.inode &&
+			       token.size == token_.size &&
+			       token.mtime_ns == token_.mtime_ns;
+		}
+
+		// Make sure the source (and its skeleton) is the content of the file.
+		[[nodiscard]] auto refresh() -> FlushResult
+		{
+			if (const auto token = extractor_detail::read_change_token(file_path_);
+				!metadata_unchanged(token))
+			{
+				// touched, replaced or written by someone else, compare the content
+				std::string content{};
+				switch (extractor_detail::read_file(file_path_, content))
+				{
+					case ExtractResult::SUCCESS: { break; }
+					// it will be created
+					case ExtractResult::FILE_NOT_FOUND:
+					{
+						content.clear();
+						break;
+					}
+					case ExtractResult::PERMISSION_DENIED: { return FlushResult::PERMISSION_DENIED; }
+					case ExtractResult::INTERNAL_ERROR:
+					case ExtractResult::NOT_MODIFIED:
+					case ExtractResult::INVALID_DATA:
+					default: { return FlushResult::INTERNAL_ERROR; }
+				}
+
+				if (content != source_)
+				{
+					source_  = std::move(content);
+					scanned_ = false;
+				}
+				token_ = token;
+			}
+
+			if (!scanned_)
+			{
+				skeleton_.clear();
+				patch_detail::scan(source_, skeleton_);
+				scanned_ = true;
+			}
+
+			return FlushResult::SUCCESS;
+		}
+
+	public:
+		/**
+		 * @brief A session of the file, nothing is read until `extract` is called.
+		 * @param file_path The (absolute) path to the file.
+		 */
+		explicit Session(const std::string_view file_path)
+			: file_path_{file_path},
+			source_{},
+			skeleton_{},
+			scanned_{true},
+			token_{} {}
+
+		[[nodiscard]] auto file_path() const noexcept -> std::string_view { return file_path_; }
+
+		// The content of the file (without BOM) as last extracted or flushed.
+		[[nodiscard]] auto source() const noexcept -> std::string_view { return source_; }
+
+		// The lines of the source as seen by the parser, empty if the source has not been scanned yet (see `flush`).
+		[[nodiscard]] auto skeleton() const noexcept -> const skeleton_type& { return skeleton_; }
+
+		/**
+		 * @brief Extract ini data from the file, the source and its skeleton are kept for the next flush.
+		 * @tparam ContextType Type of the output data.
+		 * @param out Where the extracted data is stored.
+		 * @return Extract result.
+		 */
+		template<typename ContextType>
+		auto extract(ContextType& out) -> ExtractResult
+		{
+			static_assert(std::is_same_v<typename string_view_t<typename ContextType::key_type>::value_type, char_type>, "Only char is supported!");
+
+			// before the content, so that a modification in between is noticed by the next flush
+			token_ = extractor_detail::read_change_token(file_path_);
+
+			source_.clear();
+			skeleton_.clear();
+			if (const auto result = extractor_detail::read_file(file_path_, source_);
+				result != ExtractResult::SUCCESS)
+			{
+				token_ = {};
+				return result;
+			}
+			scanned_ = true;
+
+			return extractor_detail::extract_to_context(
+					out,
+					[this](const auto group_appender) -> ExtractResult { return session_detail::extract(file_path_, source_, group_appender, skeleton_); });
+		}
+
+		/**
+		 * @brief Flush ini data to the file (the same data as flush_to_file would write), the kept skeleton is replayed instead of parsing the file again.
+		 * @tparam ContextType Type of the input data.
+		 * @param in Where the extracted data is stored.
+		 * @param view_allocator The allocator of the temporary views.
+		 * @param durability How the file reaches the disk.
+		 * @return Flush result.
+		 */
+		template<typename ContextType>
+		auto flush(ContextType& in, const flush_view_allocator_type<ContextType>& view_allocator, const FlushDurability durability = FlushDurability::FULL) -> FlushResult
+		{
+			static_assert(std::is_same_v<typename string_view_t<typename ContextType::key_type>::value_type, char_type>, "Only char is supported!");
+
+			if (const auto result = refresh();
+				result != FlushResult::SUCCESS) { return result; }
+
+			std::string   written{};
+			skeleton_type written_skeleton{};
+			bool          recorded = false;
+			const auto    result   = flusher_detail::with_ostream_handle(
+					in,
+					view_allocator,
+					[this, durability, &written, &written_skeleton, &recorded](const auto& group_handler) -> FlushResult
+					{
+						const auto [flush_result, skeleton_recorded] = session_detail::flush(file_path_, source_, skeleton_, group_handler, durability, written, written_skeleton);
+						recorded                                     = skeleton_recorded;
+						return flush_result;
+					});
+
+			if (result == FlushResult::SUCCESS)
+			{
+				// the file is the data just written
+				source_ = std::move(written);
+				if (recorded) { skeleton_ = std::move(written_skeleton); }
+				else { skeleton_.clear(); }
+				scanned_ = recorded;
+				token_   = extractor_detail::read_change_token(file_path_);
+			}
+
+			return result;
+		}
+
+		template<typename ContextType>
+		auto flush(ContextType& in, const FlushDurability durability = FlushDurability::FULL) -> FlushResult
+		{
+			return flush<ContextType>(in, flush_view_allocator_type<ContextType>{}, durability);
+		}
+	};
+
+	/**
+	 * @brief Extract ini data from files and keep the source for a later flush (see `Session`).
+	 * @tparam ContextType Type of the output data.
+	 * @param file_path The (absolute) path to the file.
+	 * @param out Where the extracted data is stored.
+	 * @return Extract result and the session of the file.
+	 */
+	template<typename ContextType>
+	auto extract_session(const std::string_view file_path, ContextType& out) -> std::pair<ExtractResult, Session>
+	{
+		Session    session{file_path};
+		const auto result = session.extract(out);
+		return {result, std::move(session)};
+	}
+}// namespace gal::ini
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ini/extractor.hpp>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace gal::ini
+{
+	/**
+	 * @brief Hold an immutable snapshot that is read by many threads and replaced rarely (epoch-based reclamation).
+	 * Reading is wait-free and does not touch any shared reference count: each reader owns a (cache line aligned) slot and announces the epoch it reads in.
+	 * A replaced snapshot is reclaimed by the writer once every reader has left the epoch in which it was replaced.
+	 * @tparam T Type of the snapshot (e.g. a ContextType).
+	 */
+	template<typename T>
+	class SnapshotStore
+	{
+	public:
+		using value_type = T;
+
+		constexpr static std::size_t default_max_readers = 128;
+
+	private:
+		// avoid std::hardware_destructive_interference_size, its value is not stable across compilers (-Winterference-size)
+		constexpr static std::size_t cache_line_size = 64;
+
+		// epoch 0 => not reading
+		constexpr static std::uint64_t inactive_epoch = 0;
+
+		struct alignas(cache_line_size) reader_slot
+		{
+			std::atomic<std::uint64_t> epoch{inactive_epoch};
+			std::atomic<bool>          claimed{false};
+		};
+
+		struct retired_snapshot
+		{
+			const value_type* snapshot;
+			// can be reclaimed once every reader has announced an epoch >= this
+			std::uint64_t epoch;
+		};
+
+		std::atomic<const value_type*> current_;
+		std::atomic<std::uint64_t>     epoch_;
+
+		std::size_t                    max_readers_;
+		std::unique_ptr<reader_slot[]> slots_;
+
+		std::mutex                    writer_mutex_;
+		std::vector<retired_snapshot> retired_;
+
+		// writer_mutex_ must be held
+		auto do_reclaim() -> void
+		{
+			auto min_epoch = std::numeric_limits<std::uint64_t>::max();
+			for (std::size_t i = 0; i < max_readers_; ++i)
+			{
+				if (const auto epoch = slots_[i].epoch.load(std::memory_order_seq_cst);
+					epoch != inactive_epoch && epoch < min_epoch) { min_epoch = epoch; }
+			}
+
+			std::erase_if(
+					retired_,
+					[min_epoch](const retired_snapshot& retired) -> bool
+					{
+						if (retired.epoch <= min_epoch)
+						{
+							delete retired.snapshot;
+							return true;
+						}
+						return false;
+					});
+		}
+
+	public:
+		/**
+		 * @brief A guard that keeps the snapshot alive, it must not outlive the Reader that created it.
+		 */
+		class ReadGuard
+		{
+			friend SnapshotStore;
+
+			reader_slot*      slot_;
+			const value_type* snapshot_;
+
+			ReadGuard(reader_slot* slot, const value_type* snapshot) noexcept
+				: slot_{slot},
+				snapshot_{snapshot} {}
+
+		public:
+			ReadGuard(const ReadGuard&) = delete;
+			ReadGuard(ReadGuard&&) = delete;
+			auto operator=(const ReadGuard&) -> ReadGuard& = delete;
+			auto operator=(ReadGuard&&) -> ReadGuard& = delete;
+
+			~ReadGuard() noexcept { slot_->epoch.store(inactive_epoch, std::memory_order_release); }
+
+			[[nodiscard]] auto get() const noexcept -> const value_type& { return *snapshot_; }
+
+			[[nodiscard]] auto operator*() const noexcept -> const value_type& { return *snapshot_; }
+
+			[[nodiscard]] auto operator->() const noexcept -> const value_type* { return snapshot_; }
+		};
+
+		/**
+		 * @brief A reader slot, each thread should own one (e.g. thread_local) and reuse it.
+		 */
+		class Reader
+		{
+			friend SnapshotStore;
+
+			const SnapshotStore* store_;
+			reader_slot*         slot_;
+
+			Reader(const SnapshotStore* store, reader_slot* slot) noexcept
+				: store_{store},
+				slot_{slot} {}
+
+		public:
+			Reader() noexcept
+				: store_{nullptr},
+				slot_{nullptr} {}
+
+			Reader(const Reader&) = delete;
+			auto operator=(const Reader&) -> Reader& = delete;
+
+			Reader(Reader&& other) noexcept
+				: store_{std::exchange(other.store_, nullptr)},
+				slot_{std::exchange(other.slot_, nullptr)} {}
+
+			auto operator=(Reader&& other) noexcept -> Reader&
+			{
+				if (this != &other)
+				{
+					if (slot_ != nullptr) { slot_->claimed.store(false, std::memory_order_release); }
+					store_ = std::exchange(other.store_, nullptr);
+					slot_  = std::exchange(other.slot_, nullptr);
+				}
+				return *this;
+			}
+
+			~Reader() noexcept
+			{
+				if (slot_ != nullptr) { slot_->claimed.store(false, std::memory_order_release); }
+			}
+
+			// Whether a slot was available.
+			[[nodiscard]] explicit operator bool() const noexcept { return slot_ != nullptr; }
+
+			/**
+			 * @brief Get the current snapshot (wait-free), a reader can only hold one guard at a time.
+			 * @return The guard of the snapshot.
+			 */
+			[[nodiscard]] auto read() const noexcept -> ReadGuard
+			{
+				// announce the epoch before loading the snapshot (store-load => seq_cst)
+				slot_->epoch.store(store_->epoch_.load(std::memory_order_acquire), std::memory_order_seq_cst);
+				const auto* snapshot = store_->current_.load(std::memory_order_seq_cst);
+				return ReadGuard{slot_, snapshot};
+			}
+		};
+
+		/**
+		 * @brief Create a store.
+		 * @param initial The initial snapshot.
+		 * @param max_readers The maximum number of concurrent readers (slots).
+		 */
+		explicit SnapshotStore(std::unique_ptr<const value_type> initial, const std::size_t max_readers = default_max_readers)
+			: current_{initial.release()},
+			epoch_{1},
+			max_readers_{max_readers},
+			slots_{std::make_unique<reader_slot[]>(max_readers)} {}
+
+		SnapshotStore(const SnapshotStore&) = delete;
+		SnapshotStore(SnapshotStore&&) = delete;
+		auto operator=(const SnapshotStore&) -> SnapshotStore& = delete;
+		auto operator=(SnapshotStore&&) -> SnapshotStore& = delete;
+
+		// All readers must have been destroyed.
+		~SnapshotStore() noexcept
+		{
+			delete current_.load(std::memory_order_relaxed);
+			for (const auto& retired: retired_) { delete retired.snapshot; }
+		}
+
+		/**
+		 * @brief Claim a reader slot.
+		 * @return The reader, check it with operator bool (false if all slots are claimed).
+		 */
+		[[nodiscard]] auto reader() const noexcept -> Reader
+		{
+			for (std::size_t i = 0; i < max_readers_; ++i)
+			{
+				if (bool expected = false;
+					slots_[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) { return Reader{this, &slots_[i]}; }
+			}
+			return {};
+		}
+
+		/**
+		 * @brief Replace the snapshot (one atomic store), the replaced snapshot is reclaimed once no reader can still see it.
+		 * @param snapshot The new snapshot.
+		 */
+		auto publish(std::unique_ptr<const value_type> snapshot) -> void
+		{
+			std::lock_guard lock{writer_mutex_};
+
+			const auto* old_snapshot = current_.exchange(snapshot.release(), std::memory_order_seq_cst);
+			const auto  epoch        = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+
+			retired_.push_back({.snapshot = old_snapshot, .epoch = epoch});
+			do_reclaim();
+		}
+
+		/**
+		 * @brief Extract the file into a new snapshot and publish it (only if the extraction succeeded).
+		 * @param file_path The (absolute) path to the file.
+		 * @return Extract result.
+		 */
+		auto publish_from_file(const std::string_view file_path) -> ExtractResult
+		{
+			auto       snapshot = std::make_unique<value_type>();
+			const auto result   = extract_from_file<value_type>(file_path, *snapshot);
+			if (result == ExtractResult::SUCCESS) { publish(std::move(snapshot)); }
+			return result;
+		}
+
+		// Reclaim the replaced snapshots that no reader can see anymore (also done by publish).
+		auto reclaim() -> void
+		{
+			std::lock_guard lock{writer_mutex_};
+			do_reclaim();
+		}
+
+		// The number of replaced snapshots that are not reclaimed yet.
+		[[nodiscard]] auto pending_reclaims() -> std::size_t
+		{
+			std::lock_guard lock{writer_mutex_};
+			return retired_.size();
+		}
+	};
+}// namespace gal::ini
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <ini/diff.hpp>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gal::ini
+{
+	namespace subscription_detail
+	{
+		// Run the task on the calling thread.
+		struct inline_executor
+		{
+			template<typename Task>
+			auto operator()(Task&& task) const -> void { std::forward<Task>(task)(); }
+		};
+	}// namespace subscription_detail
+
+	/**
+	 * @brief Notify the components interested in a group, a key of a group or a group name prefix when their data changes.
+	 * The subscribers are indexed by what they are interested in, the cost of a notification is proportional to the number of changes
+	 * (and the subscribers they match), not to the number of subscribers.
+	 * @tparam Char Character type of the data.
+	 */
+	template<typename Char>
+	class SubscriptionRegistry
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+		using entry_type = diff_entry<char_type>;
+		// All the changes a subscriber is interested in, in the order of the diff.
+		using callback_type = std::function<void(std::span<const entry_type>)>;
+
+		using subscription_id = std::uint64_t;
+
+	private:
+		struct string_hasher
+		{
+			using is_transparent = int;
+
+			[[nodiscard]] auto operator()(const string_view_type string) const noexcept -> std::size_t { return std::hash<string_view_type>{}(string); }
+		};
+
+		template<typename Value>
+		using map_type = std::unordered_map<string_type, Value, string_hasher, std::equal_to<>>;
+
+		using subscribers_type = std::vector<subscription_id>;
+
+		struct subscriber
+		{
+			callback_type callback;
+
+			// What the subscriber is interested in (to unsubscribe).
+			string_type group;
+			string_type key;
+			bool        prefix;
+		};
+
+		mutable std::mutex mutex_;
+
+		subscription_id                                  next_id_;
+		std::unordered_map<subscription_id, subscriber> subscribers_;
+
+		map_type<subscribers_type>           group_subscribers_;
+		map_type<map_type<subscribers_type>> key_subscribers_;
+		map_type<subscribers_type>           prefix_subscribers_;
+		// The lengths of all subscribed prefixes => a group name is only probed with these lengths.
+		std::map<std::size_t, std::size_t> prefix_lengths_;
+
+		auto do_subscribe(subscriber s) -> subscription_id
+		{
+			std::lock_guard lock{mutex_};
+
+			const auto id = next_id_++;
+			if (s.prefix)
+			{
+				prefix_subscribers_[s.group].push_back(id);
+				prefix_lengths_[s.group.size()] += 1;
+			}
+			else if (s.key.empty()) { group_subscribers_[s.group].push_back(id); }
+			else { key_subscribers_[s.group][s.key].push_back(id); }
+
+			subscribers_.emplace(id, std::move(s));
+			return id;
+		}
+
+		template<typename Map>
+		static auto erase(Map& map, const string_view_type name, const subscription_id id) -> void
+		{
+			const auto it = map.find(name);
+			if (it == map.end()) { return; }
+
+			std::erase(it->second, id);
+			if (it->second.empty()) { map.erase(it); }
+		}
+
+		// mutex_ must be held
+		auto match(const entry_type& entry, std::map<subscription_id, std::vector<entry_type>>& batches) const -> void
+		{
+			const auto add = [&](const subscribers_type& subscribers) -> void
+			{
+				for (const auto id: subscribers) { batches[id].push_back(entry); }
+			};
+
+			if (const auto it = group_subscribers_.find(entry.group);
+				it != group_subscribers_.end()) { add(it->second); }
+
+			if (const auto it = key_subscribers_.find(entry.group);
+				it != key_subscribers_.end())
+			{
+				if (entry.kind == DiffKind::GROUP_ADDED || entry.kind == DiffKind::GROUP_REMOVED)
+				{
+					// every key of the group has been added/removed
+					for (const auto& [key, subscribers]: it->second) { add(subscribers); }
+				}
+				else if (const auto key_it = it->second.find(entry.key);
+					key_it != it->second.end()) { add(key_it->second); }
+			}
+
+			for (const auto length: prefix_lengths_ | std::views::keys)
+			{
+				if (length > entry.group.size()) { break; }
+
+				if (const auto it = prefix_subscribers_.find(entry.group.substr(0, length));
+					it != prefix_subscribers_.end()) { add(it->second); }
+			}
+		}
+
+	public:
+		SubscriptionRegistry()
+			: next_id_{1} {}
+
+		SubscriptionRegistry(const SubscriptionRegistry&) = delete;
+		SubscriptionRegistry(SubscriptionRegistry&&) = delete;
+		auto operator=(const SubscriptionRegistry&) -> SubscriptionRegistry& = delete;
+		auto operator=(SubscriptionRegistry&&) -> SubscriptionRegistry& = delete;
+
+		~SubscriptionRegistry() noexcept = default;
+
+		// Interested in all changes of the group.
+		auto subscribe(const string_view_type group_name, callback_type callback) -> subscription_id { return do_subscribe({.callback = std::move(callback), .group = string_type{group_name}, .key = {}, .prefix = false}); }
+
+		// Interested in the changes of the key (including the addition/removal of its group).
+		auto subscribe(const string_view_type group_name, const string_view_type key, callback_type callback) -> subscription_id
+		{
+			return do_subscribe({.callback = std::move(callback), .group = string_type{group_name}, .key = string_type{key}, .prefix = false});
+		}
+
+		// Interested in all changes of the groups whose names begin with the prefix.
+		auto subscribe_prefix(const string_view_type group_name_prefix, callback_type callback) -> subscription_id { return do_subscribe({.callback = std::move(callback), .group = string_type{group_name_prefix}, .key = {}, .prefix = true}); }
+
+		auto unsubscribe(const subscription_id id) -> bool
+		{
+			std::lock_guard lock{mutex_};
+
+			const auto it = subscribers_.find(id);
+			if (it == subscribers_.end()) { return false; }
+
+			const auto& s = it->second;
+			if (s.prefix)
+			{
+				erase(prefix_subscribers_, s.group, id);
+				if (const auto length = prefix_lengths_.find(s.group.size());
+					--length->second == 0) { prefix_lengths_.erase(length); }
+			}
+			else if (s.key.empty()) { erase(group_subscribers_, s.group, id); }
+			else if (const auto group = key_subscribers_.find(s.group);
+				group != key_subscribers_.end())
+			{
+				erase(group->second, s.key, id);
+				if (group->second.empty()) { key_subscribers_.erase(group); }
+			}
+
+			subscribers_.erase(it);
+			return true;
+		}
+
+		[[nodiscard]] auto size() const -> std::size_t
+		{
+			std::lock_guard lock{mutex_};
+			return subscribers_.size();
+		}
+
+		/**
+		 * @brief Invoke the callbacks of the subscribers interested in the changes, once per subscriber.
+		 * @tparam Executor auto(Task&& task) -> void, Task is `void()`, it may run the task on another thread.
+		 * @param changes The changes (see ini::diff), the compared data must outlive the callbacks.
+		 * @param executor Where the callbacks are invoked, on the calling thread by default.
+		 * @return The number of subscribers notified.
+		 * @note The callbacks are invoked (or submitted to the executor) after the registry is unlocked, they may subscribe/unsubscribe.
+		 */
+		template<typename Executor = subscription_detail::inline_executor>
+		auto notify(const std::span<const entry_type> changes, Executor&& executor = {}) -> std::size_t
+		{
+			std::vector<std::pair<callback_type, std::vector<entry_type>>> tasks{};
+			{
+				std::lock_guard lock{mutex_};
+
+				// ordered by subscription id => deterministic order
+				std::map<subscription_id, std::vector<entry_type>> batches{};
+				for (const auto& entry: changes) { match(entry, batches); }
+
+				tasks.reserve(batches.size());
+				for (auto& [id, entries]: batches) { tasks.emplace_back(subscribers_.at(id).callback, std::move(entries)); }
+			}
+
+			for (auto& [callback, entries]: tasks)
+			{
+				executor(
+						[callback = std::move(callback), entries = std::move(entries)]() -> void { callback(entries); });
+			}
+
+			return tasks.size();
+		}
+
+		/**
+		 * @brief Compare the old and new data (see ini::diff) and notify the subscribers interested in the changes.
+		 * @return The number of subscribers notified.
+		 * @note The data must outlive the callbacks.
+		 */
+		template<typename OldData, typename NewData, typename Executor = subscription_detail::inline_executor>
+		auto update(const OldData& old_data, const NewData& new_data, Executor&& executor = {}) -> std::size_t
+		{
+			const auto changes = diff(old_data, new_data);
+			return notify(changes, std::forward<Executor>(executor));
+		}
+	};
+}// namespace gal::ini
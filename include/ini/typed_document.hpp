@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ini/extractor.hpp>
+#include <ini/internal/common.hpp>
+#include <ini/internal/convert.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace gal::ini
+{
+	enum class ValueKind : std::uint8_t
+	{
+		// std::int64_t
+		INTEGER,
+		// double
+		FLOAT,
+		// true/false/on/off/yes/no
+		BOOLEAN,
+		// Anything else, the text is kept as-is.
+		STRING,
+	};
+
+	/**
+	 * @brief A value classified (and converted) when it is extracted, 16 bytes whatever the value is.
+	 * The text of a STRING value is stored in the string pool of the document (see `TypedDocument::text`).
+	 */
+	class value_cell
+	{
+		template<typename>
+		friend class TypedDocument;
+
+		union
+		{
+			std::int64_t  integer_;
+			double        floating_;
+			bool          boolean_;
+			// offset in the string pool
+			std::uint64_t offset_;
+		};
+
+		// STRING only
+		std::uint32_t size_;
+		ValueKind     kind_;
+
+	public:
+		constexpr explicit value_cell(const std::int64_t value) noexcept
+			: integer_{value},
+			size_{0},
+			kind_{ValueKind::INTEGER} {}
+
+		constexpr explicit value_cell(const double value) noexcept
+			: floating_{value},
+			size_{0},
+			kind_{ValueKind::FLOAT} {}
+
+		constexpr explicit value_cell(const bool value) noexcept
+			: boolean_{value},
+			size_{0},
+			kind_{ValueKind::BOOLEAN} {}
+
+		constexpr value_cell(const std::uint64_t offset, const std::uint32_t size) noexcept
+			: offset_{offset},
+			size_{size},
+			kind_{ValueKind::STRING} {}
+
+		[[nodiscard]] constexpr auto kind() const noexcept -> ValueKind { return kind_; }
+
+		// INTEGER only
+		[[nodiscard]] constexpr auto integer() const noexcept -> std::int64_t { return integer_; }
+
+		// INTEGER or FLOAT
+		[[nodiscard]] constexpr auto floating() const noexcept -> double { return kind_ == ValueKind::INTEGER ? static_cast<double>(integer_) : floating_; }
+
+		// BOOLEAN only
+		[[nodiscard]] constexpr auto boolean() const noexcept -> bool { return boolean_; }
+	};
+
+	static_assert(sizeof(value_cell) == 16);
+
+	namespace typed_document_detail
+	{
+		/**
+		 * @brief Classify the value, only the first character is checked for most strings.
+		 * @return The converted value, or nullopt if it is a STRING.
+		 */
+		template<typename Char>
+		[[nodiscard]] auto classify(const string_view_t<Char> value) -> std::optional<value_cell>
+		{
+			if (value.empty()) { return std::nullopt; }
+
+			switch (value.front())
+			{
+				case '0':
+				case '1':
+				case '2':
+				case '3':
+				case '4':
+				case '5':
+				case '6':
+				case '7':
+				case '8':
+				case '9':
+				case '+':
+				case '-':
+				case '.':
+				{
+					if (const auto integer = common::from_string<std::int64_t, Char>(value);
+						integer.has_value()) { return value_cell{*integer}; }
+					if (const auto floating = common::from_string<double, Char>(value);
+						floating.has_value()) { return value_cell{*floating}; }
+					return std::nullopt;
+				}
+				case 't':
+				case 'f':
+				case 'o':
+				case 'y':
+				case 'n':
+				{
+					if (const auto boolean = common::from_string<bool, Char>(value);
+						boolean.has_value()) { return value_cell{*boolean}; }
+					return std::nullopt;
+				}
+				default: { return std::nullopt; }
+			}
+		}
+	}// namespace typed_document_detail
+
+	/**
+	 * @brief A document whose values are classified as INTEGER, FLOAT, BOOLEAN or STRING while they are extracted (the text is still in cache),
+	 * the numbers are stored converted in a 16-byte cell and the strings are stored in a single pool, there is no std::basic_string per value.
+	 * @tparam Char Character type of the data.
+	 * @note A number keeps its value but not its spelling (e.g. `+1` => `1`), use an ordinary ContextType if the text must be kept.
+	 */
+	template<typename Char>
+	class TypedDocument
+	{
+	public:
+		using char_type = Char;
+		using string_type = std::basic_string<char_type>;
+		using string_view_type = string_view_t<char_type>;
+
+	private:
+		struct string_hasher
+		{
+			using is_transparent = int;
+
+			[[nodiscard]] auto operator()(const string_view_type string) const noexcept -> std::size_t { return std::hash<string_view_type>{}(string); }
+		};
+
+	public:
+		using group_type = std::unordered_map<string_type, value_cell, string_hasher, std::equal_to<>>;
+		using context_type = std::unordered_map<string_type, group_type, string_hasher, std::equal_to<>>;
+
+	private:
+		context_type groups_;
+		// The text of all STRING values.
+		string_type pool_;
+
+		auto append(group_type& group, const string_view_type key, const string_view_type value) -> std::pair<std::pair<string_view_type, string_view_type>, bool>
+		{
+			if (const auto it = group.find(key);
+				it != group.end()) { return {{it->first, value}, false}; }
+
+			auto cell = typed_document_detail::classify<char_type>(value);
+			if (!cell.has_value())
+			{
+				cell.emplace(static_cast<std::uint64_t>(pool_.size()), static_cast<std::uint32_t>(value.size()));
+				pool_.append(value);
+			}
+
+			const auto it = group.emplace(key, *cell).first;
+			return {{it->first, value}, true};
+		}
+
+		template<typename Extractor>
+		auto extract(Extractor extractor) -> ExtractResult
+		{
+			// We need the following one temporary variable to hold some necessary information, and they must have a longer lifetime than the incoming StackFunction.
+			group_type* current_group = nullptr;
+
+			// !!!MUST PLACE HERE!!!
+			// see extractor_detail::extract_to_context
+			auto kv_appender = [this, &current_group](const string_view_type key, const string_view_type value) -> std::pair<std::pair<string_view_type, string_view_type>, bool> { return append(*current_group, key, value); };
+
+			auto group_appender = [this, &current_group, &kv_appender](const string_view_type group_name) -> group_append_result<char_type>
+			{
+				#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+				const auto workaround_emplace_result = groups_.try_emplace(string_type{group_name});
+				const auto group_it                  = workaround_emplace_result.first;
+				const auto group_inserted            = workaround_emplace_result.second;
+				#else
+				const auto [group_it, group_inserted] = groups_.try_emplace(string_type{group_name});
+				#endif
+
+				current_group = &group_it->second;
+
+				return {
+						.name = group_it->first,
+						.kv_appender = kv_appender,
+						.inserted = group_inserted};
+			};
+
+			return extractor(group_append_type<char_type>{group_appender});
+		}
+
+	public:
+		TypedDocument() = default;
+
+		/**
+		 * @brief Extract ini data from files (appended to the existing data).
+		 * @param file_path The (absolute) path to the file.
+		 * @return Extract result.
+		 */
+		auto extract_from_file(const std::string_view file_path) -> ExtractResult
+		{
+			return extract([file_path](const auto group_appender) -> ExtractResult { return extractor_detail::extract_from_file(file_path, group_appender); });
+		}
+
+		/**
+		 * @brief Extract ini data from buffer (appended to the existing data).
+		 * @param buffer The buffer.
+		 * @return Extract result.
+		 */
+		auto extract_from_buffer(const string_view_type buffer) -> ExtractResult
+		{
+			return extract([buffer](const auto group_appender) -> ExtractResult { return extractor_detail::extract_from_buffer(buffer, group_appender); });
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t { return groups_.size(); }
+
+		[[nodiscard]] auto empty() const noexcept -> bool { return groups_.empty(); }
+
+		[[nodiscard]] auto begin() const noexcept -> typename context_type::const_iterator { return groups_.begin(); }
+
+		[[nodiscard]] auto end() const noexcept -> typename context_type::const_iterator { return groups_.end(); }
+
+		[[nodiscard]] auto contains(const string_view_type group_name) const -> bool { return groups_.contains(group_name); }
+
+		// The cell of the value, or nullptr if the value does not exist.
+		[[nodiscard]] auto find(const string_view_type group_name, const string_view_type key) const -> const value_cell*
+		{
+			if (const auto group = groups_.find(group_name);
+				group != groups_.end())
+			{
+				if (const auto it = group->second.find(key);
+					it != group->second.end()) { return &it->second; }
+			}
+			return nullptr;
+		}
+
+		// The text of a STRING cell (valid until the next extraction).
+		[[nodiscard]] auto text(const value_cell& cell) const noexcept -> string_view_type { return string_view_type{pool_}.substr(static_cast<std::size_t>(cell.offset_), cell.size_); }
+
+		/**
+		 * @brief Get the value.
+		 * @tparam T An integral type (INTEGER), a floating point type (INTEGER or FLOAT), bool (BOOLEAN) or string_view_type (STRING).
+		 * @param group_name Name of the group.
+		 * @param key The key.
+		 * @return The value, or nullopt if the value does not exist or is not of the kind (an integer out of the range of T is not of the kind either).
+		 */
+		template<typename T>
+		[[nodiscard]] auto get(const string_view_type group_name, const string_view_type key) const -> std::optional<T>
+		{
+			const auto* cell = find(group_name, key);
+			if (cell == nullptr) { return std::nullopt; }
+
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				if (cell->kind() == ValueKind::BOOLEAN) { return cell->boolean(); }
+			}
+			else if constexpr (std::is_integral_v<T>)
+			{
+				if (cell->kind() == ValueKind::INTEGER && std::in_range<T>(cell->integer())) { return static_cast<T>(cell->integer()); }
+			}
+			else if constexpr (std::is_floating_point_v<T>)
+			{
+				if (cell->kind() == ValueKind::INTEGER || cell->kind() == ValueKind::FLOAT) { return static_cast<T>(cell->floating()); }
+			}
+			else if constexpr (std::is_same_v<T, string_view_type>)
+			{
+				if (cell->kind() == ValueKind::STRING) { return text(*cell); }
+			}
+			else { []<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported value type!"); }(); }
+
+			return std::nullopt;
+		}
+	};
+}// namespace gal::ini
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <ini/extractor.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <version>
+
+namespace gal::ini
+{
+	/**
+	 * @brief Watch files (or all files in directories) and call the callback on a background thread when a file has changed.
+	 * The directory containing a watched file is watched (inotify on Linux, polling elsewhere), so a file replaced by rename (e.g. by an editor) is still reported.
+	 * Events of the same file are debounced, the callback is only called after the file has been quiet for the debounce interval.
+	 */
+	class FileWatcher
+	{
+	public:
+		using callback_type = std::function<void(const std::filesystem::path& file_path)>;
+
+		constexpr static std::chrono::milliseconds default_debounce{50};
+
+	private:
+		struct implementation;
+
+		std::unique_ptr<implementation> impl_;
+
+	public:
+		/**
+		 * @brief Start the background thread.
+		 * @param callback Called on the background thread with the path of the changed file.
+		 * @param debounce How long a file must be quiet before the callback is called (also the polling interval if inotify is not available).
+		 */
+		GAL_INI_SYMBOL_EXPORT explicit FileWatcher(callback_type callback, std::chrono::milliseconds debounce = default_debounce);
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher(FileWatcher&&) = delete;
+		auto operator=(const FileWatcher&) -> FileWatcher& = delete;
+		auto operator=(FileWatcher&&) -> FileWatcher& = delete;
+
+		// Stop and join the background thread.
+		GAL_INI_SYMBOL_EXPORT ~FileWatcher() noexcept;
+
+		/**
+		 * @brief Watch a file or all (regular) files of a directory.
+		 * @param path The (absolute) path to the file or directory, the directory (containing the file) must exist.
+		 * @return Whether the path is watched.
+		 */
+		[[nodiscard]] GAL_INI_SYMBOL_EXPORT auto watch(std::string_view path) -> bool;
+	};
+
+	namespace watcher_detail
+	{
+		#if defined(__cpp_lib_atomic_shared_ptr)
+		template<typename T>
+		class AtomicSharedPtr
+		{
+			std::atomic<std::shared_ptr<T>> pointer_;
+
+		public:
+			explicit AtomicSharedPtr(std::shared_ptr<T> pointer) noexcept
+				: pointer_{std::move(pointer)} {}
+
+			[[nodiscard]] auto load() const noexcept -> std::shared_ptr<T> { return pointer_.load(std::memory_order_acquire); }
+
+			auto store(std::shared_ptr<T> pointer) noexcept -> void { pointer_.store(std::move(pointer), std::memory_order_release); }
+		};
+		#else
+		template<typename T>
+		class AtomicSharedPtr
+		{
+			std::shared_ptr<T> pointer_;
+
+		public:
+			explicit AtomicSharedPtr(std::shared_ptr<T> pointer) noexcept
+				: pointer_{std::move(pointer)} {}
+
+			[[nodiscard]] auto load() const noexcept -> std::shared_ptr<T> { return std::atomic_load_explicit(&pointer_, std::memory_order_acquire); }
+
+			auto store(std::shared_ptr<T> pointer) noexcept -> void { std::atomic_store_explicit(&pointer_, std::move(pointer), std::memory_order_release); }
+		};
+		#endif
+	}// namespace watcher_detail
+
+	/**
+	 * @brief Keep the extracted data of a file up to date, the file is extracted again on a background thread when it changes.
+	 * Each extraction is published as an immutable snapshot, readers never block and never see a partially extracted snapshot.
+	 * @tparam ContextType Type of the output data, it must own its keys and values (the source is not kept).
+	 */
+	template<typename ContextType>
+	class Watcher
+	{
+	public:
+		using context_type = ContextType;
+		using snapshot_type = std::shared_ptr<const context_type>;
+		// Called on the background thread after each extraction (NOT_MODIFIED if the file was touched but its content did not change).
+		using listener_type = std::function<void(ExtractResult)>;
+
+	private:
+		std::string   file_path_;
+		listener_type listener_;
+
+		std::mutex   reload_mutex_;
+		change_token token_;
+
+		watcher_detail::AtomicSharedPtr<const context_type> snapshot_;
+		std::atomic<std::uint64_t>                          generation_;
+
+		// !!!MUST BE THE LAST MEMBER!!!
+		// The background thread must be stopped before other members are destroyed.
+		FileWatcher watcher_;
+
+		auto reload() -> ExtractResult
+		{
+			std::lock_guard lock{reload_mutex_};
+
+			auto context = std::make_shared<context_type>();
+
+			const auto [result, token] = extract_if_changed<context_type>(file_path_, token_, *context);
+			if (result == ExtractResult::SUCCESS || result == ExtractResult::NOT_MODIFIED) { token_ = token; }
+			if (result == ExtractResult::SUCCESS)
+			{
+				snapshot_.store(std::move(context));
+				generation_.store(common::next_generation(), std::memory_order_release);
+			}
+
+			if (listener_) { listener_(result); }
+			return result;
+		}
+
+	public:
+		/**
+		 * @brief Extract the file and start watching it.
+		 * @param file_path The (absolute) path to the file, the directory containing it must exist (the file itself may not exist yet).
+		 * @param listener Called on the background thread after each extraction.
+		 * @param debounce How long the file must be quiet before it is extracted again.
+		 */
+		explicit Watcher(
+				const std::string_view          file_path,
+				listener_type                   listener = {},
+				const std::chrono::milliseconds debounce = FileWatcher::default_debounce)
+			: file_path_{file_path},
+			listener_{std::move(listener)},
+			token_{},
+			snapshot_{std::make_shared<const context_type>()},
+			generation_{common::next_generation()},
+			watcher_{[this](const std::filesystem::path&) { (void)reload(); }, debounce}
+		{
+			// Watch first, so that no change is missed between the first extraction and the watch.
+			(void)watcher_.watch(file_path_);
+			(void)reload();
+		}
+
+		[[nodiscard]] auto path() const noexcept -> std::string_view { return file_path_; }
+
+		// The latest snapshot (an empty context if the file has never been extracted successfully), never blocks.
+		[[nodiscard]] auto snapshot() const noexcept -> snapshot_type { return snapshot_.load(); }
+
+		// Changes whenever a snapshot is published, unique across all watchers (and documents, see common::next_generation).
+		[[nodiscard]] auto generation() const noexcept -> std::uint64_t { return generation_.load(std::memory_order_acquire); }
+	};
+}// namespace gal::ini
@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <climits>
 #include <filesystem>
-#include <fstream>
+#include <initializer_list>
 #include <ini/extractor.hpp>
 #include <ini/flusher.hpp>
+#include <ini/patch.hpp>
+#include <ini/session.hpp>
 #include <lexy/action/parse.hpp>
 #include <lexy/action/trace.hpp>
 #include <lexy/callback.hpp>
@@ -11,8 +18,22 @@
 #include <lexy/input/string_input.hpp>
 #include <lexy/visualize.hpp>
 #include <lexy_ext/report_error.hpp>
+#include <ostream>
+#include <streambuf>
+#include <string>
 #include <utility>
 
+#if defined(GAL_INI_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
 #define CONSTEVAL constexpr
 #else
@@ -103,6 +124,57 @@ namespace
 						return out;
 					});
 		}
+
+		/**
+		 * \brief Report a value rejected by the validator.
+		 * \param identifier the key of the rejected value
+		 * \param reason why the value is rejected
+		 * \param what_to_do what will happen
+		 * \param position the position of the identifier
+		 * \param buffer file content
+		 * \param anchor file anchor
+		 * \param file_path file path
+		 * \param out_file the destination of the output message, by default, is output directly to stderr
+		 */
+		static auto report_invalid_value(
+				const identifier_type     identifier,
+				const std::string_view    reason,
+				const std::string_view    what_to_do,
+				const position_type       position,
+				const buffer_type&        buffer,
+				const buffer_anchor_type& anchor,
+				const std::string_view    file_path,
+				FILE*                     out_file = stderr
+				) -> void
+		{
+			const auto location = lexy::get_input_location(buffer, position, anchor);
+
+			const auto                        out = lexy::cfile_output_iterator{out_file};
+			const lexy_ext::diagnostic_writer writer{buffer, {.flags = lexy::visualize_fancy}};
+
+			(void)writer.write_message(
+					out,
+					lexy_ext::diagnostic_kind::error,
+					[&](lexy::cfile_output_iterator, lexy::visualization_options)
+					{
+						(void)std::fprintf(out_file, "invalid value of variable '%s', %s...", to_char_string(identifier).data(), what_to_do.data());
+						return out;
+					});
+
+			if (!file_path.empty()) { (void)writer.write_path(out, file_path.data()); }
+
+			(void)writer.write_empty_annotation(out);
+			(void)writer.write_annotation(
+					out,
+					lexy_ext::annotation_kind::primary,
+					location,
+					identifier.size(),
+					[&](lexy::cfile_output_iterator, lexy::visualization_options)
+					{
+						(void)std::fprintf(out_file, "%.*s", static_cast<int>(reason.size()), reason.data());
+						return out;
+					});
+		}
 	};
 
 	namespace grammar
@@ -284,7 +356,15 @@ namespace
 
 			[[nodiscard]] CONSTEVAL static auto name() noexcept -> const char* { return "[value]"; }
 
-			// If a string does not start with double quotes, no special characters and no whitespace are allowed
+			// If a string does not start with double quotes, no special characters and no whitespace are allowed.
+			// The value can be continued on the next lines (see ini::MultilineValue):
+			// 1. the line ends with a backslash:
+			//	key = abc\
+			//		def
+			// 2. the next line is indented (like Python's configparser):
+			//	key = abc
+			//		def
+			// The lexeme covers all the lines (including the backslashes, newlines and indentations), nothing is copied or joined here.
 			constexpr static auto rule = []
 			{
 				// begin with not '\r', '\n', '\r\n' or whitespace
@@ -294,13 +374,36 @@ namespace
 						// see also: variable_pair_or_comment::rule -> dsl::peek(...)
 						- dsl::lit_c<comment_hash_sign<State>::indication> - dsl::lit_c<comment_semicolon<State>::indication>;
 
-				// continue with printable, but excluding '\r', '\n', '\r\n', whitespace and '='
-				constexpr auto continue_with_printable = dsl::unicode::print - dsl::unicode::newline - dsl::unicode::blank;
+				// continue with printable, but excluding '\r', '\n', '\r\n', whitespace and '\'
+				constexpr auto continue_with_printable = dsl::unicode::print - dsl::unicode::newline - dsl::unicode::blank - dsl::backslash;
+
+				// The end of a line of the value, an inline comment may follow the value.
+				constexpr auto line_end = dsl::newline | dsl::eof | dsl::lit_c<comment_hash_sign<State>::indication> | dsl::lit_c<comment_semicolon<State>::indication>;
+
+				// A line that contains only a value (not a comment, not a `key = value`, not a `[group]`) can continue the value.
+				// '=' is only allowed at the end of the line (e.g. the padding of base64).
+				// see also: common::scan_groups, a line beginning with '[' (after blanks) is always a group head.
+				constexpr auto continuation_begin = begin_with_not_blank - dsl::lit_c<'['>;
+				constexpr auto continuation_line =
+						continuation_begin + dsl::while_((continue_with_printable - dsl::equal_sign) | dsl::backslash) +
+						dsl::while_(dsl::equal_sign) + dsl::while_(dsl::unicode::blank) + line_end;
+
+				// A backslash followed by a newline continues the value on the next line (the indentation of the next line is skipped), otherwise it is an ordinary character.
+				constexpr auto backslash_continuation =
+						dsl::backslash >>
+						dsl::if_(dsl::peek(dsl::newline + dsl::while_(dsl::unicode::blank) + continuation_line) >> (dsl::newline + dsl::while_(dsl::unicode::blank)));
+
+				constexpr auto line = dsl::while_(continue_with_printable | backslash_continuation);
+
+				// An indented line continues the value.
+				constexpr auto indented_continuation =
+						dsl::peek(dsl::newline + dsl::while_one(dsl::unicode::blank) + continuation_line) >>
+						(dsl::newline + dsl::while_(dsl::unicode::blank) + line);
 
 				return
 						dsl::peek(begin_with_not_blank) >>
 						(LEXY_DEBUG("parse variable value begin") +
-						dsl::identifier(begin_with_not_blank, continue_with_printable) +
+						dsl::capture(dsl::token(begin_with_not_blank + line + dsl::while_(indented_continuation))) +
 						LEXY_DEBUG("parse variable value end"));
 			}();
 
@@ -705,9 +808,12 @@ namespace
 		group_append_type group_appender_;
 		kv_append_type    kv_appender_;
 
-		#if defined(GAL_INI_DEBUG_GROUP)
+		// The values are accepted as-is if there is no validator.
+		ini::value_validate_type<char_type> value_validator_;
+		bool                                has_value_validator_;
+		bool                                value_rejected_;
+
 		ini::string_view_t<char_type> current_group_;
-		#endif
 
 	public:
 		Extractor(
@@ -718,7 +824,29 @@ namespace
 			buffer_anchor_{buffer_},
 			file_path_{file_path},
 			group_appender_{group_appender},
-			kv_appender_{} {}
+			kv_appender_{},
+			value_validator_{},
+			has_value_validator_{false},
+			value_rejected_{false},
+			current_group_{} {}
+
+		Extractor(
+				const buffer_type&                  buffer,
+				const std::string_view              file_path,
+				group_append_type                   group_appender,
+				ini::value_validate_type<char_type> value_validator)
+			: buffer_{buffer},
+			buffer_anchor_{buffer_},
+			file_path_{file_path},
+			group_appender_{group_appender},
+			kv_appender_{},
+			value_validator_{value_validator},
+			has_value_validator_{true},
+			value_rejected_{false},
+			current_group_{} {}
+
+		// Whether any value has been rejected by the validator.
+		[[nodiscard]] auto value_rejected() const noexcept -> bool { return value_rejected_; }
 
 		// The parser ensures that if Extractor::comment is called, the indication must be valid.
 		auto comment(
@@ -740,9 +868,7 @@ namespace
 			const ini::string_view_t<char_type> user_group_name{group_name.data(), group_name.size()};
 			const auto                          [name, kv_appender, inserted] = group_appender_(user_group_name);
 
-			#if defined(GAL_INI_DEBUG_GROUP)
 			current_group_ = name;
-			#endif
 
 			if (!inserted)
 			{
@@ -771,6 +897,25 @@ namespace
 			const ini::string_view_t<char_type> user_key{variable_key.data(), variable_key.size()};
 			const ini::string_view_t<char_type> user_value{variable_value.data(), variable_value.size()};
 
+			if (has_value_validator_)
+			{
+				// rejected before it is stored
+				if (const auto reason = value_validator_(current_group_, user_key, user_value);
+					!reason.empty())
+				{
+					value_rejected_ = true;
+					error_reporter_type::report_invalid_value(
+							user_key,
+							reason,
+							"this variable will be discarded",
+							position,
+							buffer_,
+							buffer_anchor_,
+							file_path_);
+					return;
+				}
+			}
+
 			// Our parse ensures the kv_appender_ is valid
 			if (
 				const auto& [kv, inserted] = kv_appender_(user_key, user_value);
@@ -795,11 +940,154 @@ namespace
 	// FLUSHER
 	// ========================================
 
+	// Appends everything to the string immediately (there is no put area), so the writes through the stream (the user callbacks) and the direct appends (of the flusher) keep their order.
+	template<typename Char>
+	class StringAppender final : public std::basic_streambuf<Char>
+	{
+	public:
+		using char_type = Char;
+		using traits_type = std::char_traits<char_type>;
+		using int_type = typename traits_type::int_type;
+
+		using string_type = std::basic_string<char_type>;
+
+	private:
+		string_type& target_;
+
+	public:
+		explicit StringAppender(string_type& target)
+			: target_{target} {}
+
+	protected:
+		auto overflow(const int_type c) -> int_type override
+		{
+			if (traits_type::eq_int_type(c, traits_type::eof())) { return traits_type::not_eof(c); }
+
+			target_.push_back(traits_type::to_char_type(c));
+			return c;
+		}
+
+		auto xsputn(const char_type* data, const std::streamsize count) -> std::streamsize override
+		{
+			target_.append(data, static_cast<std::size_t>(count));
+			return count;
+		}
+	};
+
+	// The data (and the size) of the file reach the disk.
+	[[nodiscard]] auto sync_file(const int file, const ini::FlushDurability durability) -> bool
+	{
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		(void)durability;
+		return _commit(file) == 0;
+		#elif defined(GAL_INI_PLATFORM_MACOS)
+		// fsync does not flush the cache of the drive
+		return (durability == ini::FlushDurability::FULL ? ::fcntl(file, F_FULLFSYNC) : ::fsync(file)) == 0;
+		#elif defined(GAL_INI_PLATFORM_LINUX)
+		return (durability == ini::FlushDurability::FULL ? ::fsync(file) : ::fdatasync(file)) == 0;
+		#else
+		(void)durability;
+		return ::fsync(file) == 0;
+		#endif
+	}
+
+	// .file_name.pid.counter.tmp
+	// In the same directory (file system) as the source, so that it can be renamed over the source, a rename across file systems is a copy (and not atomic).
+	[[nodiscard]] auto make_temp_path(const std::filesystem::path& source_path) -> std::filesystem::path
+	{
+		static std::atomic<std::uint64_t> counter{0};
+
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		const auto process_id = _getpid();
+		#else
+		const auto process_id = ::getpid();
+		#endif
+
+		auto name = std::string{"."}
+		            .append(source_path.filename().string())
+		            .append(".")
+		            .append(std::to_string(process_id))
+		            .append(".")
+		            .append(std::to_string(counter.fetch_add(1, std::memory_order_relaxed)))
+		            .append(".tmp");
+		return source_path.parent_path() / name;
+	}
+
+	/**
+	 * @brief Write the data to the file with as few writes as possible (usually one).
+	 * @param overwrite false => create a new file, it is removed if anything fails. true => truncate the existing file and write it in place (not atomic).
+	 * @param binary true => the data is written as is, false => '\n' is written as the line separator of the platform.
+	 */
+	[[nodiscard]] auto write_file(const std::filesystem::path& path, const std::string_view data, const ini::FlushDurability durability, const bool overwrite, const bool binary = false) -> ini::FlushResult
+	{
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		// text mode, '\n' => '\r\n' (see line_separator)
+		const auto mode = binary ? _O_BINARY : _O_TEXT;
+		const auto file = _wopen(path.c_str(), overwrite ? _O_WRONLY | _O_TRUNC | mode : _O_WRONLY | _O_CREAT | _O_EXCL | _O_TRUNC | mode, _S_IREAD | _S_IWRITE);
+		#else
+		(void)binary;
+		const auto file = ::open(path.c_str(), overwrite ? O_WRONLY | O_TRUNC | O_CLOEXEC : O_WRONLY | O_CREAT | O_EXCL | O_TRUNC | O_CLOEXEC, 0666);
+		#endif
+		if (file == -1) { return ini::FlushResult::PERMISSION_DENIED; }
+
+		const auto fail = [&path, file, overwrite]() -> ini::FlushResult
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			_close(file);
+			#else
+			::close(file);
+			#endif
+
+			if (!overwrite)
+			{
+				std::error_code error_code = {};
+				std::filesystem::remove(path, error_code);
+			}
+			return ini::FlushResult::INTERNAL_ERROR;
+		};
+
+		for (auto remaining = data; !remaining.empty();)
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			const auto written = _write(file, remaining.data(), static_cast<unsigned>(std::ranges::min(remaining.size(), std::size_t{INT_MAX})));
+			#else
+			const auto written = ::write(file, remaining.data(), remaining.size());
+			if (written == -1 && errno == EINTR) { continue; }
+			#endif
+			if (written <= 0) { return fail(); }
+
+			remaining.remove_prefix(static_cast<std::size_t>(written));
+		}
+
+		if (durability != ini::FlushDurability::NONE && !sync_file(file, durability)) { return fail(); }
+
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		if (_close(file) != 0)
+		#else
+		if (::close(file) != 0)
+		#endif
+		{
+			if (!overwrite)
+			{
+				std::error_code error_code = {};
+				std::filesystem::remove(path, error_code);
+			}
+			return ini::FlushResult::INTERNAL_ERROR;
+		}
+
+		return ini::FlushResult::SUCCESS;
+	}
+
 	template<bool IsUserOut, typename Encoding, typename Char>
 	class FlushFile
 	{
 	public:
-		explicit FlushFile([[maybe_unused]] const std::string_view file_path) {}
+		FlushFile(
+				[[maybe_unused]] const std::string_view     file_path,
+				[[maybe_unused]] const ini::FlushDurability durability,
+				[[maybe_unused]] const std::size_t          size_hint) {}
+
+		[[nodiscard]] constexpr static auto commit() noexcept -> ini::FlushResult { return ini::FlushResult::SUCCESS; }
 	};
 
 	template<typename Encoding, typename Char>
@@ -811,70 +1099,147 @@ namespace
 		using encoding_char_type = typename Encoding::char_type;
 		using char_type = Char;
 
-		using out_type = std::basic_ofstream<char_type>;
+		using string_type = std::basic_string<char_type>;
+		using out_type = std::basic_ostream<char_type>;
 
 	private:
 		path_type source_path_;
-		path_type temp_path_;
-		out_type  out_;
+		// false => flush to the target only (no file)
+		bool to_file_;
+
+		// Everything is appended to the target (the buffer, or the buffer of the user), the file is written once when committed.
+		string_type               buffer_;
+		string_type&              target_;
+		StringAppender<char_type> appender_;
+		out_type                  out_;
+
+		ini::FlushDurability durability_;
 
 	public:
-		explicit FlushFile(const std::string_view file_path)
+		/**
+		 * @param file_path The path to the target.
+		 * @param durability How the file reaches the disk.
+		 * @param size_hint The size of the source, the output is usually about the same size.
+		 */
+		FlushFile(const std::string_view file_path, const ini::FlushDurability durability, const std::size_t size_hint)
 			: source_path_{file_path},
-			temp_path_{
-					std::filesystem::temp_directory_path() /
-					// todo: Do we need a unique file name? Because if we open the file in std::ios::trunc mode and write less data than before, some unwanted garbage data will be left in the file.
-					source_path_.stem().string().append(std::to_string(reinterpret_cast<std::uintptr_t>(&source_path_))).append(source_path_.extension().string())
-					// source_path_.filename()
-			},
-			out_{temp_path_, std::ios::out | std::ios::trunc}
+			to_file_{true},
+			buffer_{},
+			target_{buffer_},
+			appender_{target_},
+			out_{&appender_},
+			durability_{durability}
 		{
-			// todo: test?
-			assert(ready() && "Cannot open file!");
+			// a little more than the source, so that a few new key-value pairs do not grow the buffer
+			target_.reserve(size_hint + size_hint / 8);
 		}
 
+		/**
+		 * @param file_path The path to the target.
+		 * @param durability How the file reaches the disk.
+		 * @param target Where the data is appended (before it is written to the file).
+		 * @param size_hint The size of the source, the output is usually about the same size.
+		 */
+		FlushFile(const std::string_view file_path, const ini::FlushDurability durability, string_type& target, const std::size_t size_hint)
+			: source_path_{file_path},
+			to_file_{true},
+			buffer_{},
+			target_{target},
+			appender_{target_},
+			out_{&appender_},
+			durability_{durability} { target_.reserve(target_.size() + size_hint + size_hint / 8); }
+
+		/**
+		 * @param target Where the data is appended, no file is written.
+		 * @param size_hint The size of the source, the output is usually about the same size.
+		 */
+		FlushFile(string_type& target, const std::size_t size_hint)
+			: source_path_{},
+			to_file_{false},
+			buffer_{},
+			target_{target},
+			appender_{target_},
+			out_{&appender_},
+			durability_{ini::FlushDurability::NONE} { target_.reserve(target_.size() + size_hint + size_hint / 8); }
+
 		FlushFile(const FlushFile&)                    = delete;
 		FlushFile(FlushFile&&)                         = delete;
 		auto operator=(const FlushFile&) -> FlushFile& = delete;
 		auto operator=(FlushFile&&) -> FlushFile&      = delete;
 
-		~FlushFile() noexcept
+		~FlushFile() noexcept = default;
+
+		/**
+		 * @brief Replace the target with the buffered data.
+		 * temp file => write => (fsync) => rename => (fsync directory)
+		 */
+		[[nodiscard]] auto commit() -> ini::FlushResult
 		{
-			out_.close();
+			// the user wrote something that cannot be written (e.g. an exception in operator<<)
+			if (out_.bad()) { return ini::FlushResult::INTERNAL_ERROR; }
+
+			// no file
+			if (!to_file_) { return ini::FlushResult::SUCCESS; }
+			// there is nothing to open
+			if (source_path_.empty()) { return ini::FlushResult::PERMISSION_DENIED; }
 
 			std::error_code error_code = {};
 
-			if (!exists(source_path_.parent_path(), error_code))
+			// Write through a symlink (the link is kept), the temporary file is created next to the file it refers to.
+			auto target_path = std::filesystem::canonical(source_path_, error_code);
+			if (error_code)
+			{
+				// not exist (yet)
+				target_path = source_path_;
+				error_code.clear();
+			}
+
+			if (target_path.has_parent_path() && !exists(target_path.parent_path(), error_code))
 			{
 				// create directory if not exist
-				create_directories(source_path_.parent_path());
+				create_directories(target_path.parent_path(), error_code);
 			}
 
-			copy_file(
-					temp_path_,
-					source_path_,
-					std::filesystem::copy_options::overwrite_existing,
-					error_code);
-		}
+			const std::string_view data{reinterpret_cast<const char*>(target_.data()), target_.size() * sizeof(char_type)};
 
-		[[nodiscard]] auto ready() const noexcept -> bool
-		{
-			std::error_code error_code = {};
+			#if not defined(GAL_INI_PLATFORM_WINDOWS)
+			struct stat target_status{};
+			const auto  target_exists = ::stat(target_path.c_str(), &target_status) == 0;
 
-			return exists(temp_path_, error_code) && out_.is_open() && out_.good();
-		}
+			// A rename would detach the other hard links from the file, so it is written in place (not atomic).
+			if (target_exists && target_status.st_nlink > 1) { return write_file(target_path, data, durability_, true); }
+			#endif
 
-		template<typename Data>
-		auto operator<<(const Data& data) -> FlushFile&
-		{
-			if constexpr (requires { out_ << data; }) { out_ << data; }
-			else
+			const auto temp_path = make_temp_path(target_path);
+			if (const auto result = write_file(temp_path, data, durability_, false);
+				result != ini::FlushResult::SUCCESS) { return result; }
+
+			// keep the permissions of the target
+			if (const auto status = std::filesystem::status(target_path, error_code);
+				!error_code && std::filesystem::exists(status)) { std::filesystem::permissions(temp_path, status.permissions(), error_code); }
+
+			#if not defined(GAL_INI_PLATFORM_WINDOWS)
+			// keep the owner and the group of the target
+			// The failure is ignored: only root (or the owner, for one of its groups) can do this, the file belongs to the current user then.
+			// note: (void) does not discard a warn_unused_result (chown of glibc) on GCC.
+			if (target_exists) { [[maybe_unused]] const auto owner_kept = ::chown(temp_path.c_str(), target_status.st_uid, target_status.st_gid) == 0; }
+			#endif
+
+			std::filesystem::rename(temp_path, target_path, error_code);
+			if (error_code)
 			{
-				// todo: support char32/16/8_t characters?
-				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "FIXME"); }();
+				std::filesystem::remove(temp_path, error_code);
+				return ini::FlushResult::INTERNAL_ERROR;
 			}
 
-			return *this;
+			if (durability_ == ini::FlushDurability::FULL && !ini::flusher_detail::sync_directory(target_path.string())) { return ini::FlushResult::INTERNAL_ERROR; }
+
+			return ini::FlushResult::SUCCESS;
+		}
+
+		auto write(const std::span<const ini::string_view_t<char_type>> fragments) -> void
+		{
+			for (const auto fragment: fragments) { target_.append(fragment); }
 		}
 
 		[[nodiscard]] auto out() noexcept -> out_type& { return out_; }
@@ -901,6 +1266,7 @@ namespace
 		using file_char_type = FileChar;
 
 		using comment_view_type = ini::comment_view_type<ini::string_view_t<char_type>>;
+		using line_end_type = ini::line_end_type<char_type>;
 
 		using error_reporter_type = ErrorReporter<encoding>;
 		static_assert(std::is_same_v<buffer_type, typename error_reporter_type::buffer_type>);
@@ -918,31 +1284,55 @@ namespace
 
 		comment_view_type last_comment_;
 
+		bool finished_;
+
 		#if defined(GAL_INI_DEBUG_GROUP)
 		ini::string_view_t<char_type> current_group_;
 		#endif
 
 		auto clear_last_comment() -> void { last_comment_ = {}; }
 
+		// All the fragments of a line are written at once (one virtual call for UserOut).
+		auto write_line(const std::initializer_list<ini::string_view_t<char_type>> fragments) -> void
+		{
+			if constexpr (is_user_out) { group_handle_.user().write({fragments.begin(), fragments.size()}); }
+			else { file_.write({fragments.begin(), fragments.size()}); }
+		}
+
+		/**
+		 * @brief The group head (or the key-value pair) and the end of its line are written at once.
+		 * @param indication The indication of the inline comment, the line has no inline comment if it is invalid.
+		 * @param flush The flush handle, it is called with the end of the line ('space' inline_comment_indication 'space' inline_comment '\n').
+		 * @note For UserOut the handle writes the end of the line itself (one virtual call for the whole line), otherwise it is appended to the buffer after the handle.
+		 */
+		template<typename Function>
+		auto flush_line(const char_type indication, const ini::string_view_t<char_type> inline_comment, Function flush) -> void
+		{
+			const ini::string_view_t<char_type> fragments[]{
+					ini::blank_separator<ini::string_view_t<char_type>>,
+					{&indication, 1},
+					ini::blank_separator<ini::string_view_t<char_type>>,
+					inline_comment,
+					ini::line_separator<ini::string_view_t<char_type>>};
+
+			// '\n' only
+			const auto line_end = ini::make_comment_indication<ini::string_view_t<char_type>>(indication) != ini::CommentIndication::INVALID ? line_end_type{fragments} : line_end_type{fragments}.last(1);
+
+			flush(line_end);
+			if constexpr (not is_user_out) { file_.write(line_end); }
+		}
+
 		auto flush_last_comment() -> void
 		{
 			if (!last_comment_.empty())
 			{
 				// 'indication' 'space' comment '\n'
-				if constexpr (is_user_out)
-				{
-					group_handle_.user()
-							<< ini::make_comment_indication<ini::string_view_t<char_type>>(last_comment_.indication)
-							<< ini::blank_separator<ini::string_view_t<char_type>> << last_comment_.comment
-							<< ini::line_separator<ini::string_view_t<char_type>>;
-				}
-				else
-				{
-					file_
-							<< ini::make_comment_indication<ini::string_view_t<char_type>>(last_comment_.indication)
-							<< ini::blank_separator<ini::string_view_t<char_type>> << last_comment_.comment
-							<< ini::line_separator<ini::string_view_t<char_type>>;
-				}
+				const auto indication = ini::make_comment_indication<ini::string_view_t<char_type>>(last_comment_.indication);
+				write_line({
+						{&indication, 1},
+						ini::blank_separator<ini::string_view_t<char_type>>,
+						last_comment_.comment,
+						ini::line_separator<ini::string_view_t<char_type>>});
 
 				clear_last_comment();
 			}
@@ -955,30 +1345,15 @@ namespace
 			// [group_name] ; inline_comment
 			flush_last_comment();
 
-			// [group_name] <-- flush this
-			if constexpr (is_user_out) { kv_handle_ = group_handle_.flush(name); }
-			else { kv_handle_ = group_handle_.flush(file_.out(), name); }
-
 			// [group_name] ; inline_comment <-- flush this
-			if (inline_comment.indication != ini::CommentIndication::INVALID)
-			{
-				// 'space' inline_comment_indication 'space' inline_comment
-				if constexpr (is_user_out)
-				{
-					group_handle_.user()
-							<< ini::blank_separator<ini::string_view_t<char_type>> << make_comment_indication<ini::string_view_t<char_type>>(inline_comment.indication)
-							<< ini::blank_separator<ini::string_view_t<char_type>> << inline_comment.comment;
-				}
-				else
-				{
-					file_
-							<< ini::blank_separator<ini::string_view_t<char_type>> << make_comment_indication<ini::string_view_t<char_type>>(inline_comment.indication)
-							<< ini::blank_separator<ini::string_view_t<char_type>> << inline_comment.comment;
-				}
-			}
-
-			// '\n'
-			blank_line();
+			flush_line(
+					inline_comment.indication == ini::CommentIndication::INVALID ? char_type{0} : make_comment_indication<ini::string_view_t<char_type>>(inline_comment.indication),
+					inline_comment.comment,
+					[this, name]([[maybe_unused]] const line_end_type line_end) -> void
+					{
+						if constexpr (is_user_out) { kv_handle_ = group_handle_.flush(name, line_end); }
+						else { kv_handle_ = group_handle_.flush(file_.out(), name); }
+					});
 		}
 
 		auto flush_kvs_remaining() -> void
@@ -995,12 +1370,42 @@ namespace
 
 	public:
 		Flusher(
-				const std::string_view file_path,
-				group_handle_type      group_handle)
-			: file_{file_path},
+				const std::string_view     file_path,
+				group_handle_type          group_handle,
+				const ini::FlushDurability durability,
+				const std::size_t          size_hint)
+			: file_{file_path, durability, size_hint},
+			group_handle_{group_handle},
+			kv_handle_{},
+			last_comment_{},
+			finished_{false}
+		{
+			if constexpr (is_user_out) { group_handle_.user().reserve(size_hint); }
+		}
+
+		// Flush to the file, the data written is appended to the target.
+		Flusher(
+				const std::string_view             file_path,
+				group_handle_type                  group_handle,
+				const ini::FlushDurability         durability,
+				std::basic_string<file_char_type>& target,
+				const std::size_t                  size_hint)
+			: file_{file_path, durability, target, size_hint},
+			group_handle_{group_handle},
+			kv_handle_{},
+			last_comment_{},
+			finished_{false} {}
+
+		// Flush to the target (no file).
+		Flusher(
+				std::basic_string<file_char_type>& target,
+				group_handle_type                  group_handle,
+				const std::size_t                  size_hint)
+			: file_{target, size_hint},
 			group_handle_{group_handle},
 			kv_handle_{},
-			last_comment_{} {}
+			last_comment_{},
+			finished_{false} {}
 
 		Flusher(const Flusher&)                    = delete;
 		Flusher(Flusher&&)                         = delete;
@@ -1008,9 +1413,26 @@ namespace
 		auto operator=(Flusher&&) -> Flusher&      = delete;
 
 		~Flusher() noexcept
+		{
+			if (!finished_)
+			{
+				flush_kvs_remaining();
+				flush_group_remaining();
+			}
+		}
+
+		/**
+		 * @brief Flush the remaining data and replace the target with the written file (if any).
+		 * @return Flush result.
+		 */
+		[[nodiscard]] auto finish() -> ini::FlushResult
 		{
 			flush_kvs_remaining();
 			flush_group_remaining();
+			finished_ = true;
+
+			if constexpr (is_user_out) { group_handle_.user().flush(); }
+			return file_.commit();
 		}
 
 		// The parser ensures that if Flusher::comment is called, the indication must be valid.
@@ -1063,89 +1485,584 @@ namespace
 			{
 				flush_last_comment();
 
-				if constexpr (is_user_out) { kv_handle_.flush(user_key); }
-				else { kv_handle_.flush(file_.out(), user_key); }
-
 				// key = value ; inline_comment <-- flush this
-				if (const auto indication = ini::make_comment_indication<ini::string_view_t<char_type>>(inline_comment.first);
-					indication != ini::CommentIndication::INVALID)
-				{
-					const ini::string_view_t<char_type> user_comment_context{inline_comment.second.data(), inline_comment.second.size()};
-
-					// 'space' inline_comment_indication 'space' inline_comment
-					if constexpr (is_user_out)
-					{
-						group_handle_.user()
-								<< ini::blank_separator<ini::string_view_t<char_type>> << inline_comment.first
-								<< ini::blank_separator<ini::string_view_t<char_type>> << user_comment_context;
-					}
-					else
-					{
-						file_
-								<< ini::blank_separator<ini::string_view_t<char_type>> << inline_comment.first
-								<< ini::blank_separator<ini::string_view_t<char_type>> << user_comment_context;
-					}
-				}
-
-				// '\n'
-				blank_line();
+				flush_line(
+						inline_comment.first,
+						{inline_comment.second.data(), inline_comment.second.size()},
+						[this, user_key]([[maybe_unused]] const line_end_type line_end) -> void
+						{
+							if constexpr (is_user_out) { kv_handle_.flush(user_key, line_end); }
+							else { kv_handle_.flush(file_.out(), user_key); }
+						});
 			}
 		}
 
-		auto blank_line() -> void
-		{
-			if constexpr (is_user_out) { group_handle_.user() << ini::line_separator<ini::string_view_t<char_type>>; }
-			else { file_ << ini::line_separator<ini::string_view_t<char_type>>; }
-		}
+		auto blank_line() -> void { write_line({ini::line_separator<ini::string_view_t<char_type>>}); }
 	};
-}
 
-namespace gal::ini
-{
-	namespace extractor_detail
+	// ========================================
+	// SKELETON
+	// ========================================
+
+	// Records the offsets of the lines of the source (see ini::skeleton_line), nothing is copied.
+	class Skeleton
 	{
-		namespace
-		{
-			template<typename State>
-			[[nodiscard]] auto do_extract_from_file(
-					std::string_view                             file_path,
-					group_append_type<typename State::char_type> group_appender) -> ExtractResult
-			{
-				if (std::error_code error_code = {};
-					!std::filesystem::exists(file_path, error_code)) { return ExtractResult::FILE_NOT_FOUND; }
+	public:
+		using encoding = lexy::utf8_char_encoding;
 
-				if (auto file = lexy::read_file<typename State::encoding>(file_path.data());
-					!file)
-				{
-					switch (file.error())
-					{
-						case lexy::file_error::file_not_found: { return ExtractResult::FILE_NOT_FOUND; }
-						case lexy::file_error::permission_denied: { return ExtractResult::PERMISSION_DENIED; }
-						case lexy::file_error::os_error: { return ExtractResult::INTERNAL_ERROR; }
-						case lexy::file_error::_success:
-						default: { GAL_INI_UNREACHABLE(); }
-					}
-				}
-				else
-				{
-					State state{{file.buffer().data(), file.buffer().size()}, file_path, group_appender};
+		using char_type = typename encoding::char_type;
+		using buffer_type = lexy::string_input<encoding>;
+		using reader_type = decltype(std::declval<const buffer_type&>().reader());
+		using position_type = typename reader_type::iterator;
+		using lexeme_type = lexy::lexeme<reader_type>;
 
-					parse(state, typename State::buffer_type{file.buffer().data(), file.buffer().size()}, file_path);
+		using error_reporter_type = ErrorReporter<encoding>;
 
-					return ExtractResult::SUCCESS;
-				}
-			}
+	private:
+		std::string_view    source_;
+		ini::skeleton_type& out_;
 
-			template<typename State>
-			[[nodiscard]] auto do_extract_from_buffer(
-					std::basic_string_view<typename State::char_type> buffer,
-					group_append_type<typename State::char_type>      group_appender) -> ExtractResult
-			{
-				State state{{buffer.data(), buffer.size()}, State::error_reporter_type::buffer_file_path, group_appender};
+		[[nodiscard]] auto offset_of(const char_type* position) const noexcept -> std::size_t { return static_cast<std::size_t>(position - source_.data()); }
 
-				parse(state, typename State::buffer_type{buffer.data(), buffer.size()}, State::error_reporter_type::buffer_file_path);
+		[[nodiscard]] auto range_of(const lexeme_type lexeme) const noexcept -> ini::source_range
+		{
+			if (lexeme.data() == nullptr) { return {}; }
+			return {.begin = offset_of(lexeme.data()), .size = lexeme.size()};
+		}
 
-				return ExtractResult::SUCCESS;
+		// [the beginning of the line of begin, the beginning of the line after end)
+		[[nodiscard]] auto line_of(const std::size_t begin, const std::size_t end) const noexcept -> ini::source_range
+		{
+			const auto previous_newline = begin == 0 ? std::string_view::npos : source_.rfind('\n', begin - 1);
+			const auto newline          = source_.find('\n', end);
+
+			const auto first = previous_newline == std::string_view::npos ? 0 : previous_newline + 1;
+			const auto last  = newline == std::string_view::npos ? source_.size() : newline + 1;
+			return {.begin = first, .size = last - first};
+		}
+
+	public:
+		Skeleton(const std::string_view source, ini::skeleton_type& out)
+			: source_{source},
+			out_{out} {}
+
+		auto comment(
+				const char_type   indication,
+				const lexeme_type context) -> void
+		{
+			const auto name = range_of(context);
+
+			out_.push_back({
+					.kind = ini::SkeletonLine::COMMENT,
+					.indication = indication,
+					.line = line_of(name.begin, name.end()),
+					.name = name,
+					.value = {},
+					.inline_comment = {}});
+		}
+
+		auto group(
+				const position_type                     position,
+				const lexeme_type                       group_name,
+				const std::pair<char_type, lexeme_type> inline_comment) -> void
+		{
+			const auto name    = range_of(group_name);
+			const auto comment = range_of(inline_comment.second);
+
+			out_.push_back({
+					.kind = ini::SkeletonLine::GROUP,
+					.indication = inline_comment.first,
+					.line = line_of(offset_of(position), std::max(name.end(), comment.end())),
+					.name = name,
+					.value = {},
+					.inline_comment = comment});
+		}
+
+		auto value(
+				const position_type                     position,
+				const lexeme_type                       variable_key,
+				const lexeme_type                       variable_value,
+				const std::pair<char_type, lexeme_type> inline_comment) -> void
+		{
+			const auto name    = range_of(variable_key);
+			const auto comment = range_of(inline_comment.second);
+
+			auto value = range_of(variable_value);
+			if (variable_value.data() == nullptr)
+			{
+				// key = ; inline_comment
+				//       ^ where the value would be
+				auto begin = source_.find(ini::kv_separator<std::string_view>[0], name.end()) + 1;
+				while (begin < source_.size() && (source_[begin] == ' ' || source_[begin] == '\t')) { ++begin; }
+				// key = ""
+				//        ^
+				if (begin < source_.size() && source_[begin] == '"') { ++begin; }
+				value = {.begin = begin, .size = 0};
+			}
+
+			out_.push_back({
+					.kind = ini::SkeletonLine::VARIABLE,
+					.indication = inline_comment.first,
+					.line = line_of(offset_of(position), std::max(value.end(), comment.end())),
+					.name = name,
+					.value = value,
+					.inline_comment = comment});
+		}
+
+		auto blank_line() -> void { out_.push_back({.kind = ini::SkeletonLine::BLANK, .indication = 0, .line = {}, .name = {}, .value = {}, .inline_comment = {}}); }
+	};
+
+	// Extracts the source and records its skeleton with the same parse (see ini::Session).
+	template<typename Encoding, typename GroupAppend, typename KvAppend>
+	class SkeletonExtractor : public Extractor<Encoding, GroupAppend, KvAppend>
+	{
+	public:
+		using extractor_type = Extractor<Encoding, GroupAppend, KvAppend>;
+
+		using typename extractor_type::encoding;
+		using typename extractor_type::group_append_type;
+
+		using typename extractor_type::char_type;
+		using typename extractor_type::buffer_type;
+		using typename extractor_type::position_type;
+		using typename extractor_type::lexeme_type;
+
+		using typename extractor_type::error_reporter_type;
+
+		static_assert(std::is_same_v<position_type, Skeleton::position_type>);
+		static_assert(std::is_same_v<lexeme_type, Skeleton::lexeme_type>);
+
+	private:
+		Skeleton skeleton_;
+
+	public:
+		SkeletonExtractor(
+				const buffer_type&     buffer,
+				const std::string_view file_path,
+				group_append_type      group_appender,
+				const std::string_view source,
+				ini::skeleton_type&    skeleton)
+			: extractor_type{buffer, file_path, group_appender},
+			skeleton_{source, skeleton} {}
+
+		auto comment(
+				const char_type   indication,
+				const lexeme_type context) -> void
+		{
+			extractor_type::comment(indication, context);
+			skeleton_.comment(indication, context);
+		}
+
+		auto group(
+				const position_type                     position,
+				const lexeme_type                       group_name,
+				const std::pair<char_type, lexeme_type> inline_comment) -> void
+		{
+			extractor_type::group(position, group_name, inline_comment);
+			skeleton_.group(position, group_name, inline_comment);
+		}
+
+		auto value(
+				const position_type                     position,
+				const lexeme_type                       variable_key,
+				const lexeme_type                       variable_value,
+				const std::pair<char_type, lexeme_type> inline_comment) -> void
+		{
+			extractor_type::value(position, variable_key, variable_value, inline_comment);
+			skeleton_.value(position, variable_key, variable_value, inline_comment);
+		}
+
+		auto blank_line() -> void
+		{
+			extractor_type::blank_line();
+			skeleton_.blank_line();
+		}
+	};
+
+	// Records the skeleton of the lines written by a Flusher while they are written (see ini::Session), nothing is parsed.
+	// The lines are in the form written by Flusher and flusher_detail::with_ostream_handle: `; comment`, `[group] ; inline_comment`, `key = value ; inline_comment` and blank lines (ended with ini::line_separator).
+	// A line that may not be read back as it is recorded (e.g. a value that contains a blank, or a line before the first group) makes the recording inexact, the output must be scanned then.
+	class SkeletonRecorder
+	{
+	public:
+		using char_type = char;
+
+	private:
+		const std::string&  output_;
+		ini::skeleton_type& out_;
+
+		// the beginning of the first line that has not been recorded
+		std::size_t recorded_;
+		bool        in_group_;
+		// a comment before the first group, it must be followed by the group head
+		bool comment_before_group_;
+		bool exact_;
+
+		// The comments and the names read by the parser are always printable (and so are the values, except that they do not contain blanks), assumes the bytes of UTF-8 are printable.
+		[[nodiscard]] constexpr static auto is_printable(const char_type c) noexcept -> bool { return static_cast<unsigned char>(c) >= 0x20 && c != 0x7f; }
+
+		[[nodiscard]] constexpr static auto is_blank(const char_type c) noexcept -> bool { return c == ' ' || c == '\t'; }
+
+		// printable, and neither begins nor ends with a blank
+		[[nodiscard]] constexpr static auto is_text(const std::string_view text) noexcept -> bool
+		{
+			return !text.empty() && !is_blank(text.front()) && !is_blank(text.back()) && std::ranges::all_of(text, is_printable);
+		}
+
+		// see grammar::variable_key
+		[[nodiscard]] constexpr static auto is_key(const std::string_view key) noexcept -> bool
+		{
+			return is_text(key) &&
+			       std::ranges::none_of(key, [](const char_type c) noexcept -> bool { return is_blank(c) || c == ini::kv_separator<std::string_view>[0]; });
+		}
+
+		// see grammar::variable_value, only the values that are neither quoted nor continued
+		[[nodiscard]] constexpr static auto is_value(const std::string_view value) noexcept -> bool
+		{
+			return is_text(value) &&
+			       value.front() != ini::kv_separator<std::string_view>[0] &&
+			       value.front() != '"' &&
+			       ini::make_comment_indication<std::string_view>(value.front()) == ini::CommentIndication::INVALID &&
+			       std::ranges::none_of(value, [](const char_type c) noexcept -> bool { return is_blank(c) || c == '\\'; });
+		}
+
+		// ` ; inline_comment` (or nothing) after the group head or the value at begin, the inline comment is stored in line
+		[[nodiscard]] auto inline_comment_of(const std::size_t begin, const std::size_t end, ini::skeleton_line& line) const -> bool
+		{
+			const auto rest = std::string_view{output_}.substr(begin, end - begin);
+			if (rest.empty()) { return true; }
+
+			if (rest.size() < 3 ||
+			    rest[0] != ' ' ||
+			    ini::make_comment_indication<std::string_view>(rest[1]) == ini::CommentIndication::INVALID ||
+			    rest[2] != ' ' ||
+			    !is_text(rest.substr(3))) { return false; }
+
+			line.indication     = rest[1];
+			line.inline_comment = {.begin = begin + 3, .size = rest.size() - 3};
+			return true;
+		}
+
+		// [begin, newline] is the line, newline is the offset of its '\n'
+		[[nodiscard]] auto record_line(const std::size_t begin, const std::size_t newline) -> bool
+		{
+			auto text = std::string_view{output_}.substr(begin, newline - begin);
+			// see ini::line_separator
+			if (text.ends_with('\r')) { text.remove_suffix(1); }
+			const auto end = begin + text.size();
+
+			ini::skeleton_line line{
+					.kind = ini::SkeletonLine::BLANK,
+					.indication = 0,
+					.line = {.begin = begin, .size = newline + 1 - begin},
+					.name = {},
+					.value = {},
+					.inline_comment = {}};
+
+			// a blank line, a key-value pair or a second comment before the first group is ignored by the parser
+			if (comment_before_group_ && (text.empty() || text.front() != ini::square_bracket<std::string_view>.first)) { return false; }
+
+			if (text.empty())
+			{
+				if (!in_group_) { return false; }
+
+				line.line = {};
+			}
+			else if (ini::make_comment_indication<std::string_view>(text.front()) != ini::CommentIndication::INVALID)
+			{
+				// 'indication' 'space' comment
+				if (text.size() < 2 || text[1] != ' ' || !is_text(text.substr(2))) { return false; }
+
+				line.kind       = ini::SkeletonLine::COMMENT;
+				line.indication = text.front();
+				line.name       = {.begin = begin + 2, .size = text.size() - 2};
+
+				comment_before_group_ = !in_group_;
+			}
+			else if (text.front() == ini::square_bracket<std::string_view>.first)
+			{
+				// '[' group_name ']' inline_comment
+				const auto close = text.find(ini::square_bracket<std::string_view>.second);
+				if (close == std::string_view::npos || !is_text(text.substr(1, close - 1))) { return false; }
+
+				line.kind = ini::SkeletonLine::GROUP;
+				line.name = {.begin = begin + 1, .size = close - 1};
+				if (!inline_comment_of(begin + close + 1, end, line)) { return false; }
+
+				in_group_             = true;
+				comment_before_group_ = false;
+			}
+			else
+			{
+				// key 'space' '=' 'space' value inline_comment
+				if (!in_group_) { return false; }
+
+				const auto key_end     = text.find(' ');
+				const auto value_begin = key_end + 3;
+				if (key_end == std::string_view::npos || !is_key(text.substr(0, key_end)) || text.substr(key_end, 3) != " = ") { return false; }
+
+				const auto value_end = std::ranges::min(text.find(' ', value_begin), text.size());
+				if (!is_value(text.substr(value_begin, value_end - value_begin))) { return false; }
+
+				line.kind  = ini::SkeletonLine::VARIABLE;
+				line.name  = {.begin = begin, .size = key_end};
+				line.value = {.begin = begin + value_begin, .size = value_end - value_begin};
+				if (!inline_comment_of(begin + value_end, end, line)) { return false; }
+			}
+
+			out_.push_back(line);
+			return true;
+		}
+
+	public:
+		SkeletonRecorder(const std::string& output, ini::skeleton_type& out)
+			: output_{output},
+			out_{out},
+			recorded_{output.size()},
+			in_group_{false},
+			comment_before_group_{false},
+			exact_{true} {}
+
+		// Record the lines written since the last call.
+		auto record() -> void
+		{
+			for (auto newline = output_.find('\n', recorded_); exact_ && newline != std::string::npos; newline = output_.find('\n', recorded_))
+			{
+				exact_    = record_line(recorded_, newline);
+				recorded_ = newline + 1;
+			}
+		}
+
+		// Record the last lines, the output must end with a complete line.
+		[[nodiscard]] auto finish() -> bool
+		{
+			record();
+			return exact_ && recorded_ == output_.size() && !comment_before_group_;
+		}
+	};
+
+	// Flushes the data by replaying a skeleton and records the skeleton of the data written (see ini::Session).
+	template<typename Encoding, typename GroupHandle, typename KvHandle>
+	class SkeletonFlusher : public Flusher<Encoding, GroupHandle, KvHandle, false>
+	{
+	public:
+		using flusher_type = Flusher<Encoding, GroupHandle, KvHandle, false>;
+
+		using typename flusher_type::group_handle_type;
+
+		using typename flusher_type::char_type;
+		using typename flusher_type::position_type;
+		using typename flusher_type::lexeme_type;
+
+		static_assert(std::is_same_v<char_type, SkeletonRecorder::char_type>);
+
+	private:
+		SkeletonRecorder recorder_;
+
+	public:
+		SkeletonFlusher(
+				const std::string_view     file_path,
+				group_handle_type          group_handle,
+				const ini::FlushDurability durability,
+				std::string&               target,
+				const std::size_t          size_hint,
+				ini::skeleton_type&        skeleton)
+			: flusher_type{file_path, group_handle, durability, target, size_hint},
+			recorder_{target, skeleton} {}
+
+		/**
+		 * @brief Flush the remaining data and replace the target with the written file.
+		 * @return Flush result and whether the skeleton of the data written was recorded (false => it must be scanned).
+		 */
+		[[nodiscard]] auto finish() -> std::pair<ini::FlushResult, bool>
+		{
+			const auto result = flusher_type::finish();
+			return {result, recorder_.finish()};
+		}
+
+		// comment => nothing is written until the line it belongs to is written
+
+		auto group(
+				const position_type                     position,
+				const lexeme_type                       group_name,
+				const std::pair<char_type, lexeme_type> inline_comment) -> void
+		{
+			flusher_type::group(position, group_name, inline_comment);
+			recorder_.record();
+		}
+
+		auto value(
+				const position_type                     position,
+				const lexeme_type                       variable_key,
+				const lexeme_type                       variable_value,
+				const std::pair<char_type, lexeme_type> inline_comment) -> void
+		{
+			flusher_type::value(position, variable_key, variable_value, inline_comment);
+			recorder_.record();
+		}
+
+		auto blank_line() -> void
+		{
+			flusher_type::blank_line();
+			recorder_.record();
+		}
+	};
+}
+
+namespace gal::ini
+{
+	namespace extractor_detail
+	{
+		namespace
+		{
+			// ValueValidate: nothing or value_validate_type<typename State::char_type>
+			template<typename State, typename... ValueValidate>
+			[[nodiscard]] auto do_extract_from_file(
+					std::string_view                             file_path,
+					group_append_type<typename State::char_type> group_appender,
+					ValueValidate... value_validator) -> ExtractResult
+			{
+				if (std::error_code error_code = {};
+					!std::filesystem::exists(file_path, error_code)) { return ExtractResult::FILE_NOT_FOUND; }
+
+				if (auto file = lexy::read_file<typename State::encoding>(file_path.data());
+					!file)
+				{
+					switch (file.error())
+					{
+						case lexy::file_error::file_not_found: { return ExtractResult::FILE_NOT_FOUND; }
+						case lexy::file_error::permission_denied: { return ExtractResult::PERMISSION_DENIED; }
+						case lexy::file_error::os_error: { return ExtractResult::INTERNAL_ERROR; }
+						case lexy::file_error::_success:
+						default: { GAL_INI_UNREACHABLE(); }
+					}
+				}
+				else
+				{
+					State state{{file.buffer().data(), file.buffer().size()}, file_path, group_appender, value_validator...};
+
+					parse(state, typename State::buffer_type{file.buffer().data(), file.buffer().size()}, file_path);
+
+					return state.value_rejected() ? ExtractResult::INVALID_DATA : ExtractResult::SUCCESS;
+				}
+			}
+
+			template<typename Encoding>
+			[[nodiscard]] auto do_read_file(
+					std::string_view                                 file_path,
+					std::basic_string<typename Encoding::char_type>& out) -> ExtractResult
+			{
+				if (auto file = lexy::read_file<Encoding>(file_path.data());
+					!file)
+				{
+					switch (file.error())
+					{
+						case lexy::file_error::file_not_found: { return ExtractResult::FILE_NOT_FOUND; }
+						case lexy::file_error::permission_denied: { return ExtractResult::PERMISSION_DENIED; }
+						case lexy::file_error::os_error: { return ExtractResult::INTERNAL_ERROR; }
+						case lexy::file_error::_success:
+						default: { GAL_INI_UNREACHABLE(); }
+					}
+				}
+				else
+				{
+					out.assign(file.buffer().data(), file.buffer().size());
+					return ExtractResult::SUCCESS;
+				}
+			}
+
+			// ValueValidate: nothing or value_validate_type<typename State::char_type>
+			template<typename State, typename... ValueValidate>
+			[[nodiscard]] auto do_extract_from_buffer(
+					std::basic_string_view<typename State::char_type> buffer,
+					group_append_type<typename State::char_type>      group_appender,
+					ValueValidate... value_validator) -> ExtractResult
+			{
+				State state{{buffer.data(), buffer.size()}, State::error_reporter_type::buffer_file_path, group_appender, value_validator...};
+
+				parse(state, typename State::buffer_type{buffer.data(), buffer.size()}, State::error_reporter_type::buffer_file_path);
+
+				return state.value_rejected() ? ExtractResult::INVALID_DATA : ExtractResult::SUCCESS;
+			}
+
+			// The modification time of a file written within this window may still change without changing the size (the resolution of mtime is coarse on some file systems),
+			// so the token made from it must not be trusted and the content will be hashed again next time.
+			constexpr std::chrono::seconds racy_mtime_window{2};
+
+			[[nodiscard]] auto do_read_change_token(const std::string_view file_path) -> change_token
+			{
+				const std::filesystem::path path{file_path};
+
+				std::error_code error_code{};
+				const auto      size = std::filesystem::file_size(path, error_code);
+				if (error_code) { return {}; }
+				const auto last_write_time = std::filesystem::last_write_time(path, error_code);
+				if (error_code) { return {}; }
+
+				change_token token{
+						.inode = 0,
+						.size = static_cast<std::uint64_t>(size),
+						.mtime_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(last_write_time.time_since_epoch()).count(),
+						.hash = 0};
+
+				#if not defined(GAL_INI_PLATFORM_WINDOWS)
+				// the file may be replaced (rename) by a file with the same size and mtime
+				if (struct stat file_stat{};
+					::stat(path.c_str(), &file_stat) == 0) { token.inode = static_cast<std::uint64_t>(file_stat.st_ino); }
+				#endif
+
+				if (std::filesystem::file_time_type::clock::now() - last_write_time < racy_mtime_window) { token.mtime_ns = 0; }
+
+				return token;
+			}
+
+			template<typename State>
+			[[nodiscard]] auto do_extract_from_file_if_changed(
+					std::string_view                             file_path,
+					change_token&                                token,
+					group_append_type<typename State::char_type> group_appender) -> ExtractResult
+			{
+				auto new_token = do_read_change_token(file_path);
+
+				// mtime_ns == 0 => racy or never extracted
+				if (token.mtime_ns != 0 &&
+				    new_token.inode == token.inode &&
+				    new_token.size == token.size &&
+				    new_token.mtime_ns == token.mtime_ns) { return ExtractResult::NOT_MODIFIED; }
+
+				if (auto file = lexy::read_file<typename State::encoding>(file_path.data());
+					!file)
+				{
+					switch (file.error())
+					{
+						case lexy::file_error::file_not_found: { return ExtractResult::FILE_NOT_FOUND; }
+						case lexy::file_error::permission_denied: { return ExtractResult::PERMISSION_DENIED; }
+						case lexy::file_error::os_error: { return ExtractResult::INTERNAL_ERROR; }
+						case lexy::file_error::_success:
+						default: { GAL_INI_UNREACHABLE(); }
+					}
+				}
+				else
+				{
+					const auto buffer = file.buffer();
+
+					// The size is still the size of the file (see do_read_change_token), the buffer has no BOM.
+					new_token.hash = common::hash_bytes(buffer.data(), buffer.size() * sizeof(typename State::char_type));
+
+					// touched (or replaced) but the content is the same
+					if (token.hash != 0 && new_token.size == token.size && new_token.hash == token.hash)
+					{
+						token = new_token;
+						return ExtractResult::NOT_MODIFIED;
+					}
+
+					State state{{buffer.data(), buffer.size()}, file_path, group_appender};
+
+					parse(state, typename State::buffer_type{buffer.data(), buffer.size()}, file_path);
+
+					token = new_token;
+					return ExtractResult::SUCCESS;
+				}
 			}
 		}// namespace
 
@@ -1254,6 +2171,228 @@ namespace gal::ini
 					buffer,
 					group_appender);
 		}
+		// char
+		[[nodiscard]] auto extract_from_file(
+				const std::string_view          file_path,
+				const group_append_type<char>   group_appender,
+				const value_validate_type<char> value_validator) -> ExtractResult
+		{
+			using char_type = char;
+			using encoding = lexy::utf8_char_encoding;
+
+			return do_extract_from_file<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					group_appender,
+					value_validator);
+		}
+
+		// char8_t
+		[[nodiscard]] auto extract_from_file(
+				const std::string_view             file_path,
+				const group_append_type<char8_t>   group_appender,
+				const value_validate_type<char8_t> value_validator) -> ExtractResult
+		{
+			using char_type = char8_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_file<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					group_appender,
+					value_validator);
+		}
+
+		// char16_t
+		[[nodiscard]] auto extract_from_file(
+				const std::string_view              file_path,
+				const group_append_type<char16_t>   group_appender,
+				const value_validate_type<char16_t> value_validator) -> ExtractResult
+		{
+			using char_type = char16_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_file<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					group_appender,
+					value_validator);
+		}
+
+		// char32_t
+		[[nodiscard]] auto extract_from_file(
+				const std::string_view              file_path,
+				const group_append_type<char32_t>   group_appender,
+				const value_validate_type<char32_t> value_validator) -> ExtractResult
+		{
+			using char_type = char32_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_file<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					group_appender,
+					value_validator);
+		}
+
+		// char
+		[[nodiscard]] auto extract_from_buffer(
+				const std::basic_string_view<char> buffer,
+				const group_append_type<char>      group_appender,
+				const value_validate_type<char>    value_validator) -> ExtractResult
+		{
+			using char_type = char;
+			using encoding = lexy::utf8_char_encoding;
+
+			return do_extract_from_buffer<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					buffer,
+					group_appender,
+					value_validator);
+		}
+
+		// char8_t
+		[[nodiscard]] auto extract_from_buffer(
+				const std::basic_string_view<char8_t> buffer,
+				const group_append_type<char8_t>      group_appender,
+				const value_validate_type<char8_t>    value_validator) -> ExtractResult
+		{
+			using char_type = char8_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_buffer<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					buffer,
+					group_appender,
+					value_validator);
+		}
+
+		// char16_t
+		[[nodiscard]] auto extract_from_buffer(
+				const std::basic_string_view<char16_t> buffer,
+				const group_append_type<char16_t>      group_appender,
+				const value_validate_type<char16_t>    value_validator) -> ExtractResult
+		{
+			using char_type = char16_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_buffer<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					buffer,
+					group_appender,
+					value_validator);
+		}
+
+		// char32_t
+		[[nodiscard]] auto extract_from_buffer(
+				const std::basic_string_view<char32_t> buffer,
+				const group_append_type<char32_t>      group_appender,
+				const value_validate_type<char32_t>    value_validator) -> ExtractResult
+		{
+			using char_type = char32_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_buffer<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					buffer,
+					group_appender,
+					value_validator);
+		}
+
+
+		// char
+		[[nodiscard]] auto extract_from_file_if_changed(
+				const std::string_view        file_path,
+				change_token&                 token,
+				const group_append_type<char> group_appender) -> ExtractResult
+		{
+			using char_type = char;
+			using encoding = lexy::utf8_char_encoding;
+
+			return do_extract_from_file_if_changed<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					token,
+					group_appender);
+		}
+
+		// char8_t
+		[[nodiscard]] auto extract_from_file_if_changed(
+				const std::string_view           file_path,
+				change_token&                    token,
+				const group_append_type<char8_t> group_appender) -> ExtractResult
+		{
+			using char_type = char8_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_file_if_changed<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					token,
+					group_appender);
+		}
+
+		// char16_t
+		[[nodiscard]] auto extract_from_file_if_changed(
+				const std::string_view            file_path,
+				change_token&                     token,
+				const group_append_type<char16_t> group_appender) -> ExtractResult
+		{
+			using char_type = char16_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_file_if_changed<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					token,
+					group_appender);
+		}
+
+		// char32_t
+		[[nodiscard]] auto extract_from_file_if_changed(
+				const std::string_view            file_path,
+				change_token&                     token,
+				const group_append_type<char32_t> group_appender) -> ExtractResult
+		{
+			using char_type = char32_t;
+			using encoding = lexy::deduce_encoding<char_type>;
+
+			return do_extract_from_file_if_changed<Extractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>>(
+					file_path,
+					token,
+					group_appender);
+		}
+
+		[[nodiscard]] auto read_change_token(const std::string_view file_path) -> change_token { return do_read_change_token(file_path); }
+
+		// char
+		[[nodiscard]] auto read_file(
+				const std::string_view   file_path,
+				std::basic_string<char>& out) -> ExtractResult
+		{
+			using encoding = lexy::utf8_char_encoding;
+
+			return do_read_file<encoding>(file_path, out);
+		}
+
+		// char8_t
+		[[nodiscard]] auto read_file(
+				const std::string_view      file_path,
+				std::basic_string<char8_t>& out) -> ExtractResult
+		{
+			using encoding = lexy::deduce_encoding<char8_t>;
+
+			return do_read_file<encoding>(file_path, out);
+		}
+
+		// char16_t
+		[[nodiscard]] auto read_file(
+				const std::string_view       file_path,
+				std::basic_string<char16_t>& out) -> ExtractResult
+		{
+			using encoding = lexy::deduce_encoding<char16_t>;
+
+			return do_read_file<encoding>(file_path, out);
+		}
+
+		// char32_t
+		[[nodiscard]] auto read_file(
+				const std::string_view       file_path,
+				std::basic_string<char32_t>& out) -> ExtractResult
+		{
+			using encoding = lexy::deduce_encoding<char32_t>;
+
+			return do_read_file<encoding>(file_path, out);
+		}
 	}// namespace extractor_detail
 
 	namespace flusher_detail
@@ -1263,15 +2402,16 @@ namespace gal::ini
 			template<typename State>
 			[[nodiscard]] auto do_flush(
 					std::string_view                  file_path,
-					typename State::group_handle_type group_handler) -> FlushResult
+					typename State::group_handle_type group_handler,
+					const FlushDurability             durability) -> FlushResult
 			{
 				if (std::error_code error_code = {};
 					!std::filesystem::exists(file_path, error_code))
 				{
 					// The file doesn't exist, it doesn't matter, just write the file.
 					// return FlushResult::FILE_NOT_FOUND;
-					State state{file_path, group_handler};
-					return FlushResult::SUCCESS;
+					State state{file_path, group_handler, durability, 0};
+					return state.finish();
 				}
 
 				if (auto file = lexy::read_file<typename State::encoding>(file_path.data());
@@ -1292,11 +2432,11 @@ namespace gal::ini
 				}
 				else
 				{
-					State state{file_path, group_handler};
+					State state{file_path, group_handler, durability, file.buffer().size()};
 
 					parse(state, {file.buffer().data(), file.buffer().size()}, file_path);
 
-					return FlushResult::SUCCESS;
+					return state.finish();
 				}
 			}
 		}// namespace
@@ -1304,7 +2444,8 @@ namespace gal::ini
 		// char
 		[[nodiscard]] auto flush_to_file(
 				const std::string_view           file_path,
-				const group_ostream_handle<char> group_handler) -> FlushResult
+				const group_ostream_handle<char> group_handler,
+				const FlushDurability            durability) -> FlushResult
 		{
 			using char_type = char;
 			// todo: encoding?
@@ -1312,7 +2453,48 @@ namespace gal::ini
 
 			return do_flush<Flusher<encoding, group_ostream_handle<char_type>, kv_ostream_handle<char_type>, false>>(
 					file_path,
-					group_handler);
+					group_handler,
+					durability);
+		}
+
+		auto sync_directory(const std::string_view file_path) -> bool
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			// NTFS journals the metadata
+			(void)file_path;
+			return true;
+			#else
+			const std::filesystem::path path{file_path};
+			const auto                  directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path{"."};
+
+			const auto file = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (file == -1) { return false; }
+
+			const auto result = ::fsync(file);
+			::close(file);
+			return result == 0;
+			#endif
+		}
+
+		auto replace_file(const std::string_view file_path, const std::string_view data, const FlushDurability durability) -> FlushResult
+		{
+			const std::filesystem::path target_path{file_path};
+
+			const auto temp_path = make_temp_path(target_path);
+			if (const auto result = write_file(temp_path, data, durability, false, true);
+				result != FlushResult::SUCCESS) { return result; }
+
+			std::error_code error_code{};
+			std::filesystem::rename(temp_path, target_path, error_code);
+			if (error_code)
+			{
+				std::filesystem::remove(temp_path, error_code);
+				return FlushResult::INTERNAL_ERROR;
+			}
+
+			if (durability == FlushDurability::FULL && !sync_directory(file_path)) { return FlushResult::INTERNAL_ERROR; }
+
+			return FlushResult::SUCCESS;
 		}
 
 		// char
@@ -1326,7 +2508,9 @@ namespace gal::ini
 
 			return do_flush<Flusher<encoding, group_user_handle<char_type>, kv_user_handle<char_type>, true>>(
 					file_path,
-					group_handler);
+					group_handler,
+					// nothing is written to the file
+					FlushDurability::NONE);
 		}
 
 		// char8_t
@@ -1339,7 +2523,9 @@ namespace gal::ini
 
 			return do_flush<Flusher<encoding, group_user_handle<char_type>, kv_user_handle<char_type>, true>>(
 					file_path,
-					group_handler);
+					group_handler,
+					// nothing is written to the file
+					FlushDurability::NONE);
 		}
 
 		// char16_t
@@ -1352,7 +2538,9 @@ namespace gal::ini
 
 			return do_flush<Flusher<encoding, group_user_handle<char_type>, kv_user_handle<char_type>, true>>(
 					file_path,
-					group_handler);
+					group_handler,
+					// nothing is written to the file
+					FlushDurability::NONE);
 		}
 
 		// char32_t
@@ -1365,7 +2553,119 @@ namespace gal::ini
 
 			return do_flush<Flusher<encoding, group_user_handle<char_type>, kv_user_handle<char_type>, true>>(
 					file_path,
-					group_handler);
+					group_handler,
+					// nothing is written to the file
+					FlushDurability::NONE);
+		}
+
+		// char
+		[[nodiscard]] auto flush_to_buffer(
+				const std::string_view           source,
+				const group_ostream_handle<char> group_handler,
+				std::string&                     out) -> FlushResult
+		{
+			using char_type = char;
+			using encoding = lexy::utf8_char_encoding;
+
+			using state_type = Flusher<encoding, group_ostream_handle<char_type>, kv_ostream_handle<char_type>, false>;
+
+			state_type state{out, group_handler, source.size()};
+
+			if (!source.empty()) { parse(state, typename state_type::buffer_type{source.data(), source.size()}, state_type::error_reporter_type::buffer_file_path); }
+
+			return state.finish();
 		}
 	}// namespace flusher_detail
+
+	namespace patch_detail
+	{
+		auto scan(const std::string_view source, skeleton_type& out) -> void
+		{
+			Skeleton state{source, out};
+
+			parse(state, {source.data(), source.size()}, Skeleton::error_reporter_type::buffer_file_path);
+		}
+	}// namespace patch_detail
+
+	namespace session_detail
+	{
+		namespace
+		{
+			// Call the state just like the parser did when the skeleton was recorded.
+			template<typename State>
+			auto replay(State& state, const std::string_view source, const skeleton_type& skeleton) -> void
+			{
+				using lexeme_type = typename State::lexeme_type;
+
+				const auto lexeme_of = [source](const source_range range) -> lexeme_type { return {source.data() + range.begin, source.data() + range.end()}; };
+
+				for (const auto& line: skeleton)
+				{
+					switch (line.kind)
+					{
+						case SkeletonLine::BLANK:
+						{
+							state.blank_line();
+							break;
+						}
+						case SkeletonLine::COMMENT:
+						{
+							state.comment(line.indication, lexeme_of(line.name));
+							break;
+						}
+						case SkeletonLine::GROUP:
+						{
+							state.group(source.data() + line.name.begin, lexeme_of(line.name), {line.indication, lexeme_of(line.inline_comment)});
+							break;
+						}
+						case SkeletonLine::VARIABLE:
+						{
+							state.value(source.data() + line.name.begin, lexeme_of(line.name), lexeme_of(line.value), {line.indication, lexeme_of(line.inline_comment)});
+							break;
+						}
+					}
+				}
+			}
+		}// namespace
+
+		auto extract(
+				const std::string_view        file_path,
+				const std::string_view        source,
+				const group_append_type<char> group_appender,
+				skeleton_type&                skeleton) -> ExtractResult
+		{
+			using char_type = char;
+			using encoding = lexy::utf8_char_encoding;
+
+			using state_type = SkeletonExtractor<encoding, group_append_type<char_type>, kv_append_type<char_type>>;
+
+			const typename state_type::buffer_type buffer{source.data(), source.size()};
+			state_type                             state{buffer, file_path, group_appender, source, skeleton};
+
+			parse(state, buffer, file_path);
+
+			return state.value_rejected() ? ExtractResult::INVALID_DATA : ExtractResult::SUCCESS;
+		}
+
+		auto flush(
+				const std::string_view           file_path,
+				const std::string_view           source,
+				const skeleton_type&             skeleton,
+				const group_ostream_handle<char> group_handler,
+				const FlushDurability            durability,
+				std::string&                     written,
+				skeleton_type&                   written_skeleton) -> std::pair<FlushResult, bool>
+		{
+			using char_type = char;
+			using encoding = lexy::utf8_char_encoding;
+
+			using state_type = SkeletonFlusher<encoding, group_ostream_handle<char_type>, kv_ostream_handle<char_type>>;
+
+			state_type state{file_path, group_handler, durability, written, source.size(), written_skeleton};
+
+			replay(state, source, skeleton);
+
+			return state.finish();
+		}
+	}// namespace session_detail
 }    // namespace gal::ini
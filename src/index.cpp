@@ -0,0 +1,384 @@
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <ini/flusher.hpp>
+#include <ini/index.hpp>
+#include <ini/internal/group_scanner.hpp>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(GAL_INI_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	namespace ini = gal::ini;
+	namespace detail = ini::index_detail;
+
+	// ========================================
+	// MAPPED FILE
+	// ========================================
+
+	[[nodiscard]] auto map_file(const std::string_view file_path, detail::mapped_file& out) -> ini::IndexResult
+	{
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		const std::filesystem::path path{file_path};
+
+		const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			switch (GetLastError())
+			{
+				case ERROR_FILE_NOT_FOUND:
+				case ERROR_PATH_NOT_FOUND: { return ini::IndexResult::FILE_NOT_FOUND; }
+				case ERROR_ACCESS_DENIED: { return ini::IndexResult::PERMISSION_DENIED; }
+				default: { return ini::IndexResult::INTERNAL_ERROR; }
+			}
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return ini::IndexResult::INTERNAL_ERROR;
+		}
+
+		out.file_handle = file;
+		out.size        = static_cast<std::size_t>(size.QuadPart);
+		// a file of size 0 cannot be mapped
+		if (out.size == 0) { return ini::IndexResult::SUCCESS; }
+
+		const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) { return ini::IndexResult::INTERNAL_ERROR; }
+		out.mapping_handle = mapping;
+
+		const auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data == nullptr) { return ini::IndexResult::INTERNAL_ERROR; }
+		out.data = static_cast<const char*>(data);
+
+		return ini::IndexResult::SUCCESS;
+		#else
+		const std::string path{file_path};
+
+		const auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file == -1)
+		{
+			switch (errno)
+			{
+				case ENOENT:
+				case ENOTDIR: { return ini::IndexResult::FILE_NOT_FOUND; }
+				case EACCES:
+				case EPERM: { return ini::IndexResult::PERMISSION_DENIED; }
+				default: { return ini::IndexResult::INTERNAL_ERROR; }
+			}
+		}
+
+		struct stat file_stat{};
+		if (::fstat(file, &file_stat) != 0)
+		{
+			::close(file);
+			return ini::IndexResult::INTERNAL_ERROR;
+		}
+
+		out.size = static_cast<std::size_t>(file_stat.st_size);
+		// a file of size 0 cannot be mapped
+		if (out.size == 0)
+		{
+			::close(file);
+			return ini::IndexResult::SUCCESS;
+		}
+
+		// the mapping stays valid after the file is closed
+		auto* data = ::mmap(nullptr, out.size, PROT_READ, MAP_SHARED, file, 0);
+		::close(file);
+		if (data == MAP_FAILED)
+		{
+			out.size = 0;
+			return ini::IndexResult::INTERNAL_ERROR;
+		}
+		out.data = static_cast<const char*>(data);
+
+		return ini::IndexResult::SUCCESS;
+		#endif
+	}
+
+	auto unmap_file(detail::mapped_file& file) noexcept -> void
+	{
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		if (file.data != nullptr) { UnmapViewOfFile(file.data); }
+		if (file.mapping_handle != nullptr) { CloseHandle(file.mapping_handle); }
+		if (file.file_handle != nullptr) { CloseHandle(file.file_handle); }
+		#else
+		if (file.data != nullptr) { ::munmap(const_cast<char*>(file.data), file.size); }
+		#endif
+
+		file = {};
+	}
+
+	// RAII for a mapped file that is not (yet) owned by an IndexedFile
+	class ScopedMappedFile
+	{
+	public:
+		detail::mapped_file file;
+
+		ScopedMappedFile() noexcept = default;
+
+		ScopedMappedFile(const ScopedMappedFile&)                    = delete;
+		ScopedMappedFile(ScopedMappedFile&&)                         = delete;
+		auto operator=(const ScopedMappedFile&) -> ScopedMappedFile& = delete;
+		auto operator=(ScopedMappedFile&&) -> ScopedMappedFile&      = delete;
+
+		~ScopedMappedFile() noexcept { unmap_file(file); }
+
+		[[nodiscard]] auto release() noexcept -> detail::mapped_file { return std::exchange(file, {}); }
+	};
+
+	// The source is encoded in UTF-8, the BOM (if any) is not part of the source.
+	[[nodiscard]] auto source_of(const detail::mapped_file& file) noexcept -> std::string_view
+	{
+		const std::string_view source{file.data, file.size};
+		if (source.starts_with("\xEF\xBB\xBF")) { return source.substr(3); }
+		return source;
+	}
+
+	[[nodiscard]] auto hash_name(const std::string_view name) noexcept -> std::uint64_t { return ini::common::hash_bytes(name.data(), name.size()); }
+
+	// ========================================
+	// INDEX
+	// ========================================
+
+	[[nodiscard]] auto write_index(
+			const std::string_view       source,
+			const ini::change_token&     source_token,
+			const std::filesystem::path& index_path) -> ini::IndexResult
+	{
+		// group name => entry
+		std::unordered_map<std::string_view, std::size_t> entry_of_name{};
+		std::vector<std::vector<detail::index_range>>     ranges_of_entry{};
+		std::vector<std::string_view>                     names{};
+
+		ini::common::scan_groups<char>(
+				source,
+				[&](const std::string_view name, const std::size_t begin, const std::size_t end) -> void
+				{
+					const auto [it, inserted] = entry_of_name.emplace(name, names.size());
+					if (inserted)
+					{
+						names.push_back(name);
+						ranges_of_entry.emplace_back();
+					}
+					ranges_of_entry[it->second].push_back({.begin = begin, .end = end});
+				});
+
+		// load factor <= 0.5
+		const auto bucket_count = std::bit_ceil(std::max<std::size_t>(names.size() * 2, 2));
+		if (bucket_count > std::numeric_limits<std::uint32_t>::max()) { return ini::IndexResult::INTERNAL_ERROR; }
+
+		std::vector<std::uint32_t>       buckets(bucket_count, 0);
+		std::vector<detail::index_entry> entries{};
+		std::vector<detail::index_range> ranges{};
+		entries.reserve(names.size());
+
+		for (std::size_t i = 0; i < names.size(); ++i)
+		{
+			const auto name = names[i];
+			const auto hash = hash_name(name);
+
+			entries.push_back({
+					.name_hash = hash,
+					.name_offset = static_cast<std::uint64_t>(name.data() - source.data()),
+					.name_size = name.size(),
+					.first_range = ranges.size(),
+					.range_count = ranges_of_entry[i].size()});
+			ranges.insert(ranges.end(), ranges_of_entry[i].begin(), ranges_of_entry[i].end());
+
+			auto bucket = static_cast<std::size_t>(hash) & (bucket_count - 1);
+			while (buckets[bucket] != 0) { bucket = (bucket + 1) & (bucket_count - 1); }
+			buckets[bucket] = static_cast<std::uint32_t>(i + 1);
+		}
+
+		const detail::index_header header{
+				.magic = detail::index_magic,
+				.version = detail::index_version,
+				.bucket_count = static_cast<std::uint32_t>(bucket_count),
+				.source_token = source_token,
+				.entry_count = entries.size(),
+				.range_count = ranges.size()};
+
+		std::string data{};
+		data.reserve(sizeof(header) + buckets.size() * sizeof(std::uint32_t) + entries.size() * sizeof(detail::index_entry) + ranges.size() * sizeof(detail::index_range));
+		data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+		data.append(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(std::uint32_t));
+		data.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(detail::index_entry));
+		data.append(reinterpret_cast<const char*>(ranges.data()), ranges.size() * sizeof(detail::index_range));
+
+		// Readers may have the old index mapped, never write it in place.
+		// The data is synced before the rename, a crash never leaves a renamed but empty (or partial) index.
+		if (const auto result = ini::flusher_detail::replace_file(index_path.string(), data, ini::FlushDurability::DATA);
+			result != ini::FlushResult::SUCCESS) { return result == ini::FlushResult::PERMISSION_DENIED ? ini::IndexResult::PERMISSION_DENIED : ini::IndexResult::INTERNAL_ERROR; }
+
+		return ini::IndexResult::SUCCESS;
+	}
+}// namespace
+
+namespace gal::ini
+{
+	auto build_index(const std::string_view source_path, const std::string_view index_path) -> IndexResult
+	{
+		// Read the metadata first, if the source is modified while it is indexed the metadata will not match.
+		auto token = extractor_detail::read_change_token(source_path);
+
+		ScopedMappedFile source_file{};
+		if (const auto result = map_file(source_path, source_file.file);
+			result != IndexResult::SUCCESS) { return result; }
+
+		token.size = source_file.file.size;
+		token.hash = common::hash_bytes(source_file.file.data, source_file.file.size);
+
+		return write_index(source_of(source_file.file), token, std::filesystem::path{index_path});
+	}
+
+	IndexedFile::IndexedFile(IndexedFile&& other) noexcept
+		: source_{std::exchange(other.source_, {})},
+		index_{std::exchange(other.index_, {})},
+		source_offset_{std::exchange(other.source_offset_, 0)},
+		header_{std::exchange(other.header_, nullptr)},
+		buckets_{std::exchange(other.buckets_, nullptr)},
+		entries_{std::exchange(other.entries_, nullptr)},
+		ranges_{std::exchange(other.ranges_, nullptr)} {}
+
+	auto IndexedFile::operator=(IndexedFile&& other) noexcept -> IndexedFile&
+	{
+		if (this != &other)
+		{
+			unmap_file(source_);
+			unmap_file(index_);
+
+			source_        = std::exchange(other.source_, {});
+			index_         = std::exchange(other.index_, {});
+			source_offset_ = std::exchange(other.source_offset_, 0);
+			header_        = std::exchange(other.header_, nullptr);
+			buckets_       = std::exchange(other.buckets_, nullptr);
+			entries_       = std::exchange(other.entries_, nullptr);
+			ranges_        = std::exchange(other.ranges_, nullptr);
+		}
+		return *this;
+	}
+
+	IndexedFile::~IndexedFile() noexcept
+	{
+		unmap_file(source_);
+		unmap_file(index_);
+	}
+
+	auto IndexedFile::find(const string_view_type group_name) const noexcept -> const index_detail::index_entry*
+	{
+		if (header_ == nullptr) { return nullptr; }
+
+		const auto hash = hash_name(group_name);
+		const auto mask = static_cast<std::size_t>(header_->bucket_count) - 1;
+
+		// The load factor of a valid index is <= 0.5 (there is always an empty bucket), but a damaged one must not make us loop forever.
+		auto bucket = static_cast<std::size_t>(hash) & mask;
+		for (std::uint32_t probe = 0; probe < header_->bucket_count; ++probe, bucket = (bucket + 1) & mask)
+		{
+			const auto entry_index = buckets_[bucket];
+			if (entry_index == 0) { return nullptr; }
+			if (entry_index > header_->entry_count) { return nullptr; }
+
+			const auto& entry = entries_[entry_index - 1];
+			if (entry.name_hash != hash) { continue; }
+
+			// The index is only checked when the entry is used, so that opening it does not depend on the number of groups.
+			const auto source = this->source();
+			if (entry.name_offset > source.size() ||
+			    entry.name_size > source.size() - entry.name_offset ||
+			    entry.first_range > header_->range_count ||
+			    entry.range_count > header_->range_count - entry.first_range) { return nullptr; }
+			if (!std::ranges::all_of(
+					ranges_ + entry.first_range,
+					ranges_ + entry.first_range + entry.range_count,
+					[size = source.size()](const index_detail::index_range& range) noexcept -> bool { return range.begin <= range.end && range.end <= size; })) { return nullptr; }
+
+			if (source.substr(static_cast<std::size_t>(entry.name_offset), static_cast<std::size_t>(entry.name_size)) == group_name) { return &entry; }
+		}
+
+		return nullptr;
+	}
+
+	auto IndexedFile::open(
+			const std::string_view source_path,
+			const std::string_view index_path,
+			const IndexValidation  validation) -> std::pair<IndexResult, IndexedFile>
+	{
+		const auto token = extractor_detail::read_change_token(source_path);
+
+		ScopedMappedFile index_file{};
+		if (const auto result = map_file(index_path, index_file.file);
+			result != IndexResult::SUCCESS) { return {result, IndexedFile{}}; }
+
+		// check the layout
+		const auto  index_size = index_file.file.size;
+		const auto* header     = reinterpret_cast<const index_detail::index_header*>(index_file.file.data);
+		if (index_size < sizeof(index_detail::index_header) ||
+		    header->magic != index_detail::index_magic ||
+		    header->version != index_detail::index_version ||
+		    !std::has_single_bit(header->bucket_count) ||
+		    header->entry_count >= header->bucket_count) { return {IndexResult::INVALID_INDEX, IndexedFile{}}; }
+
+		// The counts come from the file, check each of them against the bytes left before multiplying (it may wrap otherwise).
+		auto remaining = index_size - sizeof(index_detail::index_header);
+		auto take      = [&remaining](const std::uint64_t count, const std::size_t element_size) -> bool
+		{
+			if (count > remaining / element_size) { return false; }
+			remaining -= static_cast<std::size_t>(count) * element_size;
+			return true;
+		};
+		if (!take(header->bucket_count, sizeof(std::uint32_t)) ||
+		    !take(header->entry_count, sizeof(index_detail::index_entry)) ||
+		    !take(header->range_count, sizeof(index_detail::index_range)) ||
+		    remaining != 0) { return {IndexResult::INVALID_INDEX, IndexedFile{}}; }
+
+		// check the source
+		ScopedMappedFile source_file{};
+		if (const auto result = map_file(source_path, source_file.file);
+			result != IndexResult::SUCCESS) { return {result, IndexedFile{}}; }
+
+		const auto& expected = header->source_token;
+		if (source_file.file.size != expected.size) { return {IndexResult::OUTDATED_INDEX, IndexedFile{}}; }
+
+		// mtime_ns == 0 => the metadata cannot be trusted
+		if (validation == IndexValidation::CONTENT ||
+		    expected.mtime_ns == 0 ||
+		    token.inode != expected.inode ||
+		    token.mtime_ns != expected.mtime_ns)
+		{
+			if (common::hash_bytes(source_file.file.data, source_file.file.size) != expected.hash) { return {IndexResult::OUTDATED_INDEX, IndexedFile{}}; }
+		}
+
+		IndexedFile file{};
+		file.source_        = source_file.release();
+		file.index_         = index_file.release();
+		file.source_offset_ = file.source_.size - source_of(file.source_).size();
+
+		const auto* base = file.index_.data + sizeof(index_detail::index_header);
+		file.header_     = header;
+		file.buckets_    = reinterpret_cast<const std::uint32_t*>(base);
+		file.entries_    = reinterpret_cast<const index_detail::index_entry*>(base + header->bucket_count * sizeof(std::uint32_t));
+		file.ranges_     = reinterpret_cast<const index_detail::index_range*>(base + header->bucket_count * sizeof(std::uint32_t) + header->entry_count * sizeof(index_detail::index_entry));
+
+		return {IndexResult::SUCCESS, std::move(file)};
+	}
+}// namespace gal::ini
@@ -0,0 +1,406 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <ini/patch.hpp>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(GAL_INI_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	namespace ini = gal::ini;
+
+	// ========================================
+	// FILE
+	// ========================================
+
+	// A file opened for reading and writing at arbitrary offsets.
+	class PatchFile
+	{
+		#if defined(GAL_INI_PLATFORM_WINDOWS)
+		HANDLE handle_;
+		#else
+		int file_;
+		#endif
+
+	public:
+		PatchFile() noexcept
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			: handle_{INVALID_HANDLE_VALUE} {}
+		#else
+			: file_{-1} {}
+		#endif
+
+		PatchFile(const PatchFile&)                    = delete;
+		PatchFile(PatchFile&&)                         = delete;
+		auto operator=(const PatchFile&) -> PatchFile& = delete;
+		auto operator=(PatchFile&&) -> PatchFile&      = delete;
+
+		~PatchFile() noexcept
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			if (handle_ != INVALID_HANDLE_VALUE) { CloseHandle(handle_); }
+			#else
+			if (file_ != -1) { ::close(file_); }
+			#endif
+		}
+
+		[[nodiscard]] auto open(const std::filesystem::path& path, const bool create) -> ini::FlushResult
+		{
+			if (std::error_code error_code = {};
+				create && path.has_parent_path() && !exists(path.parent_path(), error_code))
+			{
+				// create directory if not exist
+				create_directories(path.parent_path(), error_code);
+			}
+
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			handle_ = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, create ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (handle_ == INVALID_HANDLE_VALUE)
+			{
+				switch (GetLastError())
+				{
+					case ERROR_ACCESS_DENIED:
+					case ERROR_SHARING_VIOLATION: { return ini::FlushResult::PERMISSION_DENIED; }
+					default: { return ini::FlushResult::INTERNAL_ERROR; }
+				}
+			}
+			#else
+			file_ = ::open(path.c_str(), O_RDWR | O_CLOEXEC | (create ? O_CREAT : 0), 0666);
+			if (file_ == -1)
+			{
+				switch (errno)
+				{
+					case EACCES:
+					case EPERM:
+					case EROFS: { return ini::FlushResult::PERMISSION_DENIED; }
+					default: { return ini::FlushResult::INTERNAL_ERROR; }
+				}
+			}
+			#endif
+
+			return ini::FlushResult::SUCCESS;
+		}
+
+		[[nodiscard]] auto read_all(std::string& out) const -> bool
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(handle_, &size)) { return false; }
+			out.resize(static_cast<std::size_t>(size.QuadPart));
+
+			for (std::size_t done = 0; done < out.size();)
+			{
+				OVERLAPPED overlapped{};
+				overlapped.Offset     = static_cast<DWORD>(done);
+				overlapped.OffsetHigh = static_cast<DWORD>(static_cast<std::uint64_t>(done) >> 32);
+
+				DWORD read = 0;
+				if (!ReadFile(handle_, out.data() + done, static_cast<DWORD>(std::min<std::size_t>(out.size() - done, std::numeric_limits<DWORD>::max())), &read, &overlapped) || read == 0) { return false; }
+				done += read;
+			}
+			#else
+			struct stat file_stat{};
+			if (::fstat(file_, &file_stat) != 0) { return false; }
+			out.resize(static_cast<std::size_t>(file_stat.st_size));
+
+			for (std::size_t done = 0; done < out.size();)
+			{
+				const auto read = ::pread(file_, out.data() + done, out.size() - done, static_cast<off_t>(done));
+				if (read == -1 && errno == EINTR) { continue; }
+				if (read <= 0) { return false; }
+				done += static_cast<std::size_t>(read);
+			}
+			#endif
+
+			return true;
+		}
+
+		[[nodiscard]] auto write_at(const std::uint64_t offset, const std::string_view data) const -> bool
+		{
+			for (std::size_t done = 0; done < data.size();)
+			{
+				#if defined(GAL_INI_PLATFORM_WINDOWS)
+				OVERLAPPED overlapped{};
+				overlapped.Offset     = static_cast<DWORD>(offset + done);
+				overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+
+				DWORD written = 0;
+				if (!WriteFile(handle_, data.data() + done, static_cast<DWORD>(std::min<std::size_t>(data.size() - done, std::numeric_limits<DWORD>::max())), &written, &overlapped)) { return false; }
+				done += written;
+				#else
+				const auto written = ::pwrite(file_, data.data() + done, data.size() - done, static_cast<off_t>(offset + done));
+				if (written == -1 && errno == EINTR) { continue; }
+				if (written <= 0) { return false; }
+				done += static_cast<std::size_t>(written);
+				#endif
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] auto truncate(const std::uint64_t size) const -> bool
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			LARGE_INTEGER position;
+			position.QuadPart = static_cast<LONGLONG>(size);
+			return SetFilePointerEx(handle_, position, nullptr, FILE_BEGIN) && SetEndOfFile(handle_);
+			#else
+			return ::ftruncate(file_, static_cast<off_t>(size)) == 0;
+			#endif
+		}
+
+		// The data and the size of the file reach the disk.
+		[[nodiscard]] auto sync() const -> bool
+		{
+			#if defined(GAL_INI_PLATFORM_WINDOWS)
+			return FlushFileBuffers(handle_) != 0;
+			#else
+			return ::fsync(file_) == 0;
+			#endif
+		}
+	};
+
+	// ========================================
+	// JOURNAL
+	// ========================================
+
+	// The journal is laid out as follows (native byte order):
+	// [journal_header]
+	// [journal_record + original bytes] * record_count
+	// The journal is complete only if the hash matches, an incomplete journal means that the file has not been touched yet.
+
+	constexpr std::uint64_t journal_magic = 0x4c4e'524a'494e'4947;// "GINIJRNL"
+
+	struct journal_header
+	{
+		std::uint64_t magic;
+		// the size of the file before the patch
+		std::uint64_t file_size;
+		std::uint64_t record_count;
+		// hash of everything after the header
+		std::uint64_t hash;
+	};
+
+	struct journal_record
+	{
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	// The bytes of the file that will be overwritten.
+	struct undo_record
+	{
+		std::uint64_t    offset;
+		std::string_view bytes;
+	};
+
+	[[nodiscard]] auto journal_path_of(const std::string_view file_path) -> std::filesystem::path
+	{
+		std::filesystem::path path{file_path};
+		path += ".journal";
+		return path;
+	}
+
+	[[nodiscard]] auto write_journal(const std::filesystem::path& journal_path, const std::uint64_t file_size, const std::vector<undo_record>& records) -> ini::FlushResult
+	{
+		std::string payload{};
+		for (const auto& [offset, bytes]: records)
+		{
+			const journal_record record{.offset = offset, .size = bytes.size()};
+			payload.append(reinterpret_cast<const char*>(&record), sizeof(record));
+			payload.append(bytes);
+		}
+
+		const journal_header header{
+				.magic = journal_magic,
+				.file_size = file_size,
+				.record_count = records.size(),
+				.hash = ini::common::hash_bytes(payload.data(), payload.size())};
+
+		PatchFile journal{};
+		if (const auto result = journal.open(journal_path, true);
+			result != ini::FlushResult::SUCCESS) { return result; }
+
+		if (!journal.truncate(0) ||
+		    !journal.write_at(0, {reinterpret_cast<const char*>(&header), sizeof(header)}) ||
+		    !journal.write_at(sizeof(header), payload) ||
+		    !journal.sync() ||
+		    !ini::flusher_detail::sync_directory(journal_path.string())) { return ini::FlushResult::INTERNAL_ERROR; }
+
+		return ini::FlushResult::SUCCESS;
+	}
+}// namespace
+
+namespace gal::ini
+{
+	auto recover_patch(const std::string_view file_path) -> FlushResult
+	{
+		const auto journal_path = journal_path_of(file_path);
+
+		if (std::error_code error_code = {};
+			!exists(journal_path, error_code)) { return FlushResult::SUCCESS; }
+
+		std::string content{};
+		{
+			PatchFile journal{};
+			if (const auto result = journal.open(journal_path, false);
+				result != FlushResult::SUCCESS) { return result; }
+			if (!journal.read_all(content)) { return FlushResult::INTERNAL_ERROR; }
+		}
+
+		// check the layout
+		journal_header header{};
+		bool           complete = content.size() >= sizeof(journal_header);
+		if (complete)
+		{
+			std::memcpy(&header, content.data(), sizeof(header));
+			complete = header.magic == journal_magic &&
+			           common::hash_bytes(content.data() + sizeof(header), content.size() - sizeof(header)) == header.hash;
+		}
+
+		std::vector<undo_record> records{};
+		for (std::size_t offset = sizeof(header); complete && records.size() < header.record_count;)
+		{
+			journal_record record{};
+			if (content.size() - offset < sizeof(record))
+			{
+				complete = false;
+				break;
+			}
+			std::memcpy(&record, content.data() + offset, sizeof(record));
+			offset += sizeof(record);
+
+			if (content.size() - offset < record.size)
+			{
+				complete = false;
+				break;
+			}
+			records.push_back({.offset = record.offset, .bytes = std::string_view{content}.substr(offset, static_cast<std::size_t>(record.size))});
+			offset += static_cast<std::size_t>(record.size);
+		}
+
+		if (complete)
+		{
+			PatchFile file{};
+			if (const auto result = file.open(std::filesystem::path{file_path}, true);
+				result != FlushResult::SUCCESS) { return result; }
+
+			for (const auto& [offset, bytes]: records)
+			{
+				if (!file.write_at(offset, bytes)) { return FlushResult::INTERNAL_ERROR; }
+			}
+			if (!file.truncate(header.file_size) || !file.sync()) { return FlushResult::INTERNAL_ERROR; }
+		}
+
+		// an incomplete journal => the file has not been touched
+		// The removal reaches the disk too, or the journal may come back after a crash and roll back a later patch.
+		std::error_code error_code{};
+		std::filesystem::remove(journal_path, error_code);
+		if (error_code || !flusher_detail::sync_directory(journal_path.string())) { return FlushResult::INTERNAL_ERROR; }
+		return FlushResult::SUCCESS;
+	}
+
+	namespace patch_detail
+	{
+		auto patch_file(const std::string_view file_path, make_patch_type make_patch) -> FlushResult
+		{
+			if (const auto result = recover_patch(file_path);
+				result != FlushResult::SUCCESS) { return result; }
+
+			PatchFile file{};
+			if (const auto result = file.open(std::filesystem::path{file_path}, true);
+				result != FlushResult::SUCCESS) { return result; }
+
+			std::string content{};
+			if (!file.read_all(content)) { return FlushResult::INTERNAL_ERROR; }
+
+			// The BOM (if any) is not part of the source, it is kept as-is.
+			const std::size_t      bom    = std::string_view{content}.starts_with("\xEF\xBB\xBF") ? 3 : 0;
+			const std::string_view source = std::string_view{content}.substr(bom);
+
+			skeleton_type skeleton{};
+			scan(source, skeleton);
+
+			patch_type edits{};
+			make_patch(source, skeleton, edits);
+
+			if (edits.empty()) { return FlushResult::SUCCESS; }
+
+			std::vector<undo_record>                                 undo{};
+			std::vector<std::pair<std::uint64_t, std::string_view>> writes{};
+			std::uint64_t                                            new_size = content.size();
+
+			// the rewritten tail of the file (if the size changes)
+			std::string tail{};
+
+			if (std::ranges::all_of(edits, [](const patch_edit& edit) noexcept -> bool { return edit.end - edit.begin == edit.replacement.size(); }))
+			{
+				// write in place
+				for (const auto& [begin, end, replacement]: edits)
+				{
+					undo.push_back({.offset = bom + begin, .bytes = source.substr(begin, end - begin)});
+					writes.emplace_back(bom + begin, replacement);
+				}
+			}
+			else
+			{
+				// rewrite from the first edit
+				const auto first = edits.front().begin;
+
+				auto current = first;
+				for (const auto& [begin, end, replacement]: edits)
+				{
+					tail.append(source.substr(current, begin - current));
+					tail.append(replacement);
+					current = end;
+				}
+				tail.append(source.substr(current));
+
+				undo.push_back({.offset = bom + first, .bytes = source.substr(first)});
+				writes.emplace_back(bom + first, tail);
+				new_size = bom + first + tail.size();
+			}
+
+			// The original bytes are on the disk before the file is touched.
+			const auto journal_path = journal_path_of(file_path);
+			if (const auto result = write_journal(journal_path, content.size(), undo);
+				result != FlushResult::SUCCESS) { return result; }
+
+			const auto applied = [&]() -> bool
+			{
+				for (const auto& [offset, data]: writes)
+				{
+					if (!file.write_at(offset, data)) { return false; }
+				}
+				if (new_size < content.size() && !file.truncate(new_size)) { return false; }
+				return file.sync();
+			}();
+
+			if (!applied)
+			{
+				// roll back now, or the next time if it fails again
+				(void)recover_patch(file_path);
+				return FlushResult::INTERNAL_ERROR;
+			}
+
+			// A complete journal that comes back after a crash would roll back the patch (see recover_patch).
+			std::error_code error_code{};
+			std::filesystem::remove(journal_path, error_code);
+			if (error_code || !flusher_detail::sync_directory(journal_path.string())) { return FlushResult::INTERNAL_ERROR; }
+			return FlushResult::SUCCESS;
+		}
+	}// namespace patch_detail
+}// namespace gal::ini
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <condition_variable>
+#include <ini/watcher.hpp>
+#include <limits>
+#include <map>
+#include <ranges>
+#include <set>
+#include <thread>
+#include <vector>
+
+#if defined(GAL_INI_PLATFORM_LINUX)
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	namespace ini = gal::ini;
+	namespace fs = std::filesystem;
+
+	using clock_type = std::chrono::steady_clock;
+
+	// A directory to watch, only the files in names are reported unless all is set.
+	struct watched_directory
+	{
+		fs::path           directory;
+		std::set<fs::path> names;
+		bool               all;
+
+		[[nodiscard]] auto contains(const fs::path& name) const -> bool { return all || names.contains(name); }
+	};
+
+	// file => deadline
+	using pending_type = std::map<fs::path, clock_type::time_point>;
+
+	[[nodiscard]] auto split_path(const std::string_view path, fs::path& directory, fs::path& name) -> bool
+	{
+		const fs::path target{path};
+
+		std::error_code error_code{};
+		if (fs::is_directory(target, error_code))
+		{
+			directory = target;
+			name.clear();
+			return true;
+		}
+
+		directory = target.has_parent_path() ? target.parent_path() : fs::current_path(error_code);
+		name      = target.filename();
+		return !name.empty() && fs::is_directory(directory, error_code);
+	}
+
+	// Call the callback for each file whose deadline has passed, returns the time until the next deadline.
+	[[nodiscard]] auto fire(pending_type& pending, const ini::FileWatcher::callback_type& callback) -> std::chrono::milliseconds
+	{
+		const auto now = clock_type::now();
+
+		std::vector<fs::path> ready{};
+		for (auto it = pending.begin(); it != pending.end();)
+		{
+			if (it->second <= now)
+			{
+				ready.push_back(it->first);
+				it = pending.erase(it);
+			}
+			else { ++it; }
+		}
+
+		for (const auto& file: ready) { callback(file); }
+
+		if (pending.empty()) { return std::chrono::milliseconds::max(); }
+
+		const auto next = std::ranges::min(pending | std::views::values);
+		return std::chrono::ceil<std::chrono::milliseconds>(std::max(next - clock_type::now(), clock_type::duration::zero()));
+	}
+}// namespace
+
+namespace gal::ini
+{
+	#if defined(GAL_INI_PLATFORM_LINUX)
+	// ========================================
+	// INOTIFY
+	// ========================================
+
+	struct FileWatcher::implementation
+	{
+		// IN_CLOSE_WRITE => written in place
+		// IN_MOVED_TO => replaced by rename (write to a temporary file and rename it)
+		constexpr static std::uint32_t watch_mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MASK_ADD | IN_ONLYDIR;
+
+		callback_type             callback;
+		std::chrono::milliseconds debounce;
+
+		int inotify_fd;
+		int stop_fd;
+
+		std::mutex                       mutex;
+		std::map<int, watched_directory> directories;
+
+		std::thread thread;
+
+		implementation(callback_type c, const std::chrono::milliseconds d)
+			: callback{std::move(c)},
+			debounce{d},
+			inotify_fd{::inotify_init1(IN_NONBLOCK | IN_CLOEXEC)},
+			stop_fd{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)},
+			thread{[this] { run(); }} {}
+
+		implementation(const implementation&) = delete;
+		implementation(implementation&&) = delete;
+		auto operator=(const implementation&) -> implementation& = delete;
+		auto operator=(implementation&&) -> implementation& = delete;
+
+		~implementation() noexcept
+		{
+			if (stop_fd != -1)
+			{
+				const std::uint64_t value = 1;
+				(void)::write(stop_fd, &value, sizeof(value));
+			}
+			thread.join();
+
+			if (inotify_fd != -1) { ::close(inotify_fd); }
+			if (stop_fd != -1) { ::close(stop_fd); }
+		}
+
+		[[nodiscard]] auto watch(const std::string_view path) -> bool
+		{
+			if (inotify_fd == -1) { return false; }
+
+			fs::path directory;
+			fs::path name;
+			if (!split_path(path, directory, name)) { return false; }
+
+			std::lock_guard lock{mutex};
+
+			const auto wd = ::inotify_add_watch(inotify_fd, directory.c_str(), watch_mask);
+			if (wd == -1) { return false; }
+
+			auto& [watched, names, all] = directories[wd];
+			watched = directory;
+			if (name.empty()) { all = true; }
+			else { names.insert(name); }
+
+			return true;
+		}
+
+		auto read_events(pending_type& pending) -> void
+		{
+			// the buffer should be aligned with inotify_event
+			alignas(inotify_event) char buffer[4096];
+
+			while (true)
+			{
+				const auto length = ::read(inotify_fd, buffer, sizeof(buffer));
+				if (length <= 0) { return; }
+
+				const auto deadline = clock_type::now() + debounce;
+
+				std::lock_guard lock{mutex};
+				for (const char* p = buffer; p < buffer + length;)
+				{
+					const auto* event = reinterpret_cast<const inotify_event*>(p);
+					p += sizeof(inotify_event) + event->len;
+
+					// Some events are lost, assume all watched files (including every file of a directory watched as a whole) have changed.
+					if (event->mask & IN_Q_OVERFLOW)
+					{
+						for (const auto& [wd, watched]: directories)
+						{
+							if (watched.all)
+							{
+								std::error_code error_code{};
+								for (const auto& entry: fs::directory_iterator{watched.directory, error_code})
+								{
+									if (entry.is_regular_file(error_code)) { pending[entry.path()] = deadline; }
+								}
+							}
+
+							for (const auto& name: watched.names) { pending[watched.directory / name] = deadline; }
+						}
+						continue;
+					}
+
+					if (event->len == 0) { continue; }
+
+					const auto it = directories.find(event->wd);
+					if (it == directories.end()) { continue; }
+
+					const fs::path name{event->name};
+					if (it->second.contains(name)) { pending[it->second.directory / name] = deadline; }
+				}
+			}
+		}
+
+		auto run() -> void
+		{
+			if (inotify_fd == -1 || stop_fd == -1) { return; }
+
+			pending_type pending{};
+			auto         timeout = std::chrono::milliseconds::max();
+
+			while (true)
+			{
+				pollfd fds[2]{
+						{.fd = inotify_fd, .events = POLLIN, .revents = 0},
+						{.fd = stop_fd, .events = POLLIN, .revents = 0}};
+
+				const auto wait = timeout == std::chrono::milliseconds::max() ? -1 : static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(), std::numeric_limits<int>::max()));
+				if (::poll(fds, 2, wait) < 0 && errno != EINTR) { return; }
+
+				if (fds[1].revents & POLLIN) { return; }
+				if (fds[0].revents & POLLIN) { read_events(pending); }
+
+				timeout = fire(pending, callback);
+			}
+		}
+	};
+	#else
+	// ========================================
+	// POLLING
+	// ========================================
+
+	struct FileWatcher::implementation
+	{
+		callback_type             callback;
+		std::chrono::milliseconds debounce;
+
+		std::mutex              mutex;
+		std::condition_variable condition;
+		bool                    stop;
+
+		std::vector<watched_directory> directories;
+		// file => (size, mtime)
+		std::map<fs::path, std::pair<std::uintmax_t, fs::file_time_type>> states;
+
+		std::thread thread;
+
+		implementation(callback_type c, const std::chrono::milliseconds d)
+			: callback{std::move(c)},
+			debounce{d},
+			stop{false},
+			thread{[this] { run(); }} {}
+
+		implementation(const implementation&) = delete;
+		implementation(implementation&&) = delete;
+		auto operator=(const implementation&) -> implementation& = delete;
+		auto operator=(implementation&&) -> implementation& = delete;
+
+		~implementation() noexcept
+		{
+			{
+				std::lock_guard lock{mutex};
+				stop = true;
+			}
+			condition.notify_all();
+			thread.join();
+		}
+
+		[[nodiscard]] static auto state_of(const fs::path& file) -> std::pair<std::uintmax_t, fs::file_time_type>
+		{
+			std::error_code error_code{};
+			const auto      size = fs::file_size(file, error_code);
+			if (error_code) { return {0, {}}; }
+			const auto last_write_time = fs::last_write_time(file, error_code);
+			if (error_code) { return {0, {}}; }
+			return {size, last_write_time};
+		}
+
+		[[nodiscard]] auto watch(const std::string_view path) -> bool
+		{
+			fs::path directory;
+			fs::path name;
+			if (!split_path(path, directory, name)) { return false; }
+
+			std::lock_guard lock{mutex};
+
+			auto it = std::ranges::find(directories, directory, &watched_directory::directory);
+			if (it == directories.end()) { it = directories.insert(directories.end(), {.directory = directory, .names = {}, .all = false}); }
+
+			if (name.empty())
+			{
+				it->all = true;
+
+				std::error_code error_code{};
+				for (const auto& entry: fs::directory_iterator{directory, error_code})
+				{
+					if (entry.is_regular_file(error_code)) { states.emplace(entry.path(), state_of(entry.path())); }
+				}
+			}
+			else
+			{
+				it->names.insert(name);
+				states.emplace(directory / name, state_of(directory / name));
+			}
+
+			return true;
+		}
+
+		// mutex must be held
+		auto scan(pending_type& pending) -> void
+		{
+			const auto deadline = clock_type::now() + debounce;
+
+			const auto check = [&](const fs::path& file)
+			{
+				const auto state = state_of(file);
+				if (auto& last = states[file];
+					last != state)
+				{
+					last          = state;
+					pending[file] = deadline;
+				}
+			};
+
+			for (const auto& [directory, names, all]: directories)
+			{
+				if (all)
+				{
+					std::error_code error_code{};
+					for (const auto& entry: fs::directory_iterator{directory, error_code})
+					{
+						if (entry.is_regular_file(error_code)) { check(entry.path()); }
+					}
+				}
+
+				for (const auto& name: names) { check(directory / name); }
+			}
+		}
+
+		auto run() -> void
+		{
+			pending_type pending{};
+
+			while (true)
+			{
+				{
+					std::unique_lock lock{mutex};
+					if (condition.wait_for(lock, debounce, [this] { return stop; })) { return; }
+
+					scan(pending);
+				}
+
+				(void)fire(pending, callback);
+			}
+		}
+	};
+	#endif
+
+	FileWatcher::FileWatcher(callback_type callback, const std::chrono::milliseconds debounce)
+		: impl_{std::make_unique<implementation>(std::move(callback), debounce)} {}
+
+	FileWatcher::~FileWatcher() noexcept = default;
+
+	auto FileWatcher::watch(const std::string_view path) -> bool { return impl_->watch(path); }
+}// namespace gal::ini
@@ -0,0 +1,89 @@
+#include <boost/ut.hpp>
+#include <fstream>
+#include <ini/cow_document.hpp>
+#include <ini/diff.hpp>
+#include <ini/flusher.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+#define GROUP3_NAME "group3"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	using document_type = CowDocument<char>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_cow_document = []
+	{
+		const std::unordered_map<std::string, std::unordered_map<std::string, std::string>> context{
+				{GROUP1_NAME, {{"key1", "value1"}, {"key2", "value2"}}},
+				{GROUP2_NAME, {{"key1", "value1"}}}};
+
+		const document_type committed{context};
+
+		"copy"_test = [&]
+		{
+			expect((committed.size() == 2_i) >> fatal);
+			expect((committed.get(GROUP1_NAME, "key2") == "value2") >> fatal);
+			expect(!committed.get(GROUP3_NAME, "key1").has_value() >> fatal);
+		};
+
+		"path_copy"_test = [&]
+		{
+			auto staged = committed.clone();
+			expect(staged.shares(committed, GROUP1_NAME) >> fatal);
+			expect(staged.shares(committed, GROUP2_NAME) >> fatal);
+
+			staged.set(GROUP1_NAME, "key1", "changed");
+			staged.set(GROUP3_NAME, "key1", "value1");
+
+			// only the modified group is copied
+			expect(!staged.shares(committed, GROUP1_NAME) >> fatal);
+			expect(staged.shares(committed, GROUP2_NAME) >> fatal);
+
+			expect((staged.get(GROUP1_NAME, "key1") == "changed") >> fatal);
+			expect((committed.get(GROUP1_NAME, "key1") == "value1") >> fatal);
+			expect((staged.size() == 3_i) >> fatal);
+			expect((committed.size() == 2_i) >> fatal);
+
+			// nothing to erase => nothing copied
+			expect(!staged.erase(GROUP2_NAME, "not_exists") >> fatal);
+			expect(staged.shares(committed, GROUP2_NAME) >> fatal);
+
+			expect(staged.erase(GROUP2_NAME) >> fatal);
+			expect(!staged.contains(GROUP2_NAME) >> fatal);
+			expect(committed.contains(GROUP2_NAME) >> fatal);
+
+			// the staged modifications
+			const auto changes = diff(committed, staged);
+			expect((changes.size() == 3_i) >> fatal);
+		};
+
+		"flush"_test = [&]
+		{
+			auto staged = committed.clone();
+			staged.set(GROUP1_NAME, "key1", "changed");
+
+			expect((flush_to_file(TEST_INI_FLUSHER_FILE_PATH, staged) == FlushResult::SUCCESS) >> fatal);
+
+			std::ifstream     file{TEST_INI_FLUSHER_FILE_PATH};
+			std::stringstream buffer{};
+			buffer << file.rdbuf();
+
+			const auto flushed = buffer.str();
+			expect((flushed.find("key1 = changed") != std::string::npos) >> fatal);
+			expect((flushed.find("[" GROUP2_NAME "]") != std::string::npos) >> fatal);
+		};
+	};
+}// namespace
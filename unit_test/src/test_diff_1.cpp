@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <ini/diff.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+#define GROUP3_NAME "group3"
+#define GROUP4_NAME "group4"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	// not transparent
+	using ordered_context_type = std::map<std::string, std::map<std::string, std::string>>;
+
+	// a group that caches the hash of its content
+	struct hashed_group_type : group_type
+	{
+		std::uint64_t hash;
+
+		[[nodiscard]] auto content_hash() const noexcept -> std::uint64_t { return hash; }
+	};
+
+	using hashed_context_type = std::unordered_map<std::string, hashed_group_type, string_hasher, std::equal_to<>>;
+
+	[[nodiscard]] auto contains(const diff_result_type<char>& result, const diff_entry<char>& entry) -> bool { return std::ranges::find(result, entry) != result.end(); }
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_diff_context = []
+	{
+		const context_type old_context{
+				{GROUP1_NAME, {{"key1", "value1"}, {"key2", "value2"}}},
+				{GROUP2_NAME, {{"key1", "value1"}, {"key2", "value2"}, {"key3", "value3"}}},
+				{GROUP3_NAME, {{"key1", "value1"}}}};
+
+		const ordered_context_type new_context{
+				// same content, different order
+				{GROUP1_NAME, {{"key2", "value2"}, {"key1", "value1"}}},
+				{GROUP2_NAME, {{"key1", "value1"}, {"key2", "changed"}, {"key4", "value4"}}},
+				{GROUP4_NAME, {{"key1", "value1"}}}};
+
+		const auto result = diff(old_context, new_context);
+
+		"changes"_test = [&]
+		{
+			expect((result.size() == 5_i) >> fatal);
+
+			expect(contains(result, {.kind = DiffKind::VALUE_CHANGED, .group = GROUP2_NAME, .key = "key2", .old_value = "value2", .new_value = "changed"}) >> fatal);
+			expect(contains(result, {.kind = DiffKind::KEY_REMOVED, .group = GROUP2_NAME, .key = "key3", .old_value = "value3", .new_value = {}}) >> fatal);
+			expect(contains(result, {.kind = DiffKind::KEY_ADDED, .group = GROUP2_NAME, .key = "key4", .old_value = {}, .new_value = "value4"}) >> fatal);
+			expect(contains(result, {.kind = DiffKind::GROUP_REMOVED, .group = GROUP3_NAME, .key = {}, .old_value = {}, .new_value = {}}) >> fatal);
+			expect(contains(result, {.kind = DiffKind::GROUP_ADDED, .group = GROUP4_NAME, .key = {}, .old_value = {}, .new_value = {}}) >> fatal);
+		};
+
+		"no_changes"_test = [&] { expect(diff(old_context, old_context).empty() >> fatal); };
+
+		"cached_hash"_test = []
+		{
+			hashed_context_type old_hashed{};
+			old_hashed[GROUP1_NAME] = {{{{"key1", "value1"}}}, 42};
+			old_hashed[GROUP2_NAME] = {{{{"key1", "value1"}}}, 42};
+
+			hashed_context_type new_hashed{};
+			// same hash => trusted, the pairs are not compared
+			new_hashed[GROUP1_NAME] = {{{{"key1", "changed"}}}, 42};
+			new_hashed[GROUP2_NAME] = {{{{"key1", "changed"}}}, 43};
+
+			const auto hashed_result = diff(old_hashed, new_hashed);
+			expect((hashed_result.size() == 1_i) >> fatal);
+			expect((hashed_result.front() == diff_entry<char>{.kind = DiffKind::VALUE_CHANGED, .group = GROUP2_NAME, .key = "key1", .old_value = "value1", .new_value = "changed"}) >> fatal);
+		};
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_diff_lazy_document = []
+	{
+		const LazyDocument<char> old_document{
+				"[" GROUP1_NAME "]\n"
+				"key1 = value1\n"
+				"[" GROUP2_NAME "]\n"
+				"key1 = value1\n"
+				"key2 = value2\n"
+				"[" GROUP3_NAME "]\n"
+				"key1 = value1\n"};
+
+		const LazyDocument<char> new_document{
+				"[" GROUP1_NAME "]\n"
+				"key1 = value1\n"
+				"[" GROUP2_NAME "]\n"
+				"; only a comment has changed\n"
+				"key1 = value1\n"
+				"key2 = value2\n"
+				"[" GROUP3_NAME "]\n"
+				"key1 = changed\n"};
+
+		const auto result = diff(old_document, new_document);
+
+		"changes"_test = [&]
+		{
+			expect((result.size() == 1_i) >> fatal);
+			expect((result.front() == diff_entry<char>{.kind = DiffKind::VALUE_CHANGED, .group = GROUP3_NAME, .key = "key1", .old_value = "value1", .new_value = "changed"}) >> fatal);
+		};
+
+		"unchanged_groups_are_not_extracted"_test = [&]
+		{
+			expect(!old_document.materialized(GROUP1_NAME) >> fatal);
+			expect(!new_document.materialized(GROUP1_NAME) >> fatal);
+
+			// the raw bytes differ
+			expect(old_document.materialized(GROUP2_NAME) >> fatal);
+			expect(old_document.materialized(GROUP3_NAME) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,169 @@
+#include <boost/ut.hpp>
+#include <filesystem>
+#include <fstream>
+#include <ini/extractor.hpp>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+#define GROUP3_NAME "group3 with a name long enough to not fit into the small string buffer"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::pmr::unordered_map<std::pmr::string, std::pmr::string, string_hasher, std::equal_to<>>;
+	using context_type = std::pmr::unordered_map<std::pmr::string, group_type, string_hasher, std::equal_to<>>;
+
+	// Any allocation that does not go through the resource of the context fails.
+	class DefaultResourceGuard
+	{
+		std::pmr::memory_resource* previous_;
+
+	public:
+		DefaultResourceGuard()
+			: previous_{std::pmr::set_default_resource(std::pmr::null_memory_resource())} {}
+
+		DefaultResourceGuard(const DefaultResourceGuard&)                    = delete;
+		DefaultResourceGuard(DefaultResourceGuard&&)                         = delete;
+		auto operator=(const DefaultResourceGuard&) -> DefaultResourceGuard& = delete;
+		auto operator=(DefaultResourceGuard&&) -> DefaultResourceGuard&      = delete;
+
+		~DefaultResourceGuard() noexcept { std::pmr::set_default_resource(previous_); }
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_extractor_generate_file = []
+	{
+		const std::filesystem::path file_path{TEST_INI_EXTRACTOR_FILE_PATH};
+
+		std::ofstream file{file_path, std::ios::out | std::ios::trunc};
+
+		file << "[" GROUP1_NAME << "]\n";
+		file << "key1=value1\n";
+		file << "key2 = a_value_long_enough_to_not_fit_into_the_small_string_buffer\n";
+		file << "\n";
+
+		file << "[" GROUP2_NAME "]\n";
+		file << "key1 = value1\n";
+
+		file << "[" GROUP3_NAME "]\n";
+
+		file.close();
+	};
+
+	auto check_extract_result = [](const ExtractResult extract_result, const context_type& data, std::pmr::memory_resource* resource) -> void
+	{
+		"extract_ok"_test = [extract_result] { expect((extract_result == ExtractResult::SUCCESS) >> fatal); };
+
+		"group_size"_test = [&] { expect((data.size() == 3_i) >> fatal); };
+
+		"group1"_test = [&]
+		{
+			const auto& [name, group] = *data.find(GROUP1_NAME);
+
+			expect((name == GROUP1_NAME) >> fatal);
+			expect((group.size() == 2_i) >> fatal);
+
+			expect((group.at("key1") == "value1") >> fatal);
+			expect((group.at("key2") == "a_value_long_enough_to_not_fit_into_the_small_string_buffer") >> fatal);
+		};
+
+		"group2"_test = [&]
+		{
+			const auto& [name, group] = *data.find(GROUP2_NAME);
+
+			expect((name == GROUP2_NAME) >> fatal);
+			expect((group.size() == 1_i) >> fatal);
+
+			expect((group.at("key1") == "value1") >> fatal);
+		};
+
+		"group3"_test = [&]
+		{
+			const auto& [name, group] = *data.find(GROUP3_NAME);
+
+			expect((name == GROUP3_NAME) >> fatal);
+			expect(group.empty() >> fatal);
+		};
+
+		"same_resource"_test = [&]
+		{
+			expect((data.get_allocator().resource() == resource) >> fatal);
+
+			for (const auto& [name, group]: data)
+			{
+				expect((name.get_allocator().resource() == resource) >> fatal);
+				expect((group.get_allocator().resource() == resource) >> fatal);
+
+				for (const auto& [key, value]: group)
+				{
+					expect((key.get_allocator().resource() == resource) >> fatal);
+					expect((value.get_allocator().resource() == resource) >> fatal);
+				}
+			}
+		};
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_extractor_extract_from_file_into_resource = []
+	{
+		std::pmr::monotonic_buffer_resource resource{};
+
+		ExtractResult extract_result;
+		context_type  data{&resource};
+		{
+			const DefaultResourceGuard guard{};
+
+			extract_result = extract_from_file<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, data);
+		}
+
+		check_extract_result(extract_result, data, &resource);
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_extractor_extract_from_buffer_into_resource = []
+	{
+		std::ifstream file{TEST_INI_EXTRACTOR_FILE_PATH, std::ios::in};
+		expect((file.is_open()) >> fatal);
+
+		const std::string buffer{
+				std::istreambuf_iterator<char>(file),
+				std::istreambuf_iterator<char>()};
+
+		std::pmr::monotonic_buffer_resource resource{};
+
+		#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+		auto  workaround_extract_result_data = extract_from_buffer<context_type>(buffer, context_type::allocator_type{&resource});
+		auto& extract_result				 = workaround_extract_result_data.first;
+		auto& data							 = workaround_extract_result_data.second;
+		#else
+		auto [extract_result, data] = extract_from_buffer<context_type>(buffer, context_type::allocator_type{&resource});
+		#endif
+
+		check_extract_result(extract_result, data, &resource);
+	};
+}// namespace
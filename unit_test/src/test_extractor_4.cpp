@@ -0,0 +1,163 @@
+#include <boost/ut.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <ini/extractor.hpp>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	auto write_file(const std::string_view value) -> void
+	{
+		std::ofstream file{TEST_INI_EXTRACTOR_FILE_PATH, std::ios::out | std::ios::trunc};
+
+		file << "[" GROUP1_NAME "]\n";
+		file << "key1 = " << value << "\n";
+		file << "[" GROUP2_NAME "]\n";
+		file << "key1 = value1\n";
+	}
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_extractor_extract_if_changed = []
+	{
+		write_file("value1");
+
+		context_type data{};
+
+		const auto [first_result, first_token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, change_token{}, data);
+
+		"first_extract"_test = [&]
+		{
+			expect((first_result == ExtractResult::SUCCESS) >> fatal);
+			expect((data.size() == 2_i) >> fatal);
+			expect((data.at(GROUP1_NAME).at("key1") == "value1") >> fatal);
+		};
+
+		"not_modified"_test = [&]
+		{
+			context_type untouched{};
+
+			const auto [result, token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, first_token, untouched);
+
+			expect((result == ExtractResult::NOT_MODIFIED) >> fatal);
+			expect(untouched.empty() >> fatal);
+			expect((token.hash == first_token.hash) >> fatal);
+		};
+
+		"touched_with_same_content"_test = [&]
+		{
+			std::filesystem::last_write_time(TEST_INI_EXTRACTOR_FILE_PATH, std::filesystem::file_time_type::clock::now() - std::chrono::hours{1});
+
+			context_type untouched{};
+
+			const auto [result, token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, first_token, untouched);
+
+			expect((result == ExtractResult::NOT_MODIFIED) >> fatal);
+			expect(untouched.empty() >> fatal);
+			expect((token.hash == first_token.hash) >> fatal);
+			expect((token.mtime_ns != 0) >> fatal);
+
+			const auto [again_result, again_token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, token, untouched);
+
+			expect((again_result == ExtractResult::NOT_MODIFIED) >> fatal);
+			expect((again_token == token) >> fatal);
+		};
+
+		"modified"_test = [&]
+		{
+			// same size, different content
+			write_file("value2");
+
+			context_type modified{};
+
+			const auto [result, token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, first_token, modified);
+
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+			expect((token.hash != first_token.hash) >> fatal);
+			expect((modified.at(GROUP1_NAME).at("key1") == "value2") >> fatal);
+		};
+
+		"edited_and_removed"_test = [&]
+		{
+			{
+				std::ofstream file{TEST_INI_EXTRACTOR_FILE_PATH, std::ios::out | std::ios::trunc};
+				file << "[" GROUP1_NAME "]\n";
+				file << "key1 = edited\n";
+				file << "[" GROUP2_NAME "]\n";
+			}
+
+			// the data of the first extraction
+			const auto [result, token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, first_token, data);
+
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+			expect((data.size() == 2_i) >> fatal);
+			expect((data.at(GROUP1_NAME).at("key1") == "edited") >> fatal);
+			expect(data.at(GROUP2_NAME).empty() >> fatal);
+		};
+
+		"bom"_test = [&]
+		{
+			{
+				std::ofstream file{TEST_INI_EXTRACTOR_FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+				file << "\xEF\xBB\xBF[" GROUP1_NAME "]\n";
+			}
+			// not racy
+			std::filesystem::last_write_time(TEST_INI_EXTRACTOR_FILE_PATH, std::filesystem::file_time_type::clock::now() - std::chrono::hours{1});
+
+			context_type bom{};
+
+			const auto [result, token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, change_token{}, bom);
+
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+			// the size of the file (including the BOM), so that the metadata matches next time
+			expect((token.size == std::filesystem::file_size(TEST_INI_EXTRACTOR_FILE_PATH)) >> fatal);
+
+			const auto [again_result, again_token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH, token, bom);
+
+			expect((again_result == ExtractResult::NOT_MODIFIED) >> fatal);
+			expect((again_token == token) >> fatal);
+		};
+
+		"file_not_found"_test = [&]
+		{
+			context_type nothing{};
+
+			const auto [result, token] = extract_if_changed<context_type>(TEST_INI_EXTRACTOR_FILE_PATH ".not_exists", first_token, nothing);
+
+			expect((result == ExtractResult::FILE_NOT_FOUND) >> fatal);
+			expect(nothing.empty() >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,92 @@
+#include <array>
+#include <boost/ut.hpp>
+#include <filesystem>
+#include <fstream>
+#include <ini/extractor.hpp>
+#include <ini/flusher.hpp>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+				return 0;
+			}
+		}
+	};
+
+	using group_type = std::pmr::unordered_map<std::pmr::string, std::pmr::string, string_hasher, std::equal_to<>>;
+	using context_type = std::pmr::unordered_map<std::pmr::string, group_type, string_hasher, std::equal_to<>>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_flusher_flush_to_file_with_stack_views = []
+	{
+		std::pmr::monotonic_buffer_resource data_resource{};
+		context_type                        data{&data_resource};
+
+		{
+			auto& group = data[GROUP1_NAME];
+
+			group.emplace("key1", "value1");
+			group.emplace("key2", "value2");
+		}
+
+		{
+			auto& group = data[GROUP2_NAME];
+
+			group.emplace("key1", "value1");
+		}
+
+		{
+			// The temporary views must not allocate anything outside this buffer.
+			std::array<std::byte, 4096>         view_buffer{};
+			std::pmr::monotonic_buffer_resource view_resource{view_buffer.data(), view_buffer.size(), std::pmr::null_memory_resource()};
+
+			const auto flush_result = flush_to_file(TEST_INI_FLUSHER_FILE_PATH, data, flush_view_allocator_type<context_type>{&view_resource});
+
+			"flush_ok"_test = [flush_result] { expect((flush_result == FlushResult::SUCCESS) >> fatal); };
+		}
+
+		std::pmr::monotonic_buffer_resource extract_resource{};
+
+		#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+		auto  workaround_extract_result_data = extract_from_file<context_type>(TEST_INI_FLUSHER_FILE_PATH, context_type::allocator_type{&extract_resource});
+		auto& extract_result                 = workaround_extract_result_data.first;
+		auto& extract_data                   = workaround_extract_result_data.second;
+		#else
+		auto [extract_result, extract_data] = extract_from_file<context_type>(TEST_INI_FLUSHER_FILE_PATH, context_type::allocator_type{&extract_resource});
+		#endif
+
+		"extract_ok"_test = [extract_result] { expect((extract_result == ExtractResult::SUCCESS) >> fatal); };
+
+		"same_data"_test = [&]
+		{
+			expect((extract_data == data) >> fatal);
+			expect((extract_data.get_allocator().resource() == &extract_resource) >> fatal);
+		};
+	};
+}// namespace
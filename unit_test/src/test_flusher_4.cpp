@@ -0,0 +1,114 @@
+#include <boost/ut.hpp>
+#include <filesystem>
+#include <ini/extractor.hpp>
+#include <ini/flusher.hpp>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+				return 0;
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	// The temporary files (.file_name.pid.counter.tmp) are in the same directory as the file.
+	[[nodiscard]] auto temp_file_count() -> std::size_t
+	{
+		const std::filesystem::path path{TEST_INI_FLUSHER_FILE_PATH};
+		const auto                  prefix = std::string{"."}.append(path.filename().string()).append(".");
+
+		std::size_t count = 0;
+		for (const auto& entry: std::filesystem::directory_iterator{path.has_parent_path() ? path.parent_path() : std::filesystem::path{"."}})
+		{
+			if (const auto name = entry.path().filename().string();
+				name.starts_with(prefix) && name.ends_with(".tmp")) { count += 1; }
+		}
+		return count;
+	}
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_flusher_durability = []
+	{
+		for (const auto durability: {FlushDurability::NONE, FlushDurability::DATA, FlushDurability::FULL})
+		{
+			context_type data{};
+			data[GROUP1_NAME].emplace("key1", std::to_string(static_cast<int>(durability)));
+
+			const auto flush_result = flush_to_file(TEST_INI_FLUSHER_FILE_PATH, data, durability);
+
+			"flush_ok"_test = [flush_result] { expect((flush_result == FlushResult::SUCCESS) >> fatal); };
+
+			"no_temp_file"_test = [] { expect((temp_file_count() == std::size_t{0}) >> fatal); };
+
+			"same_data"_test = [&data]
+			{
+				context_type extract_data{};
+				expect((extract_from_file(TEST_INI_FLUSHER_FILE_PATH, extract_data) == ExtractResult::SUCCESS) >> fatal);
+				expect((extract_data == data) >> fatal);
+			};
+		}
+
+		// creating a symlink requires a privilege on Windows
+		#if not defined(GAL_INI_PLATFORM_WINDOWS)
+		"links"_test = []
+		{
+			const std::filesystem::path path{TEST_INI_FLUSHER_FILE_PATH};
+			const auto                  symlink   = std::filesystem::path{path}.concat(".symlink");
+			const auto                  hard_link = std::filesystem::path{path}.concat(".hard_link");
+
+			std::filesystem::remove(symlink);
+			std::filesystem::remove(hard_link);
+			std::filesystem::create_symlink(path.filename(), symlink);
+
+			context_type data{};
+			data[GROUP1_NAME].emplace("key1", "symlink");
+
+			// written through the symlink
+			expect((flush_to_file(symlink.string(), data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect(std::filesystem::is_symlink(symlink) >> fatal);
+			expect((temp_file_count() == std::size_t{0}) >> fatal);
+
+			std::filesystem::create_hard_link(path, hard_link);
+			data[GROUP1_NAME]["key1"] = "hard_link";
+
+			// the hard link is still the same file
+			expect((flush_to_file(hard_link.string(), data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect(std::filesystem::equivalent(path, hard_link) >> fatal);
+
+			context_type extract_data{};
+			expect((extract_from_file(TEST_INI_FLUSHER_FILE_PATH, extract_data) == ExtractResult::SUCCESS) >> fatal);
+			expect((extract_data == data) >> fatal);
+
+			std::filesystem::remove(symlink);
+			std::filesystem::remove(hard_link);
+		};
+		#endif
+	};
+}// namespace
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <fstream>
+#include <ini/extractor.hpp>
+#include <ini/flusher.hpp>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+				return 0;
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	using char_type = string_view_t<context_type::key_type>::value_type;
+
+	constexpr std::string_view source =
+			"; comment of group1\n"
+			"[group1] # inline comment of group1\n"
+			"key1 = value1 ; inline comment of key1\n"
+			"; comment of key2\n"
+			"key2 = value2\n"
+			"\n"
+			"[group2]\n"
+			"key1 = value1\n";
+
+	// Only operator<< is implemented, every fragment is a virtual call.
+	class TokenOut final : public UserOut<char_type>
+	{
+	public:
+		std::string out;
+
+		/* constexpr */
+		auto operator<<(const char_type d) -> UserOut&
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			out.push_back(d);
+			return *this;
+		}
+
+		/* constexpr */
+		auto operator<<(const string_view_t<char_type> d) -> UserOut&
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			out.append(d);
+			return *this;
+		}
+	};
+
+	// A whole line is a virtual call.
+	class BatchOut final : public UserOut<char_type>
+	{
+	public:
+		std::string out;
+
+		std::size_t token_count   = 0;
+		std::size_t write_count   = 0;
+		std::size_t reserve_count = 0;
+		std::size_t flush_count   = 0;
+
+		/* constexpr */
+		auto operator<<(const char_type d) -> UserOut&
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			token_count += 1;
+			out.push_back(d);
+			return *this;
+		}
+
+		/* constexpr */
+		auto operator<<(const string_view_t<char_type> d) -> UserOut&
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			token_count += 1;
+			out.append(d);
+			return *this;
+		}
+
+		/* constexpr */
+		auto write(const fragments_type fragments) -> UserOut&
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			write_count += 1;
+			for (const auto fragment: fragments) { out.append(fragment); }
+			return *this;
+		}
+
+		/* constexpr */
+		auto reserve(const std::size_t size_hint) -> void
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			reserve_count += 1;
+			out.reserve(size_hint);
+		}
+
+		/* constexpr */
+		auto flush() -> void
+			// Tell me why! MSVC!
+			#if not defined(GAL_INI_COMPILER_MSVC)
+			override
+			#endif
+		{
+			flush_count += 1;
+		}
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_flusher_flush_to_user_batch = []
+	{
+		{
+			std::ofstream file{TEST_INI_FLUSHER_FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+			file << source;
+		}
+
+		context_type data{};
+		data["group1"]["key1"] = "VALUE1";
+		data["group1"]["key2"] = "value2";
+		data["group1"]["key3"] = "value3";
+		data["group3"]["key1"] = "value1";
+
+		TokenOut token_out{};
+		expect((flush_to_user(TEST_INI_FLUSHER_FILE_PATH, data, token_out) == FlushResult::SUCCESS) >> fatal);
+
+		BatchOut batch_out{};
+		expect((flush_to_user(TEST_INI_FLUSHER_FILE_PATH, data, batch_out) == FlushResult::SUCCESS) >> fatal);
+
+		"same_output"_test = [&] { expect((batch_out.out == token_out.out) >> fatal); };
+
+		"batched"_test = [&]
+		{
+			// everything (including the key-value pairs written by flush_to_user) is written line by line
+			expect((batch_out.token_count == std::size_t{0}) >> fatal);
+			// one write per line (the inline comment and the newline are written with the key-value pair)
+			expect((batch_out.write_count == static_cast<std::size_t>(std::ranges::count(batch_out.out, '\n'))) >> fatal);
+			expect((batch_out.reserve_count == std::size_t{1}) >> fatal);
+			expect((batch_out.flush_count == std::size_t{1}) >> fatal);
+		};
+
+		"same_data"_test = [&]
+		{
+			context_type extract_data{};
+			expect((extract_from_buffer(batch_out.out, extract_data) == ExtractResult::SUCCESS) >> fatal);
+			expect((extract_data == data) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,92 @@
+#include <boost/ut.hpp>
+#include <fstream>
+#include <ini/extractor.hpp>
+#include <ini/flusher.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+				return 0;
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	constexpr std::string_view source =
+			"; comment of group1\n"
+			"[group1] # inline comment of group1\n"
+			"key1 = value1 ; inline comment of key1\n"
+			"; comment of key2\n"
+			"key2 = value2\n"
+			"\n"
+			"[group2]\n"
+			"key1 = value1\n";
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_flusher_flush_to_buffer = []
+	{
+		context_type data{};
+		data["group1"]["key1"] = "VALUE1";
+		data["group1"]["key2"] = "value2";
+		data["group1"]["key3"] = "value3";
+		data["group3"]["key1"] = "value1";
+
+		"same_as_file"_test = [&data]
+		{
+			{
+				std::ofstream file{TEST_INI_FLUSHER_FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+				file << source;
+			}
+			expect((flush_to_file(TEST_INI_FLUSHER_FILE_PATH, data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+
+			std::ostringstream file_content{};
+			file_content << std::ifstream{TEST_INI_FLUSHER_FILE_PATH, std::ios::in | std::ios::binary}.rdbuf();
+
+			// the output is appended
+			std::string buffer{"prefix"};
+			expect((flush_to_buffer(source, data, buffer) == FlushResult::SUCCESS) >> fatal);
+			expect((buffer == "prefix" + file_content.str()) >> fatal);
+		};
+
+		"empty_path"_test = [&data]
+		{
+			// not the buffer mode, there is no file to write
+			expect((flush_to_file("", data, FlushDurability::NONE) == FlushResult::PERMISSION_DENIED) >> fatal);
+		};
+
+		"without_source"_test = [&data]
+		{
+			std::string buffer{};
+			expect((flush_to_buffer({}, data, buffer) == FlushResult::SUCCESS) >> fatal);
+
+			context_type extract_data{};
+			expect((extract_from_buffer(buffer, extract_data) == ExtractResult::SUCCESS) >> fatal);
+			expect((extract_data == data) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,117 @@
+#include <boost/ut.hpp>
+#include <ini/group_tree.hpp>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		[[nodiscard]] auto operator()(const std::string& string) const noexcept -> std::size_t { return std::hash<std::string>{}(string); }
+
+		[[nodiscard]] auto operator()(const std::string_view& string) const noexcept -> std::size_t { return std::hash<std::string_view>{}(string); }
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	using tree_type = GroupTree<char>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_group_tree = []
+	{
+		"extract"_test = []
+		{
+			context_type context{};
+			tree_type    tree{};
+
+			expect((extract_from_buffer<context_type>(
+					        "[server]\n"
+					        "name = main\n"
+					        "[server.http]\n"
+					        "port = 80\n"
+					        "[server.http.limits]\n"
+					        "rate = 10\n"
+					        "[server.https]\n"
+					        "port = 443\n"
+					        "[client]\n"
+					        "timeout = 10\n",
+					        context,
+					        tree) == ExtractResult::SUCCESS) >> fatal);
+
+			// the flat data is unchanged
+			expect((context.size() == 5_i) >> fatal);
+			expect((context["server.http.limits"]["rate"] == "10") >> fatal);
+
+			// component-wise
+			expect((tree.subtree("server.http") == std::vector<std::string_view>{"server.http", "server.http.limits"}) >> fatal);
+			expect((tree.subtree("server") == std::vector<std::string_view>{"server", "server.http", "server.http.limits", "server.https"}) >> fatal);
+			expect(tree.subtree("server.htt").empty() >> fatal);
+			expect((tree.subtree("").size() == 5_i) >> fatal);
+
+			expect(tree.contains("server.http") >> fatal);
+			expect(!tree.contains("server.http.limits.not_exists") >> fatal);
+		};
+
+		"intermediate"_test = []
+		{
+			const context_type context{
+					{"a.b.c", {}},
+					{"a.d", {}}};
+
+			const auto tree = tree_type::build(context);
+
+			// a path to the groups, but not a group itself
+			const auto a = tree.find("a");
+			expect(a.has_value() >> fatal);
+			expect(!tree.is_group(*a) >> fatal);
+			expect(!tree.contains("a") >> fatal);
+			expect((tree.children(*a).size() == 2_i) >> fatal);
+
+			const auto c = tree.find("a.b.c");
+			expect(c.has_value() >> fatal);
+			expect((tree.component(*c) == std::string_view{"c"}) >> fatal);
+			expect((tree.name(*c) == std::string_view{"a.b.c"}) >> fatal);
+			expect((tree.component(tree.parent(*c)) == std::string_view{"b"}) >> fatal);
+		};
+
+		"delimiter"_test = []
+		{
+			tree_type tree{'/'};
+			(void)tree.insert("root/child");
+			(void)tree.insert("root.child");
+
+			expect((tree.subtree("root") == std::vector<std::string_view>{"root/child"}) >> fatal);
+			expect((tree.subtree("root.child") == std::vector<std::string_view>{"root.child"}) >> fatal);
+		};
+
+		"move"_test = []
+		{
+			// the nodes refer to the strings of the tree itself
+			static_assert(!std::is_copy_constructible_v<tree_type>);
+			static_assert(!std::is_copy_assignable_v<tree_type>);
+
+			tree_type tree{};
+			(void)tree.insert("a.b");
+			(void)tree.insert("a.c");
+
+			const tree_type moved{std::move(tree)};
+			expect((moved.subtree("a") == std::vector<std::string_view>{"a.b", "a.c"}) >> fatal);
+			expect((moved.component(*moved.find("a.c")) == std::string_view{"c"}) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,169 @@
+#include <boost/ut.hpp>
+#include <chrono>
+#include <fstream>
+#include <ini/handle.hpp>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_handle_lazy_document = []
+	{
+		LazyDocument<char> document{
+				"[" GROUP1_NAME "]\n"
+				"int = 42\n"
+				"negative = -7\n"
+				"double = 3.5\n"
+				"bool = on\n"
+				"string = hello world\n"
+				"invalid = 42abc\n"};
+
+		handle<int>         int_handle{GROUP1_NAME, "int"};
+		handle<int>         negative_handle{GROUP1_NAME, "negative"};
+		handle<double>      double_handle{GROUP1_NAME, "double"};
+		handle<bool>        bool_handle{GROUP1_NAME, "bool"};
+		handle<std::string> string_handle{GROUP1_NAME, "string"};
+
+		"convert"_test = [&]
+		{
+			expect((int_handle.get(document) == 42) >> fatal);
+			expect((negative_handle.get(document) == -7) >> fatal);
+			expect((double_handle.get(document) == 3.5) >> fatal);
+			expect((bool_handle.get(document) == true) >> fatal);
+			expect((string_handle.get(document) == "hello world") >> fatal);
+		};
+
+		"sign"_test = []
+		{
+			expect((common::from_string<int, char>("+5") == 5) >> fatal);
+			expect((common::from_string<double, char>("+3.5") == 3.5) >> fatal);
+			// only one sign
+			expect(!common::from_string<int, char>("+-5").has_value() >> fatal);
+			expect(!common::from_string<int, char>("++5").has_value() >> fatal);
+			expect(!common::from_string<double, char>("+-3.5").has_value() >> fatal);
+		};
+
+		"not_found_or_invalid"_test = [&]
+		{
+			handle<int> invalid{GROUP1_NAME, "invalid"};
+			handle<int> no_key{GROUP1_NAME, "not_exists"};
+			handle<int> no_group{GROUP2_NAME, "int"};
+
+			expect(!invalid.get(document).has_value() >> fatal);
+			expect(!no_key.get(document).has_value() >> fatal);
+			expect(!no_group.get(document).has_value() >> fatal);
+			expect((no_group.value_or(document, 123) == 123_i) >> fatal);
+		};
+
+		"edited_document"_test = [&]
+		{
+			const auto                         offset = document.source().find("42");
+			const LazyDocument<char>::text_edit edit{.begin = offset, .end = offset + 2, .replacement = "1024"};
+			expect(document.apply_edits({&edit, 1}) >> fatal);
+
+			// looked up again
+			expect((int_handle.get(document) == 1024) >> fatal);
+			// the views of the document have changed, the cached string is still valid
+			expect((string_handle.get(document) == "hello world") >> fatal);
+		};
+
+		"another_document"_test = [&]
+		{
+			const LazyDocument<char> other{
+					"[" GROUP1_NAME "]\n"
+					"int = 0\n"};
+
+			expect((int_handle.get(other) == 0) >> fatal);
+			expect((int_handle.get(document) == 1024) >> fatal);
+		};
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_handle_watcher = []
+	{
+		const auto write_file = [](const std::string_view value) -> void
+		{
+			std::ofstream file{TEST_INI_WATCHER_FILE_PATH ".handle", std::ios::out | std::ios::trunc};
+
+			file << "[" GROUP1_NAME "]\n";
+			file << "key1 = " << value << "\n";
+		};
+
+		write_file("1");
+
+		Watcher<context_type> watcher{TEST_INI_WATCHER_FILE_PATH ".handle"};
+		handle<int>           key1{GROUP1_NAME, "key1"};
+
+		"reload"_test = [&]
+		{
+			expect((key1.get(watcher) == 1) >> fatal);
+
+			const auto generation = watcher.generation();
+			write_file("2");
+
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+			while (watcher.generation() == generation && std::chrono::steady_clock::now() < deadline) { std::this_thread::sleep_for(std::chrono::milliseconds{10}); }
+
+			// looked up again after the reload
+			expect((key1.get(watcher) == 2) >> fatal);
+		};
+
+		"recreated"_test = []
+		{
+			const auto write_recreated_file = [](const std::string_view value) -> void
+			{
+				std::ofstream file{TEST_INI_WATCHER_FILE_PATH ".recreated", std::ios::out | std::ios::trunc};
+
+				file << "[" GROUP1_NAME "]\n";
+				file << "key1 = " << value << "\n";
+			};
+
+			handle<int> key{GROUP1_NAME, "key1"};
+
+			// the second watcher lives at the same address as the first one
+			std::optional<Watcher<context_type>> recreated{};
+
+			write_recreated_file("1");
+			recreated.emplace(TEST_INI_WATCHER_FILE_PATH ".recreated");
+			expect((key.get(*recreated) == 1) >> fatal);
+
+			recreated.reset();
+			write_recreated_file("3");
+			recreated.emplace(TEST_INI_WATCHER_FILE_PATH ".recreated");
+			expect((key.get(*recreated) == 3) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,175 @@
+#include <boost/ut.hpp>
+#include <filesystem>
+#include <fstream>
+#include <ini/index.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+#define GROUP3_NAME "group3"
+
+#define TEST_INI_INDEX_SIDECAR_PATH TEST_INI_INDEX_FILE_PATH ".index"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	auto write_file(const std::string_view group2_value) -> void
+	{
+		std::ofstream file{TEST_INI_INDEX_FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+
+		file << "\xEF\xBB\xBF";
+		file << "[" GROUP1_NAME "]\n";
+		file << "key1 = value1\n";
+		file << "key2 = value2\n";
+		file << "[" GROUP2_NAME "]\n";
+		file << "key1 = " << group2_value << "\n";
+		file << "[" GROUP1_NAME "]\n";
+		file << "key3 = value3\n";
+		file << "[" GROUP3_NAME "]\n";
+	}
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_index = []
+	{
+		write_file("value1");
+
+		"build"_test = [] { expect((build_index(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH) == IndexResult::SUCCESS) >> fatal); };
+
+		"extract_group"_test = []
+		{
+			#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+			auto  workaround_result_file = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH);
+			auto& result                 = workaround_result_file.first;
+			auto& file                   = workaround_result_file.second;
+			#else
+			auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH);
+			#endif
+
+			expect((result == IndexResult::SUCCESS) >> fatal);
+			expect((file.size() == 3_i) >> fatal);
+			expect(file.contains(GROUP1_NAME) >> fatal);
+			expect(!file.contains("not_exists") >> fatal);
+			expect((file.ranges(GROUP1_NAME).size() == 2_i) >> fatal);
+
+			context_type data{};
+			expect((file.extract_group(GROUP1_NAME, data) == ExtractResult::SUCCESS) >> fatal);
+
+			// only the requested group
+			expect((data.size() == 1_i) >> fatal);
+			const auto& group = data.at(GROUP1_NAME);
+			expect((group.size() == 3_i) >> fatal);
+			expect((group.at("key1") == "value1") >> fatal);
+			expect((group.at("key2") == "value2") >> fatal);
+			expect((group.at("key3") == "value3") >> fatal);
+
+			expect((file.extract_group(GROUP3_NAME, data) == ExtractResult::SUCCESS) >> fatal);
+			expect((data.size() == 2_i) >> fatal);
+			expect(data.at(GROUP3_NAME).empty() >> fatal);
+
+			expect((file.extract_group("not_exists", data) == ExtractResult::SUCCESS) >> fatal);
+			expect((data.size() == 2_i) >> fatal);
+		};
+
+		"content_validation"_test = []
+		{
+			const auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH, IndexValidation::CONTENT);
+			expect((result == IndexResult::SUCCESS) >> fatal);
+		};
+
+		"outdated"_test = []
+		{
+			// same size, different content
+			write_file("value2");
+
+			const auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH);
+			expect((result == IndexResult::OUTDATED_INDEX) >> fatal);
+			expect((file.size() == 0_i) >> fatal);
+		};
+
+		"invalid"_test = []
+		{
+			// the source is not an index
+			const auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_FILE_PATH);
+			expect((result == IndexResult::INVALID_INDEX) >> fatal);
+		};
+
+		"damaged"_test = []
+		{
+			write_file("value1");
+			expect((build_index(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH) == IndexResult::SUCCESS) >> fatal);
+
+			// every bucket refers to an entry that does not exist (and there is no empty bucket)
+			{
+				std::fstream file{TEST_INI_INDEX_SIDECAR_PATH, std::ios::in | std::ios::out | std::ios::binary};
+
+				index_detail::index_header header{};
+				file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+				const std::vector<std::uint32_t> buckets(header.bucket_count, static_cast<std::uint32_t>(header.entry_count + 1));
+				file.seekp(sizeof(header));
+				file.write(reinterpret_cast<const char*>(buckets.data()), static_cast<std::streamsize>(buckets.size() * sizeof(std::uint32_t)));
+			}
+
+			const auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH);
+			expect((result == IndexResult::SUCCESS) >> fatal);
+			expect(!file.contains(GROUP1_NAME) >> fatal);
+			expect(!file.contains("not_exists") >> fatal);
+		};
+
+		"wrapped_size"_test = []
+		{
+			write_file("value1");
+			expect((build_index(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH) == IndexResult::SUCCESS) >> fatal);
+
+			// range_count * sizeof(index_range) wraps to the real size
+			{
+				std::fstream file{TEST_INI_INDEX_SIDECAR_PATH, std::ios::in | std::ios::out | std::ios::binary};
+
+				index_detail::index_header header{};
+				file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+				header.range_count += std::uint64_t{1} << 60;
+				file.seekp(0);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			}
+
+			const auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH);
+			expect((result == IndexResult::INVALID_INDEX) >> fatal);
+		};
+
+		"not_found"_test = []
+		{
+			const auto [result, file] = IndexedFile::open(TEST_INI_INDEX_FILE_PATH, TEST_INI_INDEX_SIDECAR_PATH ".not_exists");
+			expect((result == IndexResult::FILE_NOT_FOUND) >> fatal);
+		};
+	};
+}// namespace
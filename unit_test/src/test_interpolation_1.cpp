@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <ini/interpolation.hpp>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	// deterministic environment
+	const auto environment = [](const std::string_view name) -> std::optional<std::string>
+	{
+		if (name == "HOME") { return "/home/user"; }
+		return std::nullopt;
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_interpolation = []
+	{
+		"expand"_test = []
+		{
+			context_type context{
+					{GROUP1_NAME, {{"root", "${HOME}/app"}, {"data", "${" GROUP1_NAME ":root}/data"}, {"plain", "no reference"}}},
+					{GROUP2_NAME, {{"cache", "${" GROUP1_NAME ":data}/cache and ${" GROUP1_NAME ":data}/tmp"}}}};
+
+			const auto* plain = context[GROUP1_NAME]["plain"].data();
+
+			expect(interpolate(context, environment).empty() >> fatal);
+
+			expect((context[GROUP1_NAME]["root"] == "/home/user/app") >> fatal);
+			expect((context[GROUP1_NAME]["data"] == "/home/user/app/data") >> fatal);
+			expect((context[GROUP2_NAME]["cache"] == "/home/user/app/data/cache and /home/user/app/data/tmp") >> fatal);
+			// not touched
+			expect((context[GROUP1_NAME]["plain"].data() == plain) >> fatal);
+		};
+
+		"unresolved"_test = []
+		{
+			context_type context{
+					{GROUP1_NAME, {{"key1", "${" GROUP2_NAME ":not_exists}"}, {"key2", "${NOT_EXISTS}"}, {"key3", "x${" GROUP1_NAME ":key1"}}}};
+
+			const auto errors = interpolate(context, environment);
+			expect((errors.size() == 3_i) >> fatal);
+
+			// kept verbatim
+			expect((context[GROUP1_NAME]["key1"] == "${" GROUP2_NAME ":not_exists}") >> fatal);
+			expect((context[GROUP1_NAME]["key2"] == "${NOT_EXISTS}") >> fatal);
+
+			for (const auto& error: errors)
+			{
+				if (error.key == "key1") { expect((error.kind == InterpolationError::UNRESOLVED_REFERENCE) >> fatal); }
+				else if (error.key == "key2") { expect((error.kind == InterpolationError::UNRESOLVED_ENVIRONMENT) >> fatal); }
+				else
+				{
+					expect((error.kind == InterpolationError::MALFORMED) >> fatal);
+					expect((error.offset == 1_i) >> fatal);
+				}
+			}
+		};
+
+		"cycle"_test = []
+		{
+			context_type context{
+					{GROUP1_NAME, {{"a", "${" GROUP1_NAME ":b}"}, {"b", "x ${" GROUP2_NAME ":c}"}}},
+					{GROUP2_NAME, {{"c", "${" GROUP1_NAME ":a}"}, {"d", "${" GROUP1_NAME ":a}!"}}}};
+
+			context[GROUP2_NAME]["e"] = "${" GROUP2_NAME ":d}?";
+
+			const auto errors = interpolate(context, environment);
+			expect((errors.size() == 3_i) >> fatal);
+
+			const auto cycle = std::ranges::find(errors, InterpolationError::CYCLE, &interpolation_error<char>::kind);
+			expect((cycle != errors.end()) >> fatal);
+			// a -> b -> c -> a
+			expect((cycle->cycle.size() == 4_i) >> fatal);
+			expect((cycle->cycle.front() == cycle->cycle.back()) >> fatal);
+			expect((cycle->key == cycle->cycle.front().second) >> fatal);
+
+			// refers to a value in the cycle (directly or not)
+			for (const auto& error: errors | std::views::filter([](const auto& e) { return e.kind == InterpolationError::DEPENDS_ON_CYCLE; }))
+			{
+				expect((error.group == GROUP2_NAME) >> fatal);
+				expect((error.key == "d" || error.key == "e") >> fatal);
+				expect((error.offset == 0_i) >> fatal);
+			}
+
+			// not expanded
+			expect((context[GROUP1_NAME]["a"] == "${" GROUP1_NAME ":b}") >> fatal);
+			expect((context[GROUP2_NAME]["d"] == "${" GROUP1_NAME ":a}!") >> fatal);
+			expect((context[GROUP2_NAME]["e"] == "${" GROUP2_NAME ":d}?") >> fatal);
+		};
+
+		"empty_group"_test = []
+		{
+			// `${:key}` refers to the group whose name is empty, not to an environment variable
+			context_type context{
+					{GROUP1_NAME, {{"home", "${:HOME}"}, {"key", "${:key}"}}}};
+
+			auto errors = interpolate(context, environment);
+			expect((errors.size() == 2_i) >> fatal);
+			expect(std::ranges::all_of(errors, [](const auto& error) { return error.kind == InterpolationError::UNRESOLVED_REFERENCE; }) >> fatal);
+			expect((context[GROUP1_NAME]["home"] == "${:HOME}") >> fatal);
+
+			context[""]["key"] = "value";
+			context[GROUP1_NAME]["home"] = "x";
+
+			errors = interpolate(context, environment);
+			expect(errors.empty() >> fatal);
+			expect((context[GROUP1_NAME]["key"] == "value") >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,113 @@
+#include <boost/ut.hpp>
+#include <fstream>
+#include <ini/lazy_document.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+#define GROUP3_NAME "group3"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_lazy_document_generate_file = []
+	{
+		std::ofstream file{TEST_INI_EXTRACTOR_FILE_PATH, std::ios::out | std::ios::trunc};
+
+		file << "; comment before any group\n";
+		file << "[" GROUP1_NAME "]\n";
+		file << "key1 = value1\n";
+		file << "key2 = value2\n";
+		file << "\n";
+		file << "  [" GROUP2_NAME "] ; inline comment\n";
+		file << "key1 = value1\n";
+		file << "[" GROUP1_NAME "]\n";
+		file << "key1 = duplicate\n";
+		file << "key3 = value3\n";
+		file << "[" GROUP3_NAME "]\n";
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_lazy_document = []
+	{
+		#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+		auto  workaround_result_document = LazyDocument<char>::from_file(TEST_INI_EXTRACTOR_FILE_PATH);
+		auto& result                     = workaround_result_document.first;
+		auto& document                   = workaround_result_document.second;
+		#else
+		auto [result, document] = LazyDocument<char>::from_file(TEST_INI_EXTRACTOR_FILE_PATH);
+		#endif
+
+		"read_ok"_test = [&] { expect((result == ExtractResult::SUCCESS) >> fatal); };
+
+		"scan"_test = [&]
+		{
+			expect((document.size() == 3_i) >> fatal);
+			expect((document.names()[0] == GROUP1_NAME) >> fatal);
+			expect((document.names()[1] == GROUP2_NAME) >> fatal);
+			expect((document.names()[2] == GROUP3_NAME) >> fatal);
+
+			expect((document.ranges(GROUP1_NAME).size() == 2_i) >> fatal);
+			expect((document.ranges(GROUP2_NAME).size() == 1_i) >> fatal);
+			expect(document.ranges("not_exists").empty() >> fatal);
+
+			expect(!document.materialized(GROUP1_NAME) >> fatal);
+			expect(!document.materialized(GROUP2_NAME) >> fatal);
+			expect(!document.materialized(GROUP3_NAME) >> fatal);
+		};
+
+		"materialize_once"_test = [&]
+		{
+			std::vector<const LazyDocument<char>::Group*> groups(4, nullptr);
+			{
+				std::vector<std::thread> threads{};
+				for (std::size_t i = 0; i < groups.size(); ++i) { threads.emplace_back([&document, &groups, i] { groups[i] = document.group(GROUP1_NAME); }); }
+				for (auto& thread: threads) { thread.join(); }
+			}
+
+			for (const auto* group: groups) { expect((group == groups.front()) >> fatal); }
+
+			expect(document.materialized(GROUP1_NAME) >> fatal);
+			expect(!document.materialized(GROUP2_NAME) >> fatal);
+
+			const auto& group = *groups.front();
+			expect((group.name() == GROUP1_NAME) >> fatal);
+			expect((group.size() == 3_i) >> fatal);
+			// the first declaration wins
+			expect((group.find("key1")->second == "value1") >> fatal);
+			expect((group.find("key2")->second == "value2") >> fatal);
+			expect((group.find("key3")->second == "value3") >> fatal);
+			expect((group.find("key4") == group.end()) >> fatal);
+		};
+
+		"other_groups"_test = [&]
+		{
+			const auto* group2 = document.group(GROUP2_NAME);
+			expect((group2 != nullptr) >> fatal);
+			expect((group2->size() == 1_i) >> fatal);
+			expect((group2->find("key1")->second == "value1") >> fatal);
+
+			const auto* group3 = document.group(GROUP3_NAME);
+			expect((group3 != nullptr) >> fatal);
+			expect(group3->empty() >> fatal);
+
+			expect((document.group("not_exists") == nullptr) >> fatal);
+		};
+
+		"views_survive_move"_test = [&]
+		{
+			const auto moved  = std::move(document);
+			const auto* group = moved.group(GROUP1_NAME);
+			expect((group->find("key2")->second == "value2") >> fatal);
+		};
+	};
+}// namespace
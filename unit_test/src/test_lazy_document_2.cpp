@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <array>
+#include <boost/ut.hpp>
+#include <ini/lazy_document.hpp>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	using document_type = LazyDocument<char>;
+
+	// The incrementally edited document must be the same as a document constructed from the edited source.
+	[[nodiscard]] auto same_document(const document_type& document, const document_type& expected) -> bool
+	{
+		if (document.source() != expected.source()) { return false; }
+		if (!std::ranges::equal(document.names(), expected.names())) { return false; }
+
+		for (const auto name: expected.names())
+		{
+			const auto ranges          = document.ranges(name);
+			const auto expected_ranges = expected.ranges(name);
+			if (!std::ranges::equal(ranges, expected_ranges, [](const auto& lhs, const auto& rhs) { return lhs.begin == rhs.begin && lhs.end == rhs.end; })) { return false; }
+
+			if (document.raw_hash(name) != expected.raw_hash(name)) { return false; }
+
+			const auto* group          = document.group(name);
+			const auto* expected_group = expected.group(name);
+			if (group->name() != name || !std::ranges::equal(*group, *expected_group)) { return false; }
+			// the views must refer to the (new) source
+			for (const auto& [key, value]: *group)
+			{
+				if (key.data() < document.source().data() || key.data() + key.size() > document.source().data() + document.source().size()) { return false; }
+			}
+		}
+
+		return true;
+	}
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_lazy_document_edit = []
+	{
+		"keep_untouched_groups"_test = []
+		{
+			document_type document{
+					"[" GROUP1_NAME "]\n"
+					"key1 = value1\n"
+					"[" GROUP2_NAME "]\n"
+					"key1 = value1\n"};
+
+			expect((document.group(GROUP1_NAME)->find("key1")->second == "value1") >> fatal);
+			expect((document.group(GROUP2_NAME)->find("key1")->second == "value1") >> fatal);
+
+			const std::string_view        source{document.source()};
+			const auto                    offset = source.rfind("value1");
+			const document_type::text_edit edit{.begin = offset, .end = offset + 6, .replacement = "changed value"};
+			expect(document.apply_edits({&edit, 1}) >> fatal);
+
+			// the edited group is extracted again on next access
+			expect(document.materialized(GROUP1_NAME) >> fatal);
+			expect(!document.materialized(GROUP2_NAME) >> fatal);
+
+			expect((document.group(GROUP1_NAME)->find("key1")->second == "value1") >> fatal);
+			expect((document.group(GROUP2_NAME)->find("key1")->second == "changed value") >> fatal);
+		};
+
+		"add_and_remove_groups"_test = []
+		{
+			document_type document{
+					"[" GROUP1_NAME "]\n"
+					"key1 = value1\n"};
+
+			const std::array edits{
+					// the header is not a header anymore
+					document_type::text_edit{.begin = 0, .end = 1, .replacement = ";"},
+					document_type::text_edit{.begin = document.source().size(), .end = document.source().size(), .replacement = "[" GROUP2_NAME "]\nkey2 = value2\n"}};
+			expect(document.apply_edits(edits) >> fatal);
+
+			expect((document.size() == 1_i) >> fatal);
+			expect(!document.contains(GROUP1_NAME) >> fatal);
+			expect((document.group(GROUP2_NAME)->find("key2")->second == "value2") >> fatal);
+		};
+
+		"invalid_edits"_test = []
+		{
+			document_type document{"[" GROUP1_NAME "]\n"};
+
+			const std::array overlapping{
+					document_type::text_edit{.begin = 0, .end = 3, .replacement = ""},
+					document_type::text_edit{.begin = 2, .end = 4, .replacement = ""}};
+			expect(!document.apply_edits(overlapping) >> fatal);
+
+			const document_type::text_edit out_of_range{.begin = 0, .end = 100, .replacement = ""};
+			expect(!document.apply_edits({&out_of_range, 1}) >> fatal);
+
+			expect((document.source() == "[" GROUP1_NAME "]\n") >> fatal);
+		};
+
+		"randomized_differential"_test = []
+		{
+			constexpr std::array<std::string_view, 12> lines{
+					"[" GROUP1_NAME "]\n",
+					"[" GROUP2_NAME "]\n",
+					"  [group3] ; comment\n",
+					"[malformed\n",
+					"key1 = value1\n",
+					"key2 = value2\n",
+					"key1 = duplicate\n",
+					"; comment\n",
+					"\n",
+					"[",
+					"]",
+					"key3 = value3"};
+
+			std::mt19937 random{20241018};
+
+			const auto random_text = [&](const std::size_t max_lines) -> std::string
+			{
+				std::string text{};
+				const auto  count = std::uniform_int_distribution<std::size_t>{0, max_lines}(random);
+				for (std::size_t i = 0; i < count; ++i) { text.append(lines[std::uniform_int_distribution<std::size_t>{0, lines.size() - 1}(random)]); }
+				return text;
+			};
+
+			for (std::size_t round = 0; round < 200; ++round)
+			{
+				document_type document{random_text(20)};
+
+				for (std::size_t step = 0; step < 10; ++step)
+				{
+					// extract some of the groups, they must be updated (or kept) correctly
+					for (const auto name: document.names())
+					{
+						if (random() % 2 == 0) { (void)document.group(name); }
+					}
+
+					const auto size = document.source().size();
+
+					std::vector<std::size_t> offsets{};
+					const auto               edit_count = std::uniform_int_distribution<std::size_t>{1, 3}(random);
+					for (std::size_t i = 0; i < edit_count * 2; ++i) { offsets.push_back(std::uniform_int_distribution<std::size_t>{0, size}(random)); }
+					std::ranges::sort(offsets);
+
+					std::vector<std::string>              replacements{};
+					std::vector<document_type::text_edit> edits{};
+					for (std::size_t i = 0; i < edit_count; ++i) { replacements.push_back(random_text(2)); }
+					for (std::size_t i = 0; i < edit_count; ++i) { edits.push_back({.begin = offsets[i * 2], .end = offsets[i * 2 + 1], .replacement = replacements[i]}); }
+					std::string expected_source{document.source()};
+					for (const auto& edit: edits | std::views::reverse) { expected_source.replace(edit.begin, edit.end - edit.begin, edit.replacement); }
+
+					// the order of the edits does not matter (except for insertions at the same offset)
+					if (std::ranges::adjacent_find(edits, {}, &document_type::text_edit::begin) == edits.end()) { std::ranges::shuffle(edits, random); }
+
+					expect(document.apply_edits(edits) >> fatal);
+
+					const document_type expected{std::move(expected_source)};
+					expect(same_document(document, expected) >> fatal);
+				}
+			}
+		};
+	};
+}// namespace
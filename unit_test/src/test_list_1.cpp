@@ -0,0 +1,66 @@
+#include <array>
+#include <boost/ut.hpp>
+#include <ini/list.hpp>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_list = []
+	{
+		"span"_test = []
+		{
+			constexpr std::string_view value{" 80, 443 ,8080,\t22 "};
+			expect((list_size(value) == 4_i) >> fatal);
+
+			std::array<int, 4> ports{};
+			expect((split_list<int>(value, ports) == list_result{.result = ListResult::SUCCESS, .size = 4}) >> fatal);
+			expect((ports == std::array{80, 443, 8080, 22}) >> fatal);
+
+			std::array<int, 2> small{};
+			expect((split_list<int>(value, small) == list_result{.result = ListResult::OUTPUT_TOO_SMALL, .size = 2}) >> fatal);
+
+			// the third element
+			expect((split_list<int>(std::string_view{"1,2,x,4"}, ports) == list_result{.result = ListResult::INVALID_ELEMENT, .size = 2}) >> fatal);
+			expect((split_list<int>(std::string_view{"1,,3"}, ports) == list_result{.result = ListResult::INVALID_ELEMENT, .size = 1}) >> fatal);
+
+			expect((list_size(std::string_view{"  "}) == 0_i) >> fatal);
+		};
+
+		"vector"_test = []
+		{
+			// longer than a SIMD block, delimiters at every position of a block
+			std::string value{};
+			for (int i = 0; i < 100; ++i)
+			{
+				if (i != 0) { value.append(i % 3 == 0 ? " | " : "|"); }
+				value.append(std::to_string(i * 7));
+			}
+
+			std::array<std::byte, 4096>         buffer{};
+			std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size()};
+			std::pmr::vector<long>              numbers{&resource};
+			expect((split_list<long>(std::string_view{value}, numbers, '|') == list_result{.result = ListResult::SUCCESS, .size = 100}) >> fatal);
+			for (int i = 0; i < 100; ++i) { expect((numbers[static_cast<std::size_t>(i)] == i * 7) >> fatal); }
+
+			std::vector<std::string_view> views{};
+			expect((split_list<std::string_view>(std::string_view{value}, views, '|').size == 100_i) >> fatal);
+			expect((views[3] == "21") >> fatal);
+
+			std::vector<double> floats{};
+			expect((split_list<double>(std::u16string_view{u"0.5;1e3; 2"}, floats, u';').size == 3_i) >> fatal);
+			expect((floats == std::vector{0.5, 1000.0, 2.0}) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,60 @@
+#include <boost/ut.hpp>
+#include <ini/multi_value_document.hpp>
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "upstream"
+#define GROUP2_NAME "other"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	using document_type = MultiValueDocument<char>;
+
+	[[nodiscard]] auto to_vector(const std::span<const std::string> values) -> std::vector<std::string> { return {values.begin(), values.end()}; }
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_multi_value_document = []
+	{
+		document_type document{};
+		expect((document.extract_from_buffer(
+				        "[" GROUP1_NAME "]\n"
+				        "server = a\n"
+				        "server = b\n"
+				        "weight = 1\n"
+				        "server = c\n"
+				        "path[] = /x\n"
+				        "path[] = /y\n"
+				        "[" GROUP2_NAME "]\n"
+				        "server = d\n"
+				        "[" GROUP1_NAME "]\n"
+				        "server = e\n") == ExtractResult::SUCCESS) >> fatal);
+
+		"repeated"_test = [&]
+		{
+			// in the order they appear, even across the (re)declarations of the group
+			expect((to_vector(document.get(GROUP1_NAME, "server")) == std::vector<std::string>{"a", "b", "c", "e"}) >> fatal);
+			expect((to_vector(document.get(GROUP1_NAME, "weight")) == std::vector<std::string>{"1"}) >> fatal);
+			expect((to_vector(document.get(GROUP2_NAME, "server")) == std::vector<std::string>{"d"}) >> fatal);
+		};
+
+		"array"_test = [&]
+		{
+			expect((to_vector(document.get(GROUP1_NAME, "path")) == std::vector<std::string>{"/x", "/y"}) >> fatal);
+			expect((to_vector(document.get(GROUP1_NAME, "path[]")) == std::vector<std::string>{"/x", "/y"}) >> fatal);
+		};
+
+		"not_exists"_test = [&]
+		{
+			expect(document.get(GROUP1_NAME, "not_exists").empty() >> fatal);
+			expect(document.get("not_exists", "server").empty() >> fatal);
+		};
+	};
+}// namespace
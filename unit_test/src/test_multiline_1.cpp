@@ -0,0 +1,134 @@
+#include <boost/ut.hpp>
+#include <ini/extractor.hpp>
+#include <ini/lazy_document.hpp>
+#include <ini/multiline.hpp>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		[[nodiscard]] auto operator()(const std::string& string) const noexcept -> std::size_t { return std::hash<std::string>{}(string); }
+
+		[[nodiscard]] auto operator()(const std::string_view& string) const noexcept -> std::size_t { return std::hash<std::string_view>{}(string); }
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_multiline = []
+	{
+		constexpr std::string_view source{
+				"[" GROUP1_NAME "]\n"
+				"backslash = abc\\\n"
+				"    def\\\n"
+				"\tghi\n"
+				"indented = -----BEGIN-----\n"
+				"    MIIBIjANBgkq\n"
+				"    hkiG9w0BAQEF==\n"
+				"    -----END-----\n"
+				"single = value\n"
+				"    key=not_a_continuation\n"
+				"last = value\n"};
+
+		"extract"_test = [&]
+		{
+			const auto [result, context] = extract_from_buffer<context_type>(source);
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+
+			const auto& group = context.at(GROUP1_NAME);
+			expect((MultilineValue<char>{group.at("backslash")}.join() == "abcdefghi") >> fatal);
+			expect((MultilineValue<char>{group.at("indented")}.join() == "-----BEGIN-----\nMIIBIjANBgkq\nhkiG9w0BAQEF==\n-----END-----") >> fatal);
+			expect((group.at("single") == "value") >> fatal);
+			// an indented key-value pair
+			expect((group.at("key") == "not_a_continuation") >> fatal);
+			expect((group.at("last") == "value") >> fatal);
+		};
+
+		"zero_copy"_test = [&]
+		{
+			const LazyDocument<char> document{std::string{source}};
+
+			const auto* group = document.group(GROUP1_NAME);
+			expect((group != nullptr) >> fatal);
+
+			const MultilineValue<char> value{group->find("indented")->second};
+			expect(value.is_multiline() >> fatal);
+			expect((value.segments().size() == 4_i) >> fatal);
+			expect((value.size() == value.join().size()) >> fatal);
+
+			// the segments refer to the source
+			const auto first = value.segments().front().text;
+			expect((first == "-----BEGIN-----") >> fatal);
+			expect((first.data() >= document.source().data() && first.data() < document.source().data() + document.source().size()) >> fatal);
+
+			expect(!MultilineValue<char>{group->find("single")->second}.is_multiline() >> fatal);
+		};
+
+		"indented_group"_test = []
+		{
+			// an indented group head is a group head, not a continuation of the value above it
+			constexpr std::string_view indented_source{
+					"[" GROUP1_NAME "]\n"
+					"key = value\n"
+					"  [group2]\n"
+					"key = value2\n"};
+
+			const auto [result, context] = extract_from_buffer<context_type>(indented_source);
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+			expect((context.size() == 2_i) >> fatal);
+			expect((context.at(GROUP1_NAME).at("key") == "value") >> fatal);
+			expect((context.at("group2").at("key") == "value2") >> fatal);
+
+			// the same as the lazy document (common::scan_groups)
+			const LazyDocument<char> document{std::string{indented_source}};
+			expect((document.group(GROUP1_NAME)->find("key")->second == "value") >> fatal);
+			expect((document.group("group2")->find("key")->second == "value2") >> fatal);
+		};
+
+		"trailing_backslash"_test = []
+		{
+			// a trailing backslash does not swallow a group head or a key-value pair
+			constexpr std::string_view backslash_source{
+					"[" GROUP1_NAME "]\n"
+					"dir = C:\\tmp\\\n"
+					"key = value\n"
+					"path = D:\\\n"
+					"[group2]\n"
+					"key = value2\n"};
+
+			const auto [result, context] = extract_from_buffer<context_type>(backslash_source);
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+			expect((context.size() == 2_i) >> fatal);
+			expect((context.at(GROUP1_NAME).at("dir") == "C:\\tmp\\") >> fatal);
+			expect((context.at(GROUP1_NAME).at("key") == "value") >> fatal);
+			expect((context.at(GROUP1_NAME).at("path") == "D:\\") >> fatal);
+			expect((context.at("group2").at("key") == "value2") >> fatal);
+
+			// the same as the lazy document (common::scan_groups)
+			const LazyDocument<char> document{std::string{backslash_source}};
+			expect((document.group(GROUP1_NAME)->find("path")->second == "D:\\") >> fatal);
+			expect((document.group("group2")->find("key")->second == "value2") >> fatal);
+		};
+
+		"crlf"_test = []
+		{
+			const MultilineValue<char> value{"abc\\\r\n  def\r\n  ghi"};
+			expect((value.join() == "abcdef\nghi") >> fatal);
+		};
+	};
+}// namespace
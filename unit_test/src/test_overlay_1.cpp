@@ -0,0 +1,104 @@
+#include <boost/ut.hpp>
+#include <ini/overlay.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+#define GROUP2_NAME "group2"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_overlay = []
+	{
+		context_type defaults{
+				{GROUP1_NAME, {{"key1", "default1"}, {"key2", "default2"}, {"key3", "default3"}}},
+				{GROUP2_NAME, {{"key1", "default1"}}}};
+		const context_type file{
+				{GROUP1_NAME, {{"key1", "file1"}, {"key2", "file2"}}},
+				{GROUP2_NAME, {}}};
+		const context_type overrides{
+				{GROUP1_NAME, {{"key1", "override1"}}}};
+
+		Overlay<context_type> overlay{};
+		expect((overlay.push(defaults) == 0_i) >> fatal);
+		expect((overlay.push(file) == 1_i) >> fatal);
+		expect((overlay.push(overrides) == 2_i) >> fatal);
+
+		"find"_test = [&]
+		{
+			expect((overlay.find(GROUP1_NAME, "key1") == "override1") >> fatal);
+			expect((overlay.find(GROUP1_NAME, "key2") == "file2") >> fatal);
+			expect((overlay.find(GROUP1_NAME, "key3") == "default3") >> fatal);
+			expect((overlay.find(GROUP2_NAME, "key1") == "default1") >> fatal);
+			expect(!overlay.find(GROUP2_NAME, "key2").has_value() >> fatal);
+
+			expect((overlay.layer_of(GROUP1_NAME, "key2") == std::size_t{1}) >> fatal);
+			expect(!overlay.contains("not_exists", "key1") >> fatal);
+		};
+
+		"merged_view"_test = [&]
+		{
+			std::map<std::pair<std::string, std::string>, std::pair<std::string, std::size_t>> merged{};
+			for (const auto& [group, key, value, layer]: overlay)
+			{
+				// each key once
+				expect(merged.emplace(std::pair{std::string{group}, std::string{key}}, std::pair{std::string{value}, layer}).second >> fatal);
+			}
+
+			expect((merged.size() == 4_i) >> fatal);
+			expect((merged.at({GROUP1_NAME, "key1"}) == std::pair{std::string{"override1"}, std::size_t{2}}) >> fatal);
+			expect((merged.at({GROUP1_NAME, "key2"}) == std::pair{std::string{"file2"}, std::size_t{1}}) >> fatal);
+			expect((merged.at({GROUP1_NAME, "key3"}) == std::pair{std::string{"default3"}, std::size_t{0}}) >> fatal);
+			expect((merged.at({GROUP2_NAME, "key1"}) == std::pair{std::string{"default1"}, std::size_t{0}}) >> fatal);
+		};
+
+		"refresh"_test = [&]
+		{
+			defaults[GROUP2_NAME]["key2"] = "default2";
+			overlay.refresh(0);
+
+			expect((overlay.find(GROUP2_NAME, "key2") == "default2") >> fatal);
+		};
+
+		"empty"_test = []
+		{
+			const Overlay<context_type> empty{};
+			expect((empty.begin() == empty.end()) >> fatal);
+			expect(!empty.find(GROUP1_NAME, "key1").has_value() >> fatal);
+
+			// default-constructed iterators are end iterators
+			expect((Overlay<context_type>::const_iterator{} == Overlay<context_type>::const_iterator{}) >> fatal);
+			expect((Overlay<context_type>::const_iterator{} == empty.end()) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,176 @@
+#include <boost/ut.hpp>
+#include <filesystem>
+#include <fstream>
+#include <ini/extractor.hpp>
+#include <ini/patch.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define TEST_INI_PATCH_JOURNAL_PATH TEST_INI_PATCH_FILE_PATH ".journal"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	constexpr std::string_view source =
+			"; head comment\n"
+			"[group1]\n"
+			"key1 = value1 ; inline comment\n"
+			"key2 = value2\n"
+			"; comment of key3\n"
+			"key3 = value3\n"
+			"[group2]\n"
+			"key1 = value1\n"
+			"[group3]\n"
+			"key1 =\n";
+
+	auto write_file(const std::string_view content) -> void
+	{
+		std::ofstream file{TEST_INI_PATCH_FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+		file << content;
+	}
+
+	[[nodiscard]] auto read_file() -> std::string
+	{
+		std::ifstream      file{TEST_INI_PATCH_FILE_PATH, std::ios::in | std::ios::binary};
+		std::ostringstream content{};
+		content << file.rdbuf();
+		return content.str();
+	}
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_patch = []
+	{
+		"in_place"_test = []
+		{
+			write_file(source);
+
+			context_type data{};
+			expect((extract_from_file(TEST_INI_PATCH_FILE_PATH, data) == ExtractResult::SUCCESS) >> fatal);
+
+			data["group1"]["key1"] = "VALUE1";
+
+			// only the value, the size does not change
+			const auto edits = make_patch(source, data);
+			expect((edits.size() == 1_i) >> fatal);
+			expect((source.substr(edits[0].begin, edits[0].end - edits[0].begin) == "value1") >> fatal);
+			expect((edits[0].replacement == "VALUE1") >> fatal);
+
+			expect((patch_file(TEST_INI_PATCH_FILE_PATH, data) == FlushResult::SUCCESS) >> fatal);
+
+			std::string expected{source};
+			expected.replace(source.find("value1"), 6, "VALUE1");
+			expect((read_file() == expected) >> fatal);
+			expect(!std::filesystem::exists(TEST_INI_PATCH_JOURNAL_PATH) >> fatal);
+
+			// nothing changed
+			expect(make_patch(std::string_view{expected}, data).empty() >> fatal);
+		};
+
+		"resize"_test = []
+		{
+			write_file(source);
+
+			context_type data{};
+			expect((extract_from_file(TEST_INI_PATCH_FILE_PATH, data) == ExtractResult::SUCCESS) >> fatal);
+
+			data["group1"].erase("key3");
+			data["group1"]["key4"] = "value4";
+			data.erase("group2");
+			data["group3"]["key1"] = "value1";
+			data["group4"]["key1"] = "value1";
+
+			expect((patch_file(TEST_INI_PATCH_FILE_PATH, data) == FlushResult::SUCCESS) >> fatal);
+
+			const std::string newline{line_separator<std::string_view>};
+			const auto        expected =
+					"; head comment\n"
+					"[group1]\n"
+					"key1 = value1 ; inline comment\n"
+					"key2 = value2\n"
+					"key4 = value4" + newline +
+					"[group3]\n"
+					"key1 = value1\n"
+					"[group4]" + newline +
+					"key1 = value1" + newline;
+			expect((read_file() == expected) >> fatal);
+			expect(!std::filesystem::exists(TEST_INI_PATCH_JOURNAL_PATH) >> fatal);
+
+			// the patched file is extracted the same
+			context_type patched{};
+			expect((extract_from_file(TEST_INI_PATCH_FILE_PATH, patched) == ExtractResult::SUCCESS) >> fatal);
+			expect((patched == data) >> fatal);
+		};
+
+		"recover"_test = []
+		{
+			write_file(source);
+
+			// an incomplete journal, the file has not been touched
+			{
+				std::ofstream journal{TEST_INI_PATCH_JOURNAL_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+				journal << "incomplete";
+			}
+
+			expect((recover_patch(TEST_INI_PATCH_FILE_PATH) == FlushResult::SUCCESS) >> fatal);
+			expect(!std::filesystem::exists(TEST_INI_PATCH_JOURNAL_PATH) >> fatal);
+			expect((read_file() == source) >> fatal);
+		};
+
+		"rollback"_test = []
+		{
+			// the file was patched (and resized), but the journal is still there
+			const auto  offset = source.find("value1");
+			std::string patched{source};
+			patched.replace(offset, 6, "a longer value1");
+			write_file(patched);
+
+			// see the layout of the journal (patch.cpp)
+			{
+				const std::string_view original = source.substr(offset);
+
+				std::string payload{};
+				const std::uint64_t record[]{offset, original.size()};
+				payload.append(reinterpret_cast<const char*>(record), sizeof(record));
+				payload.append(original);
+
+				const std::uint64_t header[]{0x4c4e'524a'494e'4947, source.size(), 1, common::hash_bytes(payload.data(), payload.size())};
+
+				std::ofstream journal{TEST_INI_PATCH_JOURNAL_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+				journal.write(reinterpret_cast<const char*>(header), sizeof(header));
+				journal << payload;
+			}
+
+			expect((recover_patch(TEST_INI_PATCH_FILE_PATH) == FlushResult::SUCCESS) >> fatal);
+			expect(!std::filesystem::exists(TEST_INI_PATCH_JOURNAL_PATH) >> fatal);
+			expect((read_file() == source) >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,151 @@
+#include <boost/ut.hpp>
+#include <ini/schema.hpp>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "server"
+#define GROUP2_NAME "client"
+#define GROUP3_NAME "not_declared"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		[[nodiscard]] auto operator()(const std::string& string) const noexcept -> std::size_t { return std::hash<std::string>{}(string); }
+
+		[[nodiscard]] auto operator()(const std::string_view& string) const noexcept -> std::size_t { return std::hash<std::string_view>{}(string); }
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	using schema_type = Schema<char>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_schema = []
+	{
+		schema_type schema{};
+		schema.group(GROUP1_NAME, true)
+				.define(GROUP1_NAME, "port", {.type = SchemaType::INTEGER, .required = true, .min = 1, .max = 65535})
+				.define(GROUP1_NAME, "ratio", {.type = SchemaType::FLOAT, .max = 1})
+				.define(GROUP1_NAME, "mode", {.required = true, .allowed = {"fast", "safe"}})
+				.define(GROUP2_NAME, "enabled", {.type = SchemaType::BOOLEAN})
+				.define(GROUP2_NAME, "name", {.required = true});
+
+		"validate"_test = [&]
+		{
+			expect(!schema.validate(GROUP1_NAME, "port", "8080").has_value() >> fatal);
+			expect((schema.validate(GROUP1_NAME, "port", "80a") == SchemaViolation::TYPE_MISMATCH) >> fatal);
+			expect((schema.validate(GROUP1_NAME, "port", "0") == SchemaViolation::OUT_OF_RANGE) >> fatal);
+			expect((schema.validate(GROUP1_NAME, "ratio", "1.5") == SchemaViolation::OUT_OF_RANGE) >> fatal);
+			expect((schema.validate(GROUP1_NAME, "mode", "slow") == SchemaViolation::NOT_ALLOWED) >> fatal);
+			// closed group
+			expect((schema.validate(GROUP1_NAME, "unknown", "value") == SchemaViolation::UNKNOWN_KEY) >> fatal);
+			// open group
+			expect(!schema.validate(GROUP2_NAME, "unknown", "value").has_value() >> fatal);
+			expect((schema.validate(GROUP2_NAME, "enabled", "maybe") == SchemaViolation::TYPE_MISMATCH) >> fatal);
+			expect(!schema.validate(GROUP3_NAME, "anything", "value").has_value() >> fatal);
+		};
+
+		"integer_precision"_test = []
+		{
+			// beyond 2^53, the bound and the value would be the same double
+			schema_type large{};
+			large.define(GROUP1_NAME, "id", {.type = SchemaType::INTEGER, .max = std::int64_t{9'007'199'254'740'993}});
+
+			expect(!large.validate(GROUP1_NAME, "id", "9007199254740993").has_value() >> fatal);
+			expect((large.validate(GROUP1_NAME, "id", "9007199254740994") == SchemaViolation::OUT_OF_RANGE) >> fatal);
+		};
+
+		"float_nan"_test = []
+		{
+			// NaN is not within any bound (every comparison with it is false)
+			schema_type nan{};
+			nan
+					.define(GROUP1_NAME, "ratio", {.type = SchemaType::FLOAT, .min = 0, .max = 1})
+					.define(GROUP1_NAME, "low", {.type = SchemaType::FLOAT, .min = 0})
+					.define(GROUP1_NAME, "any", {.type = SchemaType::FLOAT});
+
+			expect(!nan.validate(GROUP1_NAME, "ratio", "0.5").has_value() >> fatal);
+			expect((nan.validate(GROUP1_NAME, "ratio", "nan") == SchemaViolation::OUT_OF_RANGE) >> fatal);
+			expect((nan.validate(GROUP1_NAME, "low", "nan") == SchemaViolation::OUT_OF_RANGE) >> fatal);
+			expect(!nan.validate(GROUP1_NAME, "any", "nan").has_value() >> fatal);
+		};
+
+		"allowed_and_type"_test = []
+		{
+			// an allowed value must still be of the type (and within the range)
+			schema_type allowed{};
+			allowed.define(GROUP1_NAME, "level", {.type = SchemaType::INTEGER, .max = 5, .allowed = {"1", "3", "abc", "7"}});
+
+			expect(!allowed.validate(GROUP1_NAME, "level", "3").has_value() >> fatal);
+			expect((allowed.validate(GROUP1_NAME, "level", "2") == SchemaViolation::NOT_ALLOWED) >> fatal);
+			expect((allowed.validate(GROUP1_NAME, "level", "abc") == SchemaViolation::TYPE_MISMATCH) >> fatal);
+			expect((allowed.validate(GROUP1_NAME, "level", "7") == SchemaViolation::OUT_OF_RANGE) >> fatal);
+		};
+
+		"accepted"_test = [&]
+		{
+			context_type             context{};
+			schema_result_type<char> violations{};
+
+			const auto result = extract_from_buffer<context_type>(
+					"[" GROUP1_NAME "]\n"
+					"port = 8080\n"
+					"mode = safe\n"
+					"[" GROUP2_NAME "]\n"
+					"enabled = on\n"
+					"name = client\n"
+					"[" GROUP3_NAME "]\n"
+					"anything = value\n",
+					context,
+					schema,
+					violations);
+
+			expect((result == ExtractResult::SUCCESS) >> fatal);
+			expect(violations.empty() >> fatal);
+			expect((context.size() == 3_i) >> fatal);
+			expect((context[GROUP1_NAME]["port"] == "8080") >> fatal);
+		};
+
+		"rejected"_test = [&]
+		{
+			context_type             context{};
+			schema_result_type<char> violations{};
+
+			const auto result = extract_from_buffer<context_type>(
+					"[" GROUP1_NAME "]\n"
+					"port = 70000\n"
+					"ratio = 0.5\n"
+					"extra = 1\n"
+					"[" GROUP2_NAME "]\n"
+					"enabled = yes\n",
+					context,
+					schema,
+					violations);
+
+			expect((result == ExtractResult::INVALID_DATA) >> fatal);
+			expect((violations.size() == 4_i) >> fatal);
+			expect((violations[0] == schema_violation<char>{.kind = SchemaViolation::OUT_OF_RANGE, .group = GROUP1_NAME, .key = "port", .value = "70000"}) >> fatal);
+			expect((violations[1] == schema_violation<char>{.kind = SchemaViolation::UNKNOWN_KEY, .group = GROUP1_NAME, .key = "extra", .value = "1"}) >> fatal);
+			// port exists (even if it is rejected), mode and name do not
+			expect((violations[2].kind == SchemaViolation::MISSING) >> fatal);
+			expect((violations[3].kind == SchemaViolation::MISSING) >> fatal);
+
+			// the rejected values are never stored
+			expect((context[GROUP1_NAME].size() == 1_i) >> fatal);
+			expect((context[GROUP1_NAME]["ratio"] == "0.5") >> fatal);
+			expect((context[GROUP2_NAME]["enabled"] == "yes") >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,156 @@
+#include <boost/ut.hpp>
+#include <fstream>
+#include <ini/session.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<string_view_t<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+				return 0;
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	constexpr std::string_view source =
+			"; head comment\n"
+			"[group1] ; inline comment of group1\n"
+			"key1 = value1 ; inline comment of key1\n"
+			"; comment of key2\n"
+			"key2 = value2\n"
+			"\n"
+			"[group2]\n"
+			"key1 = value1\n";
+
+	auto write_file(const std::string_view content) -> void
+	{
+		std::ofstream file{TEST_INI_SESSION_FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc};
+		file << content;
+	}
+
+	[[nodiscard]] auto read_file() -> std::string
+	{
+		std::ifstream      file{TEST_INI_SESSION_FILE_PATH, std::ios::in | std::ios::binary};
+		std::ostringstream content{};
+		content << file.rdbuf();
+		return content.str();
+	}
+
+	// What flush_to_file would write.
+	[[nodiscard]] auto expected_of(const std::string_view content, context_type& data) -> std::string
+	{
+		std::string out{};
+		expect((flush_to_buffer(content, data, out) == FlushResult::SUCCESS) >> fatal);
+		return out;
+	}
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_session = []
+	{
+		"extract_modify_flush"_test = []
+		{
+			write_file(source);
+
+			context_type data{};
+			auto [extract_result, session] = extract_session(TEST_INI_SESSION_FILE_PATH, data);
+			expect((extract_result == ExtractResult::SUCCESS) >> fatal);
+			expect((session.source() == source) >> fatal);
+			expect((data.size() == 2_i) >> fatal);
+
+			data["group1"]["key1"] = "VALUE1";
+			data["group1"]["key3"] = "value3";
+			data.erase("group2");
+			data["group3"]["key1"] = "value1";
+
+			const auto expected = expected_of(source, data);
+			expect((session.flush(data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect((read_file() == expected) >> fatal);
+			expect((session.source() == expected) >> fatal);
+
+			// again, from the data just written
+			data["group1"]["key2"] = "VALUE2";
+
+			const auto expected_again = expected_of(expected, data);
+			expect((session.flush(data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect((read_file() == expected_again) >> fatal);
+		};
+
+		"skeleton_of_written"_test = []
+		{
+			write_file(source);
+
+			context_type data{};
+			auto [extract_result, session] = extract_session(TEST_INI_SESSION_FILE_PATH, data);
+			expect((extract_result == ExtractResult::SUCCESS) >> fatal);
+
+			data["group1"]["key1"] = "VALUE1";
+			data["group3"]["key1"] = "value1";
+
+			// recorded while written, just like the parser sees the data written
+			expect((session.flush(data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			skeleton_type scanned{};
+			patch_detail::scan(session.source(), scanned);
+			expect((!session.skeleton().empty()) >> fatal);
+			expect((session.skeleton() == scanned) >> fatal);
+
+			// a value with a blank is not read back as it is written, it is scanned on the next flush
+			data["group1"]["key2"] = "value 2";
+			expect((session.flush(data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect((session.skeleton().empty()) >> fatal);
+
+			data["group1"]["key2"] = "value2";
+
+			const auto expected = expected_of(session.source(), data);
+			expect((session.flush(data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect((read_file() == expected) >> fatal);
+		};
+
+		"modified_after_extract"_test = []
+		{
+			write_file(source);
+
+			context_type data{};
+			auto [extract_result, session] = extract_session(TEST_INI_SESSION_FILE_PATH, data);
+			expect((extract_result == ExtractResult::SUCCESS) >> fatal);
+
+			// someone else writes the file, the session must not replay the old source
+			constexpr std::string_view modified =
+					"[group2]\n"
+					"; comment of key1\n"
+					"key1 = value1\n"
+					"[group1]\n"
+					"key2 = value2\n";
+			write_file(modified);
+
+			data["group1"]["key1"] = "VALUE1";
+
+			const auto expected = expected_of(modified, data);
+			expect((session.flush(data, FlushDurability::NONE) == FlushResult::SUCCESS) >> fatal);
+			expect((read_file() == expected) >> fatal);
+		};
+	};
+}// namespace
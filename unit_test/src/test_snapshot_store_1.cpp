@@ -0,0 +1,166 @@
+#include <atomic>
+#include <boost/ut.hpp>
+#include <fstream>
+#include <ini/snapshot_store.hpp>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	// A snapshot that knows whether it has been destroyed.
+	struct checked_snapshot
+	{
+		constexpr static std::uint64_t alive_magic = 0x1234'5678'9abc'def0;
+
+		static std::atomic<std::size_t> destroyed;
+
+		std::uint64_t magic{alive_magic};
+		std::size_t   version;
+
+		explicit checked_snapshot(const std::size_t v) noexcept
+			: version{v} {}
+
+		checked_snapshot(const checked_snapshot&) = delete;
+		checked_snapshot(checked_snapshot&&) = delete;
+		auto operator=(const checked_snapshot&) -> checked_snapshot& = delete;
+		auto operator=(checked_snapshot&&) -> checked_snapshot& = delete;
+
+		~checked_snapshot() noexcept
+		{
+			magic = 0;
+			destroyed.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	std::atomic<std::size_t> checked_snapshot::destroyed{0};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_snapshot_store = []
+	{
+		"read_publish_reclaim"_test = []
+		{
+			SnapshotStore<checked_snapshot> store{std::make_unique<const checked_snapshot>(0), 2};
+
+			auto reader1 = store.reader();
+			auto reader2 = store.reader();
+			auto reader3 = store.reader();
+
+			expect(static_cast<bool>(reader1) >> fatal);
+			expect(static_cast<bool>(reader2) >> fatal);
+			// no slot left
+			expect(!static_cast<bool>(reader3) >> fatal);
+
+			{
+				const auto guard = reader1.read();
+				expect((guard->version == 0_i) >> fatal);
+
+				store.publish(std::make_unique<const checked_snapshot>(1));
+
+				// the guard still sees the old snapshot, it cannot be reclaimed yet
+				expect((guard->magic == checked_snapshot::alive_magic) >> fatal);
+				expect((guard->version == 0_i) >> fatal);
+				expect((store.pending_reclaims() == 1_i) >> fatal);
+
+				expect((reader2.read()->version == 1_i) >> fatal);
+			}
+
+			store.reclaim();
+			expect((store.pending_reclaims() == 0_i) >> fatal);
+			expect((checked_snapshot::destroyed.load() == 1_i) >> fatal);
+
+			// the slot is released with the reader
+			reader1 = {};
+			reader3 = store.reader();
+			expect(static_cast<bool>(reader3) >> fatal);
+		};
+
+		"concurrent_readers"_test = []
+		{
+			constexpr std::size_t reader_count = 8;
+			constexpr std::size_t version_count = 1000;
+
+			SnapshotStore<checked_snapshot> store{std::make_unique<const checked_snapshot>(0), reader_count};
+
+			std::atomic<bool>        stop{false};
+			std::atomic<std::size_t> bad_reads{0};
+
+			std::vector<std::thread> readers{};
+			for (std::size_t i = 0; i < reader_count; ++i)
+			{
+				readers.emplace_back(
+						[&]
+						{
+							const auto reader       = store.reader();
+							std::size_t last_version = 0;
+							while (!stop.load(std::memory_order_relaxed))
+							{
+								const auto guard = reader.read();
+								// never a reclaimed snapshot, never an older snapshot
+								if (guard->magic != checked_snapshot::alive_magic || guard->version < last_version) { bad_reads.fetch_add(1, std::memory_order_relaxed); }
+								last_version = guard->version;
+							}
+						});
+			}
+
+			for (std::size_t version = 1; version <= version_count; ++version) { store.publish(std::make_unique<const checked_snapshot>(version)); }
+
+			stop.store(true, std::memory_order_relaxed);
+			for (auto& reader: readers) { reader.join(); }
+
+			expect((bad_reads.load() == 0_i) >> fatal);
+
+			store.reclaim();
+			expect((store.pending_reclaims() == 0_i) >> fatal);
+		};
+
+		"publish_from_file"_test = []
+		{
+			{
+				std::ofstream file{TEST_INI_EXTRACTOR_FILE_PATH, std::ios::out | std::ios::trunc};
+				file << "[" GROUP1_NAME "]\n";
+				file << "key1 = value1\n";
+			}
+
+			SnapshotStore<context_type> store{std::make_unique<const context_type>()};
+
+			expect((store.publish_from_file(TEST_INI_EXTRACTOR_FILE_PATH) == ExtractResult::SUCCESS) >> fatal);
+			expect((store.publish_from_file(TEST_INI_EXTRACTOR_FILE_PATH ".not_exists") == ExtractResult::FILE_NOT_FOUND) >> fatal);
+
+			const auto reader = store.reader();
+			const auto guard  = reader.read();
+			expect((guard->at(GROUP1_NAME).at("key1") == "value1") >> fatal);
+		};
+	};
+}// namespace
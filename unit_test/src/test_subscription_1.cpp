@@ -0,0 +1,110 @@
+#include <boost/ut.hpp>
+#include <functional>
+#include <ini/subscription.hpp>
+#include <string>
+#include <vector>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "server.http"
+#define GROUP2_NAME "server.ftp"
+#define GROUP3_NAME "client"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	using registry_type = SubscriptionRegistry<char>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_subscription = []
+	{
+		const LazyDocument<char> old_document{
+				"[" GROUP1_NAME "]\n"
+				"port = 80\n"
+				"host = localhost\n"
+				"[" GROUP2_NAME "]\n"
+				"port = 21\n"
+				"[" GROUP3_NAME "]\n"
+				"timeout = 10\n"};
+
+		const LazyDocument<char> new_document{
+				"[" GROUP1_NAME "]\n"
+				"port = 8080\n"
+				"host = localhost\n"
+				"[" GROUP3_NAME "]\n"
+				"timeout = 10\n"};
+
+		"match"_test = [&]
+		{
+			registry_type registry{};
+
+			std::vector<std::size_t> port_calls{};
+			std::vector<std::size_t> host_calls{};
+			std::vector<std::size_t> ftp_calls{};
+			std::vector<std::size_t> prefix_calls{};
+			std::vector<std::size_t> client_calls{};
+
+			const auto record = [](std::vector<std::size_t>& calls) -> registry_type::callback_type
+			{
+				return [&calls](const std::span<const registry_type::entry_type> entries) { calls.push_back(entries.size()); };
+			};
+
+			(void)registry.subscribe(GROUP1_NAME, "port", record(port_calls));
+			(void)registry.subscribe(GROUP1_NAME, "host", record(host_calls));
+			(void)registry.subscribe(GROUP2_NAME, "port", record(ftp_calls));
+			(void)registry.subscribe_prefix("server.", record(prefix_calls));
+			(void)registry.subscribe(GROUP3_NAME, record(client_calls));
+
+			// GROUP1.port changed + GROUP2 removed
+			expect((registry.update(old_document, new_document) == 3_i) >> fatal);
+
+			expect((port_calls == std::vector<std::size_t>{1}) >> fatal);
+			expect(host_calls.empty() >> fatal);
+			// the group of the key has been removed
+			expect((ftp_calls == std::vector<std::size_t>{1}) >> fatal);
+			// both changes in one batch
+			expect((prefix_calls == std::vector<std::size_t>{2}) >> fatal);
+			expect(client_calls.empty() >> fatal);
+		};
+
+		"unsubscribe"_test = [&]
+		{
+			registry_type registry{};
+
+			std::size_t calls = 0;
+			const auto  id    = registry.subscribe_prefix("server", [&calls](const auto) { calls += 1; });
+			expect((registry.size() == 1_i) >> fatal);
+
+			expect(registry.unsubscribe(id) >> fatal);
+			expect(!registry.unsubscribe(id) >> fatal);
+			expect((registry.size() == 0_i) >> fatal);
+
+			expect((registry.update(old_document, new_document) == 0_i) >> fatal);
+			expect((calls == 0_i) >> fatal);
+		};
+
+		"executor"_test = [&]
+		{
+			registry_type registry{};
+
+			std::vector<registry_type::entry_type> changes{};
+			(void)registry.subscribe(GROUP1_NAME, [&changes](const std::span<const registry_type::entry_type> entries) { changes.assign(entries.begin(), entries.end()); });
+
+			// deferred
+			std::vector<std::function<void()>> queue{};
+			expect((registry.update(old_document, new_document, [&queue](auto&& task) { queue.emplace_back(std::forward<decltype(task)>(task)); }) == 1_i) >> fatal);
+
+			expect(changes.empty() >> fatal);
+			expect((queue.size() == 1_i) >> fatal);
+			queue.front()();
+
+			expect((changes.size() == 1_i) >> fatal);
+			expect((changes.front() == registry_type::entry_type{.kind = DiffKind::VALUE_CHANGED, .group = GROUP1_NAME, .key = "port", .old_value = "80", .new_value = "8080"}) >> fatal);
+		};
+	};
+}// namespace
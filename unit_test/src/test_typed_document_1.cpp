@@ -0,0 +1,63 @@
+#include <boost/ut.hpp>
+#include <ini/typed_document.hpp>
+#include <string_view>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "tuning"
+#define GROUP2_NAME "strings"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	using document_type = TypedDocument<char>;
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_typed_document = []
+	{
+		document_type document{};
+		expect((document.extract_from_buffer(
+				        "[" GROUP1_NAME "]\n"
+				        "threads = 16\n"
+				        "offset = -3\n"
+				        "ratio = 0.75\n"
+				        "enabled = true\n"
+				        "[" GROUP2_NAME "]\n"
+				        "name = worker\n"
+				        "version = 1.2.3\n"
+				        "flag = maybe\n") == ExtractResult::SUCCESS) >> fatal);
+
+		"classify"_test = [&]
+		{
+			expect((document.find(GROUP1_NAME, "threads")->kind() == ValueKind::INTEGER) >> fatal);
+			expect((document.find(GROUP1_NAME, "ratio")->kind() == ValueKind::FLOAT) >> fatal);
+			expect((document.find(GROUP1_NAME, "enabled")->kind() == ValueKind::BOOLEAN) >> fatal);
+			// not a number, although it begins with a digit
+			expect((document.find(GROUP2_NAME, "version")->kind() == ValueKind::STRING) >> fatal);
+			expect((document.find(GROUP2_NAME, "flag")->kind() == ValueKind::STRING) >> fatal);
+			expect((document.find(GROUP2_NAME, "not_exists") == nullptr) >> fatal);
+		};
+
+		"get"_test = [&]
+		{
+			expect((document.get<int>(GROUP1_NAME, "threads") == 16) >> fatal);
+			expect((document.get<long long>(GROUP1_NAME, "offset") == -3) >> fatal);
+			// out of range
+			expect(!document.get<unsigned>(GROUP1_NAME, "offset").has_value() >> fatal);
+			// promoted
+			expect((document.get<double>(GROUP1_NAME, "threads") == 16.0) >> fatal);
+			expect((document.get<double>(GROUP1_NAME, "ratio") == 0.75) >> fatal);
+			expect((document.get<bool>(GROUP1_NAME, "enabled") == true) >> fatal);
+			expect(!document.get<int>(GROUP1_NAME, "enabled").has_value() >> fatal);
+
+			expect((document.get<std::string_view>(GROUP2_NAME, "name") == std::string_view{"worker"}) >> fatal);
+			expect((document.get<std::string_view>(GROUP2_NAME, "version") == std::string_view{"1.2.3"}) >> fatal);
+			expect(!document.get<std::string_view>(GROUP1_NAME, "threads").has_value() >> fatal);
+		};
+	};
+}// namespace
@@ -0,0 +1,121 @@
+#include <boost/ut.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <ini/watcher.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace boost::ut;
+using namespace gal::ini;
+
+#define GROUP1_NAME "group1"
+
+#if defined(GAL_INI_COMPILER_APPLE_CLANG) || defined(GAL_INI_COMPILER_CLANG_CL) || defined(GAL_INI_COMPILER_CLANG)
+	#define GAL_INI_NO_DESTROY [[clang::no_destroy]]
+#else
+#define GAL_INI_NO_DESTROY
+#endif
+
+namespace
+{
+	struct string_hasher
+	{
+		using is_transparent = int;
+
+		template<typename String>
+		[[nodiscard]] constexpr auto operator()(const String& string) const noexcept -> std::size_t
+		{
+			if constexpr (std::is_array_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<std::decay_t<String>>::element_type>>{}(string); }
+			else if constexpr (std::is_pointer_v<String>) { return std::hash<std::basic_string_view<typename std::pointer_traits<String>::element_type>>{}(string); }
+			else if constexpr (requires { std::hash<String>{}; }) { return std::hash<String>{}(string); }
+			else
+			{
+				[]<bool AlwaysFalse = false>() { static_assert(AlwaysFalse, "Unsupported hash type!"); }();
+			}
+		}
+	};
+
+	using group_type = std::unordered_map<std::string, std::string, string_hasher, std::equal_to<>>;
+	using context_type = std::unordered_map<std::string, group_type, string_hasher, std::equal_to<>>;
+
+	auto write_file(const std::filesystem::path& file_path, const std::string_view value) -> void
+	{
+		std::ofstream file{file_path, std::ios::out | std::ios::trunc};
+
+		file << "[" GROUP1_NAME "]\n";
+		file << "key1 = " << value << "\n";
+	}
+
+	// wait until the watcher published a new generation
+	class GenerationWaiter
+	{
+		std::mutex              mutex_;
+		std::condition_variable condition_;
+
+	public:
+		auto notify() -> void
+		{
+			{
+				std::lock_guard lock{mutex_};
+			}
+			condition_.notify_all();
+		}
+
+		[[nodiscard]] auto wait(const Watcher<context_type>& watcher, const std::uint64_t generation) -> bool
+		{
+			std::unique_lock lock{mutex_};
+			return condition_.wait_for(lock, std::chrono::seconds{5}, [&] { return watcher.generation() != generation; });
+		}
+	};
+
+	GAL_INI_NO_DESTROY [[maybe_unused]] suite test_ini_watcher = []
+	{
+		const std::filesystem::path file_path{TEST_INI_WATCHER_FILE_PATH};
+		write_file(file_path, "value1");
+
+		GenerationWaiter      waiter{};
+		Watcher<context_type> watcher{TEST_INI_WATCHER_FILE_PATH, [&waiter](ExtractResult) { waiter.notify(); }};
+
+		const auto first            = watcher.snapshot();
+		const auto first_generation = watcher.generation();
+
+		"initial_snapshot"_test = [&]
+		{
+			// unique across all watchers, never 0
+			expect((first_generation != std::uint64_t{0}) >> fatal);
+			{
+				Watcher<context_type> other{TEST_INI_WATCHER_FILE_PATH};
+				expect((other.generation() != first_generation) >> fatal);
+			}
+			expect((first->at(GROUP1_NAME).at("key1") == "value1") >> fatal);
+		};
+
+		"write_in_place"_test = [&]
+		{
+			write_file(file_path, "value2");
+
+			expect(waiter.wait(watcher, first_generation) >> fatal);
+			expect((watcher.snapshot()->at(GROUP1_NAME).at("key1") == "value2") >> fatal);
+
+			// the old snapshot is still valid
+			expect((first->at(GROUP1_NAME).at("key1") == "value1") >> fatal);
+		};
+
+		"rename_over"_test = [&]
+		{
+			const auto generation = watcher.generation();
+
+			auto temp_path = file_path;
+			temp_path += ".swp";
+
+			write_file(temp_path, "value3");
+			std::filesystem::rename(temp_path, file_path);
+
+			expect(waiter.wait(watcher, generation) >> fatal);
+			expect((watcher.snapshot()->at(GROUP1_NAME).at("key1") == "value3") >> fatal);
+		};
+	};
+}// namespace